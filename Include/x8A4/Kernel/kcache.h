@@ -0,0 +1,59 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kcache.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kcache.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KCACHE_H
+#define X8A4_KCACHE_H
+
+/* Include headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <CommonCrypto/CommonCrypto.h>
+
+/* Defines */
+#define KCACHE_ENV "X8A4_KERNEL_CACHE_DIR"
+#define KCACHE_DIR "/var/root/Library/Caches/x8A4-kernelcache"
+#define KCACHE_MAGIC "x8A4-kernelcache"
+#define KCACHE_VERSION 2
+#define KCACHE_PATH_MAX 0x400
+#define KCACHE_DIGEST_CHUNK 0x1000000
+
+/* Structure Variables */
+/* Contents of the digest stored next to a decompressed kernelcache, the file identity lets a warm run skip hashing */
+struct kcache_digest_info {
+  uint64_t size;
+  uint64_t inode;
+  int64_t mtime_sec;
+  int64_t mtime_nsec;
+  uint8_t sha256[CC_SHA256_DIGEST_LENGTH];
+};
+
+/* Prototypes */
+void kcache_set_dir(const char *dir);
+const char *kcache_dir(void);
+int kcache_path(char *path, size_t len);
+void kcache_digest(const void *data, size_t size, uint8_t *digest);
+int kcache_digest_file(const char *path, uint8_t *digest, size_t *size);
+int kcache_file_info(const char *path, struct kcache_digest_info *info);
+int kcache_read_digest(const char *path, struct kcache_digest_info *info);
+int kcache_write_digest(const char *path, const uint8_t *digest);
+const char *kcache_lookup(void);
+int kcache_store(const void *data, size_t size);
+void kcache_free(void);
+
+/* Cached Variables */
+extern const char *kcache_dir_cached;
+extern char kcache_path_cached[KCACHE_PATH_MAX];
+extern int kcache_valid_cached;
+
+#endif // X8A4_KCACHE_H
@@ -16,26 +16,73 @@
 #define X8A4_KERNEL_H
 
 /* Include headers */
+#include <stdbool.h>
+#include <x8A4/Kernel/kwalk.h>
 #include <x8A4/Services/services.h>
 
+/* Structure Variables */
+struct proc_index_entry {
+  pid_t pid;
+  uint64_t proc;
+};
+
+struct ipc_port_resolution {
+  mach_port_name_t name;
+  uint64_t port;
+  uint64_t kobject;
+};
+
+struct service_object_cache_entry {
+  io_service_t service;
+  uint64_t port;
+  uint64_t port_kobject;
+  uint64_t kobject;
+  uint64_t nvram_dict;
+  uint64_t registry_id;
+};
+
+/* Defines */
+#define SERVICE_OBJECT_CACHE_MAX 0x10
+#define IPC_ENTRY_GEN_MASK 0xFF000000
+#define IPC_TABLE_SLICE_MAX 0x4000
+#define PROC_INDEX_INITIAL 0x200
+#define PROC_LINK_SPAN_MAX 0x200
+#define PROC_WALK_MAX 0x10000
+
 /* External prototypes */
 extern kern_return_t IOConnectCallStructMethod(io_connect_t service, uint32_t external_selector, const void *args1, size_t arg1_size, void *args2, size_t *args2_size);
 
 /* Prototypes */
 uint64_t krw_get_kbase(void);
+int kbase_prefetch(void);
 int tfp0_init(void);
+int physread_init(void);
 int xpf_init(void);
+int xpf_require(void);
+int xpf_require_img4(void);
 const char *get_kernel_path(void);
 #if 0
 const char *get_kernel_path_legacy2(void);
 const char *get_kernel_path_legacy(void);
 #endif
+uint64_t decode_smr_ptr(uint64_t *value);
 int kread_smr(uint64_t addr, uint64_t *value, size_t sz);
 uint64_t unsign_ptr(uint64_t *addr);
+size_t get_procs_for_pids(const pid_t *pids, size_t count, uint64_t *procs);
+uint64_t get_proc_for_pid(pid_t pid);
+void proc_index_flush(void);
 uint64_t get_our_proc(void);
 uint64_t get_our_task(void);
+void ipc_table_invalidate(void);
+size_t resolve_ipc_ports(struct ipc_port_resolution *ports, size_t count, bool kobjects);
 uint64_t get_ipc_port(mach_port_name_t port_name);
+struct service_object_cache_entry *service_object_cache_find(io_service_t service);
+int service_object_resolve_ipc(struct service_object_cache_entry *entry);
+int service_object_resolve_registry(struct service_object_cache_entry *entry);
+struct service_object_cache_entry *service_object_cache_get(io_service_t service);
+void service_object_cache_flush(void);
 uint64_t get_ipc_kobject(io_service_t service);
+int get_ipc_kobjects(const io_service_t *services, size_t count, uint64_t *kobjects);
 int io_generate_apnonce(void);
 int io_clear_apnonce(void);
 
@@ -43,5 +90,14 @@ int io_clear_apnonce(void);
 extern char *kernel_path_cached;
 extern uint64_t our_proc_cached;
 extern uint64_t our_task_cached;
+extern struct proc_index_entry *proc_index_cached;
+extern size_t proc_index_count_cached;
+extern uint64_t ipc_table_cached;
+extern uint64_t kbase_cached;
+extern struct service_object_cache_entry service_object_cache_cached[SERVICE_OBJECT_CACHE_MAX];
+extern size_t service_object_cache_count_cached;
+extern const struct kwalk_path kwalk_itk_space_path;
+extern const struct kwalk_path kwalk_itk_table_path;
+extern const struct kwalk_path kwalk_ipc_kobject_path;
 
 #endif // X8A4_KERNEL_H
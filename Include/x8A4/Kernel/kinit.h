@@ -0,0 +1,56 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kinit.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kinit.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KINIT_H
+#define X8A4_KINIT_H
+
+/* Include headers */
+#include <pthread.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/* Structure Variables */
+/* deps must be done and succeed before a node runs, after only orders a node behind nodes in the same run */
+struct kinit_node {
+  const char *name;
+  int (*run)(void);
+  uint32_t deps;
+  uint32_t after;
+};
+
+struct kinit_state {
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  uint32_t done;
+  uint32_t failed;
+};
+
+struct kinit_task {
+  const struct kinit_node *node;
+  uint32_t bit;
+  uint32_t after;
+  struct kinit_state *state;
+  pthread_t thread;
+  int threaded;
+};
+
+/* Defines */
+#define KINIT_NODES_MAX 0x20
+#define KINIT_NODE(id) (1U << (id))
+
+/* Prototypes */
+uint32_t kinit_closure(const struct kinit_node *nodes, size_t count, uint32_t wanted);
+int kinit_run(const struct kinit_node *nodes, size_t count, uint32_t wanted, uint32_t *done);
+
+#endif // X8A4_KINIT_H
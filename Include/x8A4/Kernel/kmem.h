@@ -0,0 +1,145 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kmem.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KMEM_H
+#define X8A4_KMEM_H
+
+/* Include headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <libkrw_plugin.h>
+
+/* Structure Variables */
+/* Cached lines only live for one public call, x8A4_require flushes them on entry and our writes invalidate them */
+struct kmem_cache_line {
+  uint64_t tag;
+  uint32_t valid;
+  uint8_t data[0x100];
+};
+
+struct kmem_prefetch_field {
+  uint32_t offset;
+  uint32_t len;
+  uint32_t flags;
+};
+
+struct kmem_prefetch_desc {
+  const char *name;
+  uint32_t count;
+  const struct kmem_prefetch_field *fields;
+};
+
+struct kmem_read_req {
+  uint64_t addr;
+  void *buf;
+  size_t len;
+  int ret;
+  const struct kmem_prefetch_desc *prefetch;
+};
+
+struct krw_iovec_s {
+  uint64_t from;
+  void *to;
+  size_t len;
+  int ret;
+};
+
+typedef int (*krw_kreadv_func_t)(struct krw_iovec_s *iov, size_t count);
+
+struct kmem_backend {
+  const char *name;
+  uint32_t flags;
+  krw_kbase_func_t kbase;
+  krw_kread_func_t kread;
+  krw_kwrite_func_t kwrite;
+  krw_physread_func_t physread;
+  krw_kcall_func_t kcall;
+  void (*free)(void);
+  krw_kreadv_func_t kreadv;
+  int (*map)(uint64_t addr, size_t len, const void **out);
+};
+
+struct kmem_batch_range {
+  size_t first;
+  size_t last;
+  int deferred;
+  struct kmem_read_req req;
+};
+
+struct kmem_cache_stats {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t bypasses;
+  uint64_t invalidations;
+};
+
+/* Defines */
+#define KMEM_CACHE_LINE_SIZE 0x100ULL
+#define KMEM_CACHE_LINE_MASK (~(KMEM_CACHE_LINE_SIZE - 1))
+#define KMEM_CACHE_LINE_COUNT 0x400
+#define KMEM_CACHE_FILL_MAX 0x40
+#define KMEM_PAGE_SIZE 0x4000ULL
+#define KMEM_PAGE_MASK (~(KMEM_PAGE_SIZE - 1))
+#define KMEM_BATCH_GAP_MAX 0x80
+#define KMEM_BACKEND_THREAD_SAFE 0x1
+#define KMEM_IMAGE_ENV "X8A4_KMEM_IMAGE"
+#define KMEM_RECORD_ENV "X8A4_KMEM_RECORD"
+#define KMEM_REPLAY_ENV "X8A4_KMEM_REPLAY"
+#define KMEM_PLUGIN_ENV "X8A4_KMEM_PLUGIN"
+#define KMEM_TFP0_STANDIN_ENV "X8A4_KMEM_TFP0_STANDIN"
+#define kmem_read(from, to, len) kmem_read_site(__FUNCTION__, from, to, len)
+#define kmem_read_batch(reqs, count) kmem_read_batch_site(__FUNCTION__, reqs, count)
+#define kmem_write(from, to, len) kmem_write_site(__FUNCTION__, from, to, len)
+
+/* Prototypes */
+int kmem_backend_init(void);
+int kmem_backend_offline(void);
+int kmem_backend_set(const struct kmem_backend *backend);
+const struct kmem_backend *kmem_backend_get(void);
+void kmem_backend_set_image_path(const char *path);
+void kmem_backend_set_record_path(const char *path);
+void kmem_backend_set_replay_path(const char *path);
+void kmem_backend_set_plugin_path(const char *path);
+void kmem_backend_free(void);
+int kmem_kbase(uint64_t *addr);
+int kmem_backend_read(uint64_t from, void *to, size_t len);
+int kmem_backend_readv(struct krw_iovec_s *iov, size_t count);
+int kmem_read_through(uint64_t from, void *to, size_t len);
+int kmem_read_site(const char *site, uint64_t from, void *to, size_t len);
+int kmem_read_batch_site(const char *site, struct kmem_read_req *reqs, size_t count);
+int kmem_write_site(const char *site, void *from, uint64_t to, size_t len);
+int kmem_physread(uint64_t from, void *to, size_t len, uint8_t granule);
+int kmem_map(uint64_t addr, size_t len, const void **out);
+int kmem_kcall(uint64_t func, size_t argc, const uint64_t *argv, uint64_t *ret);
+int kmem_cache_covers(uint64_t addr, size_t len);
+void kmem_cache_store(uint64_t addr, const void *buf, size_t len);
+void kmem_cache_invalidate(uint64_t addr, size_t len);
+void kmem_cache_flush(void);
+void kmem_cache_set_enabled(int enabled);
+void kmem_cache_get_stats(struct kmem_cache_stats *stats);
+void kmem_cache_free(void);
+
+/* Cached Variables */
+extern const struct kmem_backend kmem_libkrw_backend;
+extern const struct kmem_backend *kmem_backend_cached;
+extern const char *kmem_image_path_cached;
+extern const char *kmem_record_path_cached;
+extern const char *kmem_replay_path_cached;
+extern const char *kmem_plugin_path_cached;
+extern int kmem_backend_offline_cached;
+extern struct kmem_cache_line *kmem_cache_lines_cached;
+extern struct kmem_cache_stats kmem_cache_stats_cached;
+extern int kmem_cache_enabled_cached;
+
+#endif // X8A4_KMEM_H
@@ -0,0 +1,53 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_async.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kmem_async.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KMEM_ASYNC_H
+#define X8A4_KMEM_ASYNC_H
+
+/* Include headers */
+#include <pthread.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <x8A4/Kernel/kmem.h>
+
+/* Structure Variables */
+struct kmem_async_group {
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  size_t pending;
+  int failed;
+};
+
+struct kmem_async_work {
+  struct kmem_read_req *req;
+  struct kmem_async_group *group;
+  struct kmem_async_work *next;
+};
+
+/* Defines */
+#define KMEM_ASYNC_WORKERS_MAX 0x10
+#define KMEM_ASYNC_GROUP_INITIALIZER {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0}
+
+/* Prototypes */
+int kmem_async_set_workers(uint32_t workers, int force);
+int kmem_async_enabled(void);
+int kmem_async_submit(struct kmem_async_group *group, struct kmem_read_req *req);
+int kmem_async_wait(struct kmem_async_group *group);
+void kmem_async_free(void);
+
+/* Cached Variables */
+extern uint32_t kmem_async_workers_cached;
+extern int kmem_async_force_cached;
+
+#endif // X8A4_KMEM_ASYNC_H
@@ -0,0 +1,53 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_file.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kmem_file.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KMEM_FILE_H
+#define X8A4_KMEM_FILE_H
+
+/* Include headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <x8A4/Kernel/kmem.h>
+
+/* Structure Variables */
+struct kmem_image_header {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t kbase;
+  uint32_t region_count;
+  uint32_t reserved;
+};
+
+struct kmem_image_region {
+  uint64_t addr;
+  uint64_t size;
+  uint64_t offset;
+};
+
+/* Defines */
+#define KMEM_IMAGE_MAGIC 0x4B4D454DU /* 'KMEM' */
+#define KMEM_IMAGE_VERSION 1
+
+/* Prototypes */
+int kmem_file_backend_open(const char *path);
+int kmem_file_kbase(uint64_t *addr);
+int kmem_file_kread(uint64_t from, void *to, size_t len);
+int kmem_file_kwrite(void *from, uint64_t to, size_t len);
+int kmem_file_map(uint64_t addr, size_t len, const void **out);
+void kmem_file_backend_free(void);
+
+/* Cached Variables */
+extern const struct kmem_backend kmem_file_backend;
+
+#endif // X8A4_KMEM_FILE_H
@@ -0,0 +1,68 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_phys.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kmem_phys.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KMEM_PHYS_H
+#define X8A4_KMEM_PHYS_H
+
+/* Include headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <x8A4/Kernel/kmem.h>
+
+/* Structure Variables */
+struct kmem_phys_tlb_entry {
+  uint64_t va;
+  uint64_t pa;
+  uint64_t tick;
+};
+
+struct kmem_phys_stats {
+  uint64_t tlb_hits;
+  uint64_t tlb_misses;
+  uint64_t walks_failed;
+  uint64_t phys_reads;
+  uint64_t phys_bytes;
+  uint64_t fallbacks;
+};
+
+/* Defines */
+#define KMEM_PHYS_PAGE_SHIFT 14
+#define KMEM_PHYS_LEVEL_BITS 11
+#define KMEM_PHYS_OA_MASK 0x0000FFFFFFFFC000ULL
+#define KMEM_PHYS_TTE_VALID 0x1ULL
+#define KMEM_PHYS_TTE_TABLE 0x2ULL
+#define KMEM_PHYS_TLB_SIZE 0x100
+#define KMEM_PHYS_BULK_MIN 0x200
+#define KMEM_PHYS_CHECK_SIZE 0x20
+
+/* Prototypes */
+void kmem_phys_set_enabled(int enabled);
+int kmem_phys_backend_open(const struct kmem_backend *inner, uint64_t ttep, uint64_t t1sz);
+int kmem_phys_check(uint64_t kbase, uint64_t pa);
+int kmem_phys_translate(uint64_t va, uint64_t *pa);
+void kmem_phys_tlb_flush(void);
+int kmem_phys_kbase(uint64_t *addr);
+int kmem_phys_kread(uint64_t from, void *to, size_t len);
+int kmem_phys_kwrite(void *from, uint64_t to, size_t len);
+int kmem_phys_physread(uint64_t from, void *to, size_t len, uint8_t granule);
+int kmem_phys_kcall(uint64_t func, size_t argc, const uint64_t *argv, uint64_t *ret);
+void kmem_phys_get_stats(struct kmem_phys_stats *stats);
+void kmem_phys_backend_free(void);
+
+/* Cached Variables */
+extern const struct kmem_backend kmem_phys_backend;
+extern int kmem_phys_enabled_cached;
+extern struct kmem_phys_stats kmem_phys_stats_cached;
+
+#endif // X8A4_KMEM_PHYS_H
@@ -0,0 +1,50 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_plugin.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kmem_plugin.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KMEM_PLUGIN_H
+#define X8A4_KMEM_PLUGIN_H
+
+/* Include headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <x8A4/Kernel/kmem.h>
+
+/* Structure Variables */
+/*
+ * Extended handlers, passed to krw_initializer with base.version set to
+ * KMEM_PLUGIN_HANDLERS_VERSION. Plugins that know this version may fill the
+ * fields after base, plugins that do not only touch base.
+ */
+struct kmem_plugin_handlers {
+  struct krw_handlers_s base;
+  uint64_t flags;
+  krw_kreadv_func_t kreadv;
+};
+
+/* Defines */
+#define KMEM_PLUGIN_HANDLERS_VERSION 1
+#define KMEM_PLUGIN_THREAD_SAFE 0x1
+#define KMEM_PLUGIN_DIR "/usr/lib/libkrw"
+#define KMEM_PLUGIN_DIR_ROOTLESS "/var/jb/usr/lib/libkrw"
+
+/* Prototypes */
+int kmem_plugin_backend_open(const char *path);
+void kmem_plugin_backend_free(void);
+
+/* Cached Variables */
+extern struct kmem_backend kmem_plugin_backend;
+extern struct kmem_plugin_handlers kmem_plugin_handlers_cached;
+extern void *kmem_plugin_handle_cached;
+
+#endif // X8A4_KMEM_PLUGIN_H
@@ -0,0 +1,40 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_prefetch.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kmem_prefetch.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KMEM_PREFETCH_H
+#define X8A4_KMEM_PREFETCH_H
+
+/* Include headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <x8A4/Kernel/kmem.h>
+
+/* Defines */
+#define KMEM_PREFETCH_MAX 0x400
+#define KMEM_PREFETCH_LEN_MAX 0x1000
+#define KMEM_PREFETCH_UNSIGN 0x1
+
+/* Prototypes */
+void kmem_prefetch_queue(uint64_t addr, size_t len);
+void kmem_prefetch_struct(const struct kmem_prefetch_desc *desc, const void *buf, size_t len);
+struct kmem_read_req *kmem_prefetch_take(size_t *count);
+void kmem_prefetch_done(void);
+int kmem_prefetch_flush(void);
+void kmem_prefetch_free(void);
+
+/* Cached Variables */
+extern struct kmem_read_req *kmem_prefetch_reqs_cached;
+extern size_t kmem_prefetch_count_cached;
+
+#endif // X8A4_KMEM_PREFETCH_H
@@ -0,0 +1,56 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_static.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kmem_static.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KMEM_STATIC_H
+#define X8A4_KMEM_STATIC_H
+
+/* Include headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <XPF/xpf.h>
+
+/* Structure Variables */
+struct kmem_static_region {
+  PFSection *section;
+  uint64_t start;
+  uint64_t end;
+  uint32_t flags;
+};
+
+struct kmem_static_stats {
+  uint64_t reads;
+  uint64_t bytes;
+  uint64_t pointers;
+  uint64_t fallbacks;
+};
+
+/* Defines */
+#define KMEM_STATIC_REGIONS_MAX 0x10
+#define KMEM_STATIC_RAW 0x1
+#define KMEM_STATIC_POINTERS 0x2
+
+/* Prototypes */
+int kmem_static_init(void);
+int kmem_static_covers(uint64_t addr, size_t len);
+int kmem_static_read(uint64_t addr, void *buf, size_t len);
+int kmem_static_read_pointers(uint64_t addr, uint64_t *out, size_t count);
+void kmem_static_get_stats(struct kmem_static_stats *stats);
+void kmem_static_free(void);
+
+/* Cached Variables */
+extern struct kmem_static_region kmem_static_regions_cached[KMEM_STATIC_REGIONS_MAX];
+extern size_t kmem_static_regions_count_cached;
+extern struct kmem_static_stats kmem_static_stats_cached;
+
+#endif // X8A4_KMEM_STATIC_H
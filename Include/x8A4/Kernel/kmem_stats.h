@@ -0,0 +1,61 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_stats.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kmem_stats.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KMEM_STATS_H
+#define X8A4_KMEM_STATS_H
+
+/* Include headers */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Enum Variables */
+enum kmem_stats_op {
+  KMEM_STATS_READ,
+  KMEM_STATS_WRITE,
+};
+
+/* Defines */
+#define KMEM_STATS_SITE_MAX 0x100
+#define KMEM_STATS_HIST_BUCKETS 32
+
+/* Structure Variables */
+struct kmem_site_stats {
+  const char *site;
+  uint64_t reads;
+  uint64_t read_bytes;
+  uint64_t writes;
+  uint64_t write_bytes;
+  uint64_t backend_reads;
+  uint64_t errors;
+  uint64_t total_ns;
+  uint64_t hist[KMEM_STATS_HIST_BUCKETS];
+};
+
+/* Prototypes */
+void kmem_stats_set_enabled(int enabled);
+struct kmem_site_stats *kmem_stats_site(const char *site);
+uint64_t kmem_stats_begin(const char *site);
+void kmem_stats_end(uint64_t start, enum kmem_stats_op op, size_t len, int ret);
+void kmem_stats_backend_read(void);
+const struct kmem_site_stats *kmem_stats_get(size_t *count);
+void kmem_stats_print(void);
+void kmem_stats_reset(void);
+
+/* Cached Variables */
+extern int kmem_stats_enabled_cached;
+extern struct kmem_site_stats *kmem_stats_sites_cached;
+extern size_t kmem_stats_site_count_cached;
+extern struct kmem_site_stats *kmem_stats_current_cached;
+
+#endif // X8A4_KMEM_STATS_H
@@ -0,0 +1,44 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_string.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kmem_string.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KMEM_STRING_H
+#define X8A4_KMEM_STRING_H
+
+/* Include headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <x8A4/Kernel/kmem.h>
+
+/* Defines */
+#define KMEM_STRING_MAX 0x1000
+#define KMEM_STRING_BUCKETS 0x400
+#define kmem_read_string(addr, max_len) kmem_read_string_site(__FUNCTION__, addr, max_len)
+
+/* Structure Variables */
+struct kmem_string {
+  struct kmem_string *next;
+  uint32_t hash;
+  uint32_t len;
+  char str[];
+};
+
+/* Prototypes */
+const char *kmem_string_intern(const char *str, size_t len);
+const char *kmem_read_string_site(const char *site, uint64_t addr, size_t max_len);
+void kmem_string_free(void);
+
+/* Cached Variables */
+extern struct kmem_string **kmem_string_buckets_cached;
+
+#endif // X8A4_KMEM_STRING_H
@@ -0,0 +1,68 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_tfp0.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kmem_tfp0.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KMEM_TFP0_H
+#define X8A4_KMEM_TFP0_H
+
+/* Include headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <x8A4/Kernel/kmem.h>
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+/* Structure Variables */
+struct kmem_tfp0_ops {
+  const char *name;
+  int (*kbase)(uint64_t *addr);
+  int (*read)(uint64_t from, void *to, size_t len);
+  int (*write)(void *from, uint64_t to, size_t len);
+  int (*remap)(uint64_t addr, size_t len, void **out);
+  void (*unmap)(void *local, size_t len);
+};
+
+struct kmem_tfp0_mapping {
+  uint64_t addr;
+  size_t size;
+  void *local;
+};
+
+/* Defines */
+#define KMEM_TFP0_MAPPING_MAX 0x40
+#define KMEM_TFP0_HOST_SPECIAL_PORT 4
+
+#ifdef __APPLE__
+/* External prototypes */
+extern kern_return_t mach_vm_read_overwrite(vm_map_t target_task, mach_vm_address_t address, mach_vm_size_t size, mach_vm_address_t data, mach_vm_size_t *outsize);
+extern kern_return_t mach_vm_write(vm_map_t target_task, mach_vm_address_t address, vm_offset_t data, mach_msg_type_number_t data_count);
+extern kern_return_t mach_vm_remap(vm_map_t target_task, mach_vm_address_t *target_address, mach_vm_size_t size, mach_vm_offset_t mask, int flags, vm_map_t src_task, mach_vm_address_t src_address, boolean_t copy, vm_prot_t *cur_protection, vm_prot_t *max_protection, vm_inherit_t inheritance);
+extern kern_return_t mach_vm_deallocate(vm_map_t target, mach_vm_address_t address, mach_vm_size_t size);
+#endif
+
+/* Prototypes */
+int kmem_tfp0_backend_open(void);
+int kmem_tfp0_backend_open_standin(const char *path);
+int kmem_tfp0_kbase(uint64_t *addr);
+const void *kmem_tfp0_find_mapping(uint64_t addr, size_t len);
+int kmem_tfp0_kread(uint64_t from, void *to, size_t len);
+int kmem_tfp0_kwrite(void *from, uint64_t to, size_t len);
+int kmem_tfp0_map(uint64_t addr, size_t len, const void **out);
+void kmem_tfp0_backend_free(void);
+
+/* Cached Variables */
+extern const struct kmem_backend kmem_tfp0_backend;
+extern const struct kmem_tfp0_ops *kmem_tfp0_ops_cached;
+
+#endif // X8A4_KMEM_TFP0_H
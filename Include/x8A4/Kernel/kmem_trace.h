@@ -0,0 +1,102 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_trace.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kmem_trace.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KMEM_TRACE_H
+#define X8A4_KMEM_TRACE_H
+
+/* Include headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <x8A4/Kernel/kmem.h>
+
+/* Enum Variables */
+enum kmem_trace_op {
+  KMEM_TRACE_READ,
+  KMEM_TRACE_WRITE,
+};
+
+/* Structure Variables */
+struct kmem_trace_header {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t kbase;
+};
+
+struct kmem_trace_record {
+  uint8_t op;
+  uint8_t reserved[3];
+  int32_t ret;
+  uint64_t addr;
+  uint64_t len;
+  uint64_t timestamp;
+};
+
+/* One recorded call, answered once in recording order before the last answer repeats */
+struct kmem_trace_entry {
+  uint64_t addr;
+  uint64_t len;
+  uint64_t timestamp;
+  uint64_t seq;
+  const uint8_t *data;
+  int32_t ret;
+  uint8_t op;
+  uint8_t used;
+};
+
+/* Bytes of one kernel page seen by successful recorded reads, answers reads whose granularity was never recorded */
+struct kmem_trace_page {
+  uint64_t addr;
+  uint8_t valid[0x4000 / 8];
+  uint8_t data[0x4000];
+};
+
+struct kmem_trace_stats {
+  uint64_t reads;
+  uint64_t read_bytes;
+  uint64_t writes;
+  uint64_t write_bytes;
+  uint64_t misses;
+  uint64_t repeats;
+  uint64_t views;
+};
+
+/* Defines */
+#define KMEM_TRACE_MAGIC 0x4B545243U /* 'KTRC' */
+#define KMEM_TRACE_VERSION 1
+#define KMEM_TRACE_CHUNK_SIZE 0x10000
+
+/* Prototypes */
+int kmem_trace_record_open(const char *path, const struct kmem_backend *inner);
+int kmem_trace_record_kbase(uint64_t *addr);
+int kmem_trace_record_kread(uint64_t from, void *to, size_t len);
+int kmem_trace_record_kwrite(void *from, uint64_t to, size_t len);
+void kmem_trace_record_free(void);
+int kmem_trace_entry_compare(const void *a, const void *b);
+struct kmem_trace_entry *kmem_trace_match(enum kmem_trace_op op, uint64_t addr, uint64_t len);
+struct kmem_trace_page *kmem_trace_find_page(uint64_t page_addr, size_t *index);
+int kmem_trace_apply(uint64_t addr, const uint8_t *buf, size_t len);
+int kmem_trace_view_read(uint64_t from, uint8_t *to, size_t len);
+int kmem_trace_replay_open(const char *path);
+int kmem_trace_replay_kbase(uint64_t *addr);
+int kmem_trace_replay_kread(uint64_t from, void *to, size_t len);
+int kmem_trace_replay_kwrite(void *from, uint64_t to, size_t len);
+void kmem_trace_replay_free(void);
+void kmem_trace_get_stats(struct kmem_trace_stats *stats);
+
+/* Cached Variables */
+extern const struct kmem_backend kmem_trace_record_backend;
+extern const struct kmem_backend kmem_trace_replay_backend;
+extern struct kmem_trace_stats kmem_trace_stats_cached;
+
+#endif // X8A4_KMEM_TRACE_H
@@ -0,0 +1,80 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kpager.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kpager.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KPAGER_H
+#define X8A4_KPAGER_H
+
+/* Include headers */
+#include <pthread.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <XPF/xpf.h>
+#include <choma/Fat.h>
+#include <choma/MachO.h>
+#include <choma/MemoryStream.h>
+
+/* Defines */
+#define KPAGER_PAGE_SIZE 0x4000
+#define KPAGER_CAP_DEFAULT 0x400000
+#define KPAGER_CAP_ENV "X8A4_KERNEL_MEMORY_CAP"
+#define KPAGER_KERNEL_ENV "X8A4_KERNEL_DECOMPRESSED"
+
+/* Structure Variables */
+struct kpager_page {
+  uint64_t offset;
+  uint64_t last_use;
+  uint8_t *data;
+};
+
+struct kpager_stats {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+};
+
+/* File backed pages shared by a stream and its soft clones, never holding more than pages_max pages */
+struct kpager {
+  pthread_mutex_t lock;
+  int fd;
+  size_t size;
+  struct kpager_page *pages;
+  size_t pages_count;
+  size_t pages_max;
+  size_t last;
+  uint64_t clock;
+  int refs;
+  struct kpager_stats stats;
+};
+
+/* Prototypes */
+size_t kpager_cap(void);
+struct kpager_page *kpager_page_get(struct kpager *pager, uint64_t offset);
+int kpager_stream_read(MemoryStream *stream, uint64_t offset, size_t size, void *outBuf);
+int kpager_stream_write(MemoryStream *stream, uint64_t offset, size_t size, const void *inBuf);
+int kpager_stream_get_size(MemoryStream *stream, size_t *sizeOut);
+uint8_t *kpager_stream_get_raw_ptr(MemoryStream *stream);
+MemoryStream *kpager_stream_softclone(MemoryStream *stream);
+void kpager_stream_free(MemoryStream *stream);
+MemoryStream *kpager_stream_init(const char *path, size_t cap);
+const char *kpager_kernel_path(void);
+int kpager_fileset_open(const char *path);
+PFSection *kpager_fileset_section(const char *filesetEntryId, const char *segName, const char *sectName);
+void kpager_fileset_close(void);
+
+/* Cached Variables */
+extern Fat *kpager_fileset_fat_cached;
+extern MachO *kpager_fileset_macho_cached;
+extern struct kpager *kpager_fileset_pager_cached;
+
+#endif // X8A4_KPAGER_H
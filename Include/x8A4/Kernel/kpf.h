@@ -18,6 +18,24 @@
 /* Include Headers */
 #include <stdint.h>
 #include <XPF/xpf.h>
+#include <x8A4/Kernel/kpf_scan.h>
+
+/* Defines */
+#define KPF_REGISTRY_ROOT_REFS_MAX 4
+#define KPF_REGISTRY_ROOT_ADRP_MAX 3
+#define KPF_REGISTRY_ROOT_CANDIDATES_MAX 12
+#define KPF_IMG4_TARGET_KRN 0
+#define KPF_IMG4_TARGET_NONCE_DOMAIN 1
+#define KPF_IMG4_TARGETS_COUNT 2
+#define KPF_SCAN_FAILED -1
+#define KPF_SCAN_NOT_FOUND -2
+
+/* Structure Variables */
+struct kpf_img4_sections {
+  PFSection *text;
+  PFSection *data_const;
+  PFSection *cstring;
+};
 
 /* External prototypes */
 extern PFSection *xpf_pfsec_init(const char *filesetEntryId, const char *segName, const char *sectName);
@@ -25,10 +43,20 @@ extern PFSection *xpf_pfsec_init(const char *filesetEntryId, const char *segName
 /* Prototypes */
 int xpf_setup_fileset_sections(void);
 void xpf_free_fileset_sections(void);
+int xpf_setup_img4_sections(void);
+int xpf_scan_img4_targets(void);
+uint64_t xpf_find_nonce_slots_array_scan(void);
 uint64_t xpf_find_nonce_slots_array(void);
+uint64_t xpf_find_nonce_domains_array_scan(void);
 uint64_t xpf_find_nonce_domains_array(void);
+int xpf_find_nonce_slot_format(void);
+int xpf_find_nonce_slots_array_length_scan(void);
 int xpf_find_nonce_slots_array_length(void);
+int xpf_find_nonce_domains_array_length_scan(uint64_t nonce_domains_array_addr);
 int xpf_find_nonce_domains_array_length(uint64_t nonce_domains_array_addr);
+int xpf_find_registry_root_candidates_scan(void);
+int xpf_find_registry_root_candidates(uint64_t *candidates, int max);
+int xpf_find_cryptex_boot_domain_index_scan(uint64_t nonce_domains_array_addr, int nonce_domains_array_length);
 int xpf_find_cryptex_boot_domain_index(uint64_t nonce_domains_array_addr, int nonce_domains_array_length);
 
 /* Extern Variables */
@@ -37,5 +65,10 @@ extern PFSection *apple_image4_fileset_sections[3];
 /* Cached Variables */
 extern uint64_t kpf_nonce_domains_cached;
 extern int kpf_nonce_domains_length_cached;
+extern uint64_t kpf_registry_root_candidates_cached[KPF_REGISTRY_ROOT_CANDIDATES_MAX];
+extern int kpf_registry_root_candidates_count_cached;
+extern struct kpf_img4_sections kpf_img4_sections_cached;
+extern struct kpf_scan_target kpf_img4_targets_cached[KPF_IMG4_TARGETS_COUNT];
+extern int kpf_img4_scan_done_cached;
 
 #endif // X8A4_KPF_H
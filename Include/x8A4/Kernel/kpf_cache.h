@@ -0,0 +1,67 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kpf_cache.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kpf_cache.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KPF_CACHE_H
+#define X8A4_KPF_CACHE_H
+
+/* Include headers */
+#include <pthread.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/* Structure Variables */
+struct kpf_cache_entry {
+  char name[0x40];
+  uint64_t value;
+};
+
+/* Defines */
+#define KPF_CACHE_ENV "X8A4_KPF_CACHE"
+#define KPF_CACHE_PATH "/var/root/Library/Caches/x8A4.kpfcache"
+#define KPF_CACHE_MAGIC "x8A4-kpf-cache"
+#define KPF_CACHE_VERSION 1
+#define KPF_CACHE_ENTRIES_MAX 0x40
+#define KPF_CACHE_LINE_MAX 0x200
+#define KPF_CACHE_NOT_FOUND UINT64_MAX
+#define KPF_CACHE_NONCE_SLOT_FORMAT "nonce_slot_format"
+#define KPF_CACHE_NONCE_SLOTS_ARRAY "nonce_slots_array"
+#define KPF_CACHE_NONCE_SLOTS_ARRAY_LENGTH "nonce_slots_array_length"
+#define KPF_CACHE_NONCE_DOMAINS_ARRAY "nonce_domains_array"
+#define KPF_CACHE_NONCE_DOMAINS_ARRAY_LENGTH "nonce_domains_array_length"
+#define KPF_CACHE_CRYPTEX_BOOT_DOMAIN_INDEX "cryptex_boot_domain_index"
+#define KPF_CACHE_REGISTRY_ROOT_CANDIDATES "registry_root_candidates"
+
+/* Prototypes */
+void kpf_lock(void);
+void kpf_unlock(void);
+void kpf_cache_set_path(const char *path);
+int kpf_cache_load(void);
+void kpf_cache_release_info(void);
+int kpf_cache_save(void);
+int kpf_cache_save_locked(void);
+int kpf_cache_get(const char *name, uint64_t *value);
+void kpf_cache_put(const char *name, uint64_t value);
+uint64_t kpf_cache_item_resolve(const char *name);
+void kpf_cache_free(void);
+
+/* Cached Variables */
+extern const char *kpf_cache_path_cached;
+extern struct kpf_cache_entry kpf_cache_entries_cached[KPF_CACHE_ENTRIES_MAX];
+extern size_t kpf_cache_entries_count_cached;
+extern int kpf_cache_dirty_cached;
+extern int kpf_cache_warm_cached;
+extern pthread_mutex_t kpf_lock_cached;
+extern pthread_once_t kpf_lock_once_cached;
+
+#endif // X8A4_KPF_CACHE_H
@@ -0,0 +1,62 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kpf_scan.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kpf_scan.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KPF_SCAN_H
+#define X8A4_KPF_SCAN_H
+
+/* Include headers */
+#include <pthread.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <XPF/xpf.h>
+
+/* Defines */
+#define KPF_SCAN_TARGETS_MAX 0x10
+#define KPF_SCAN_REFS_MAX 8
+#define KPF_SCAN_THREADS_MAX 8
+#define KPF_SCAN_PARALLEL_MIN 0x100000
+#define KPF_SCAN_CHUNK_OVERLAP 0x400
+
+/* Structure Variables */
+/* A string to find and/or an address to collect code references to, string is NULL for an xref only target */
+struct kpf_scan_target {
+  const char *string;
+  uint64_t vmaddr;
+  uint64_t refs[KPF_SCAN_REFS_MAX];
+  int refs_max;
+  int refs_count;
+};
+
+/* One instruction aligned slice of a text section, scanned with some overlap but keeping only its own sources */
+struct kpf_scan_chunk {
+  PFSection section;
+  uint64_t start;
+  uint64_t end;
+  const struct kpf_scan_target *targets;
+  size_t count;
+  uint64_t refs[KPF_SCAN_TARGETS_MAX][KPF_SCAN_REFS_MAX];
+  int refs_count[KPF_SCAN_TARGETS_MAX];
+  pthread_t thread;
+  int threaded;
+};
+
+/* Prototypes */
+int kpf_scan_strings(PFSection *section, struct kpf_scan_target *targets, size_t count);
+size_t kpf_scan_xrefs_pending(const struct kpf_scan_target *targets, size_t count, const int *found);
+size_t kpf_scan_chunks_count(PFSection *section);
+void *kpf_scan_xrefs_worker(void *arg);
+int kpf_scan_xrefs(PFSection *section, struct kpf_scan_target *targets, size_t count);
+void kpf_scan_reset(struct kpf_scan_target *targets, size_t count);
+
+#endif // X8A4_KPF_SCAN_H
@@ -0,0 +1,70 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kpf_xref.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kpf_xref.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KPF_XREF_H
+#define X8A4_KPF_XREF_H
+
+/* Include headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <XPF/xpf.h>
+#include <x8A4/Kernel/kpf_scan.h>
+
+/* Defines */
+#define KPF_XREF_INDEX_ENV "X8A4_XREF_INDEX"
+#define KPF_XREF_INDEX_PATH "/var/root/Library/Caches/x8A4.xrefs"
+#define KPF_XREF_INDEX_MAGIC "x8A4-xref-index"
+#define KPF_XREF_INDEX_VERSION 1
+#define KPF_XREF_INDEX_SECTION_MAX 0x400000
+#define KPF_XREF_INDEX_PATH_MAX 0x400
+
+/* Structure Variables */
+struct kpf_xref_entry {
+  uint64_t target;
+  uint64_t source;
+  uint32_t type;
+  uint32_t reserved;
+};
+
+struct kpf_xref_index_header {
+  char magic[0x10];
+  uint32_t version;
+  uint32_t entry_size;
+  uint8_t uuid[0x10];
+  uint64_t vmaddr;
+  uint64_t size;
+  uint64_t count;
+};
+
+/* Prototypes */
+void kpf_xref_index_set_path(const char *path);
+int kpf_xref_index_path(char *path, size_t len);
+int kpf_xref_kernel_uuid(uint8_t *uuid);
+int kpf_xref_entry_compare(const void *a, const void *b);
+int kpf_xref_entry_valid(PFSection *section, const struct kpf_xref_entry *entry);
+int kpf_xref_index_load(PFSection *section, const uint8_t *uuid);
+int kpf_xref_index_build(PFSection *section);
+int kpf_xref_index_save(const uint8_t *uuid);
+int kpf_xref_index_init(PFSection *section);
+int kpf_xref_index_refs(uint64_t target, uint32_t types, uint64_t *refs, int max);
+int kpf_xref_index_scan(PFSection *section, struct kpf_scan_target *targets, size_t count);
+void kpf_xref_index_free(void);
+
+/* Cached Variables */
+extern const char *kpf_xref_index_path_cached;
+extern struct kpf_xref_entry *kpf_xref_index_cached;
+extern size_t kpf_xref_index_count_cached;
+extern PFSection *kpf_xref_index_section_cached;
+
+#endif // X8A4_KPF_XREF_H
@@ -0,0 +1,52 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kregistry.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kregistry.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KREGISTRY_H
+#define X8A4_KREGISTRY_H
+
+/* Include headers */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <x8A4/Registry/registry.h>
+
+/* Structure Variables */
+struct kregistry_cache_entry {
+  uint64_t id;
+  uint64_t entry;
+};
+
+/* Defines */
+#define KREGISTRY_CACHE_MAX 0x40
+#define KREGISTRY_DEPTH_MAX 0x20
+#define KREGISTRY_CHILDREN_MAX 0x1000
+
+/* Prototypes */
+void kregistry_set_preferred(bool preferred);
+int kregistry_entry_ids(const uint64_t *entries, size_t count, uint64_t *ids);
+uint64_t kregistry_entry_id(uint64_t entry);
+size_t kregistry_children(uint64_t entry, const char *plane, uint64_t **out);
+uint64_t kregistry_root(void);
+size_t kregistry_id_chain(io_registry_entry_t entry, const char *plane, uint64_t *ids, size_t max);
+uint64_t kregistry_find_service(io_registry_entry_t service);
+void kregistry_cache_flush(void);
+
+/* Cached Variables */
+extern bool kregistry_preferred_cached;
+extern uint64_t kregistry_root_cached;
+extern uint64_t kregistry_root_id_cached;
+extern struct kregistry_cache_entry kregistry_cache_cached[KREGISTRY_CACHE_MAX];
+extern size_t kregistry_cache_count_cached;
+
+#endif // X8A4_KREGISTRY_H
@@ -0,0 +1,75 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kwalk.h
+ * @author Cryptiiiic
+ * @brief This file is the header file for kwalk.c
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef X8A4_KWALK_H
+#define X8A4_KWALK_H
+
+/* Include headers */
+#include <stdint.h>
+#include <stddef.h>
+#include <x8A4/Kernel/offsets.h>
+
+/* Enum Variables */
+enum kwalk_op {
+  KWALK_LOAD,
+  KWALK_ADD,
+  KWALK_INDEX,
+  KWALK_UNSIGN,
+  KWALK_SMR,
+};
+
+/* Structure Variables */
+struct kwalk_step {
+  uint8_t op;
+  uint8_t flags;
+  uint16_t field;
+  uint16_t cond;
+};
+
+struct kwalk_path {
+  const char *name;
+  const struct kwalk_path *parent;
+  uint32_t flags;
+  uint32_t count;
+  const struct kwalk_step *steps;
+};
+
+struct kwalk_cache_entry {
+  const struct kwalk_path *path;
+  uint64_t root;
+  uint64_t param;
+  uint64_t value;
+};
+
+/* Defines */
+#define KWALK_NONE 0xFFFF
+#define KWALK_FIELD(name) ((uint16_t)offsetof(struct kernel_offsets, name))
+#define KWALK_STEP(op, field) {op, 0, field, KWALK_NONE}
+#define KWALK_STEP_IF(op, field, cond) {op, 0, field, cond}
+#define KWALK_STEP_KPTR(op, field) {op, KWALK_STEP_VALIDATE_KPTR, field, KWALK_NONE}
+#define KWALK_STEP_VALIDATE_KPTR 0x1
+#define KWALK_PATH_CACHED 0x1
+#define KWALK_CACHE_MAX 0x100
+
+/* Prototypes */
+int kwalk_resolve(const struct kwalk_path *path, uint64_t root, uint64_t param, uint64_t *out);
+int kwalk_resolve_batch(const struct kwalk_path *path, uint64_t root, const uint64_t *params, size_t count, uint64_t *out);
+int kwalk_resolve_roots(const struct kwalk_path *path, const uint64_t *roots, size_t count, uint64_t *out);
+void kwalk_cache_flush(void);
+
+/* Cached Variables */
+extern struct kwalk_cache_entry kwalk_cache_cached[KWALK_CACHE_MAX];
+extern size_t kwalk_cache_count_cached;
+
+#endif // X8A4_KWALK_H
@@ -16,6 +16,7 @@
 #define X8A4_NVRAM_H
 
 #include <x8A4/Services/services.h>
+#include <x8A4/Kernel/kwalk.h>
 #include <x8A4/Kernel/osobject.h>
 
 /* Enum Variables */
@@ -48,5 +49,6 @@ int set_nvram_entry_bytes(uint64_t nvram_dict, const char *key, uint8_t *entry_b
 /* Cached Variables */
 extern struct nvram_key *nvram_keys_cached;
 extern int nvram_keys_count_cached;
+extern const struct kwalk_path kwalk_nvram_dict_path;
 
 #endif // X8A4_NVRAM_H
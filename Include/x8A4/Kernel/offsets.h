@@ -37,14 +37,20 @@ struct kernel_offsets {
   uint64_t table_smr;
   uint64_t smr;
   uint64_t ipc_entry_object;
+  uint64_t ipc_entry_bits;
   uint64_t ipc_entry_size;
   uint64_t ipc_port_kobject;
   uint64_t ipc_port_kobject_is_iomachport;
   uint64_t iomachport_object;
   uint64_t t1sz_boot;
   uint64_t io_dt_nvram;
+  uint64_t io_registry_reserved;
+  uint64_t io_registry_reserved_id;
+  uint64_t io_registry_table;
   uint64_t os_dict;
   uint64_t os_dict_size;
+  uint64_t os_array;
+  uint64_t os_array_size;
   uint64_t os_string;
   uint64_t os_metabase_size;
   uint64_t os_data;
@@ -17,6 +17,7 @@
 
 /* Include headers */
 #include <stdint.h>
+#include <x8A4/Kernel/kmem.h>
 
 /* Enum Variables */
 enum os_type {
@@ -31,11 +32,17 @@ struct os_dict_entry {
 };
 
 /* Prototypes */
+const struct kmem_prefetch_desc *get_os_dict_entry_prefetch(void);
 uint64_t os_object_cast(uint64_t object, enum os_type type);
 uint32_t get_os_metabase_size(uint64_t object);
 uint64_t get_os_dict_from_os_object(uint64_t os_object);
 uint32_t get_os_dict_size(uint64_t dict);
 uint32_t extract_os_size(uint32_t *size);
+uint64_t get_value_from_os_dict(uint64_t dict, const char *entry_key);
 uint64_t get_entry_from_os_dict(uint64_t dict, enum os_type entry_type, const char *entry_key, uint32_t *out_size);
 
+/* Cached Variables */
+extern struct kmem_prefetch_field os_dict_entry_prefetch_fields_cached[2];
+extern struct kmem_prefetch_desc os_dict_entry_prefetch_cached;
+
 #endif // X8A4_OSOBJECT_H
@@ -20,8 +20,10 @@
 /* Prototypes */
 uint64_t get_slide(void);
 uint64_t palera1n_get_slide(void);
+int palera1n_prefetch_slide(void);
 
 /* Cached Variables */
 extern uint64_t slide_cached;
+extern uint64_t palera1n_slide_cached;
 
 #endif//X8A4_SLIDE_H
@@ -27,6 +27,7 @@ extern const mach_port_t kIOMasterPortDefault;
 typedef mach_port_t io_object_t;
 typedef io_object_t io_registry_entry_t;
 typedef char io_string_t[512];
+typedef char io_name_t[128];
 typedef uint32_t IOOptionBits;
 
 /* External prototypes */
@@ -34,9 +35,13 @@ io_registry_entry_t IORegistryEntryFromPath(mach_port_t, const io_string_t);
 extern CFTypeRef IORegistryEntryCreateCFProperty(io_registry_entry_t, CFStringRef, CFAllocatorRef, IOOptionBits);
 extern kern_return_t IORegistryEntrySetCFProperty(io_registry_entry_t, CFStringRef, CFTypeRef);
 extern kern_return_t IOObjectRelease(io_object_t kobject);
+extern io_registry_entry_t IORegistryGetRootEntry(mach_port_t main_port);
+extern kern_return_t IORegistryEntryGetParentEntry(io_registry_entry_t entry, const io_name_t plane, io_registry_entry_t *parent);
+extern kern_return_t IORegistryEntryGetRegistryEntryID(io_registry_entry_t entry, uint64_t *entry_id);
 
 /* Defines */
 #define kIODeviceTreePlane "IODeviceTree"
+#define kIOServicePlane "IOService"
 #define IO_OBJECT_NULL ((io_object_t)0)
 #define kIONVRAMDeletePropertyKey "IONVRAM-DELETE-PROPERTY"
 #define kIONVRAMSyncNowPropertyKey "IONVRAM-SYNCNOW-PROPERTY"
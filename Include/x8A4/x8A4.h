@@ -18,7 +18,10 @@
 /* Include headers */
 #include <stdint.h>
 #include <x8A4/Kernel/kernel.h>
+#include <x8A4/Kernel/kinit.h>
 #include <x8A4/Kernel/kpf.h>
+#include <x8A4/Kernel/kmem.h>
+#include <x8A4/Kernel/kmem_stats.h>
 #include <x8A4/Kernel/offsets.h>
 #include <x8A4/Kernel/slide.h>
 #include <x8A4/Kernel/osobject.h>
@@ -105,11 +108,34 @@ struct x8A4_nonce_seeds_slot {
 /* Defines */
 #define X8A4_API_VERSION "1.0.1"
 #define X8A4_ABI_VERSION SOVERSION
+#define X8A4_CAP_REGISTRY 0x1
+#define X8A4_CAP_KERNEL_INFO 0x2
+#define X8A4_CAP_KREAD 0x4
+#define X8A4_CAP_OFFSETS 0x8
+#define X8A4_CAP_PATCHFINDER 0x10
+#define X8A4_CAP_ALL (X8A4_CAP_REGISTRY | X8A4_CAP_KERNEL_INFO | X8A4_CAP_KREAD | X8A4_CAP_OFFSETS | X8A4_CAP_PATCHFINDER)
+#define X8A4_INIT_REGISTRY 0
+#define X8A4_INIT_KERNEL_INFO 1
+#define X8A4_INIT_BACKEND 2
+#define X8A4_INIT_PALEINFO 3
+#define X8A4_INIT_SLIDE 4
+#define X8A4_INIT_OFFSETS 5
+#define X8A4_INIT_PATCHFINDER 6
+#define X8A4_INIT_STATIC 7
+#define X8A4_INIT_PHYSREAD 8
+#define X8A4_INIT_NODES_COUNT 9
 
 /* Prototypes */
 __attribute__((used)) void x8A4_constructor(void);
 __attribute__((used)) void x8A4_destructor(void);
 int x8A4_init(void);
+int x8A4_require(uint32_t caps);
+int x8A4_init_registry(void);
+int x8A4_init_backend(void);
+int x8A4_init_slide(void);
+int x8A4_init_patchfinder(void);
+int x8A4_init_static(void);
+int x8A4_init_physread(void);
 void x8A4_free(void);
 const char *x8A4_version(void);
 uint8_t *x8A4_get_nonce_slots_os_dict(uint32_t *seeds_size, int slot_index);
@@ -139,8 +165,19 @@ uint8_t *x8A4_get_apnonce(uint32_t *apnonce_size);
 uint8_t *x8A4_set_apnonce_generator(uint8_t *generator, uint32_t *generator_size);
 int x8A4_clear_apnonce_generator(void);
 struct x8A4_accel_key *x8A4_get_ioaesaccelkeys(uint32_t *keys_count);
+const struct kmem_site_stats *x8A4_get_kmem_stats(size_t *count);
 void x8A4(void);
 void x8A4_cli_set_verbose(void);
+void x8A4_cli_disable_kmem_cache(void);
+void x8A4_cli_enable_kmem_stats(void);
+void x8A4_cli_print_kmem_stats(void);
+void x8A4_cli_set_kmem_threads(uint32_t threads);
+void x8A4_cli_set_kmem_image(const char *path);
+void x8A4_cli_set_kmem_record(const char *path);
+void x8A4_cli_set_kmem_replay(const char *path);
+void x8A4_cli_enable_kmem_physread(void);
+void x8A4_cli_set_kmem_plugin(const char *path);
+void x8A4_cli_enable_kobject_registry(void);
 void x8A4_cli_get_cryptex_seed(void);
 void x8A4_cli_get_cryptex_nonce(void);
 void x8A4_cli_get_apnonce_generator(void);
@@ -153,6 +190,9 @@ void x8A4_cli_set_cryptex_seed(const char *new_seed);
 
 /* Cached Variables */
 extern int init_done;
+extern uint32_t x8A4_caps_cached;
+extern uint32_t x8A4_init_nodes_cached;
+extern const struct kinit_node x8A4_init_nodes[X8A4_INIT_NODES_COUNT];
 extern struct x8A4_nonce_domain *domains_cached;
 extern struct x8A4_nonce_slot *slots_cached;
 extern int nonce_slot_format_cached;
@@ -0,0 +1,299 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kcache.c
+ * @author Cryptiiiic
+ * @brief This file is for keeping the decompressed kernelcache on disk between runs.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <x8A4/Kernel/kcache.h>
+#include <x8A4/Kernel/kernel.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+const char *kcache_dir_cached = NULL;
+char kcache_path_cached[KCACHE_PATH_MAX] = {0};
+int kcache_valid_cached = 0;
+
+/* Functions */
+/**
+ * @brief           Set the decompressed kernelcache directory, an empty path disables it
+ * @param[in]       dir
+ */
+void kcache_set_dir(const char *dir) {
+  kcache_dir_cached = dir;
+}
+
+/**
+ * @brief           Get the decompressed kernelcache directory from its setter, its environment variable or the default
+ * @return          Directory, NULL if disabled
+ */
+const char *kcache_dir(void) {
+  const char *dir = kcache_dir_cached;
+  if (!dir) {
+    dir = getenv(KCACHE_ENV);
+  }
+  if (!dir) {
+    dir = KCACHE_DIR;
+  }
+  return dir[0] ? dir : NULL;
+}
+
+/**
+ * @brief           Get the decompressed kernelcache path, keyed by the boot-manifest-hash directory of the booted kernel
+ * @param[out]      path
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kcache_path(char *path, size_t len) {
+  const char *dir = kcache_dir();
+  const char *kernel_path = get_kernel_path();
+  const char *preboot_path = "/private/preboot/";
+  if (!dir || !kernel_path || strncmp(kernel_path, preboot_path, strlen(preboot_path))) {
+    return -1;
+  }
+  const char *hash = kernel_path + strlen(preboot_path);
+  const char *hash_end = strchr(hash, '/');
+  if (!hash_end || hash_end == hash) {
+    return -1;
+  }
+  int ret = snprintf(path, len, "%s/%.*s.kernelcache", dir, (int)(hash_end - hash), hash);
+  return ret > 0 && (size_t)ret < len ? 0 : -1;
+}
+
+/**
+ * @brief           SHA-256 of a buffer larger than a CC_LONG
+ * @param[in]       data
+ * @param[in]       size
+ * @param[out]      digest
+ */
+void kcache_digest(const void *data, size_t size, uint8_t *digest) {
+  CC_SHA256_CTX ctx;
+  CC_SHA256_Init(&ctx);
+  for (size_t off = 0; off < size; off += KCACHE_DIGEST_CHUNK) {
+    size_t len = size - off < KCACHE_DIGEST_CHUNK ? size - off : KCACHE_DIGEST_CHUNK;
+    CC_SHA256_Update(&ctx, (const uint8_t *)data + off, (CC_LONG)len);
+  }
+  CC_SHA256_Final(digest, &ctx);
+}
+
+/**
+ * @brief           SHA-256 of a file, read through a read only mapping
+ * @param[in]       path
+ * @param[out]      digest
+ * @param[out]      size
+ * @return          Zero on success
+ */
+int kcache_digest_file(const char *path, uint8_t *digest, size_t *size) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return -1;
+  }
+  struct stat st = {0};
+  if (fstat(fd, &st) || !st.st_size) {
+    close(fd);
+    return -1;
+  }
+  void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    x8A4_log_debug("Failed to mmap %s (%d:%s)\n", path, errno, strerror(errno));
+    return -1;
+  }
+  kcache_digest(data, (size_t)st.st_size, digest);
+  munmap(data, (size_t)st.st_size);
+  *size = (size_t)st.st_size;
+  return 0;
+}
+
+/**
+ * @brief           Get the size and identity of a file
+ * @param[in]       path
+ * @param[out]      info
+ * @return          Zero on success
+ */
+int kcache_file_info(const char *path, struct kcache_digest_info *info) {
+  struct stat st = {0};
+  if (stat(path, &st) || !st.st_size) {
+    return -1;
+  }
+  info->size = (uint64_t)st.st_size;
+  info->inode = (uint64_t)st.st_ino;
+  info->mtime_sec = (int64_t)st.st_mtimespec.tv_sec;
+  info->mtime_nsec = (int64_t)st.st_mtimespec.tv_nsec;
+  return 0;
+}
+
+/**
+ * @brief           Read the digest stored next to a decompressed kernelcache
+ * @param[in]       path
+ * @param[out]      info
+ * @return          Zero on success
+ */
+int kcache_read_digest(const char *path, struct kcache_digest_info *info) {
+  char digest_path[KCACHE_PATH_MAX + 8] = {0};
+  snprintf(digest_path, sizeof(digest_path), "%s.digest", path);
+  FILE *file = fopen(digest_path, "r");
+  if (!file) {
+    return -1;
+  }
+  int version = 0;
+  unsigned long long size = 0;
+  unsigned long long inode = 0;
+  long long mtime_sec = 0;
+  long long mtime_nsec = 0;
+  char hex[CC_SHA256_DIGEST_LENGTH * 2 + 1] = {0};
+  int ret = fscanf(file, KCACHE_MAGIC " %d size %llu inode %llu mtime %lld.%lld sha256 %64s", &version, &size, &inode, &mtime_sec, &mtime_nsec, hex) == 6 &&
+                    version == KCACHE_VERSION && strlen(hex) == CC_SHA256_DIGEST_LENGTH * 2
+                ? 0
+                : -1;
+  fclose(file);
+  for (int i = 0; i < CC_SHA256_DIGEST_LENGTH && !ret; i++) {
+    unsigned int byte = 0;
+    if (sscanf(&hex[i * 2], "%2x", &byte) != 1) {
+      ret = -1;
+    }
+    info->sha256[i] = (uint8_t)byte;
+  }
+  info->size = (uint64_t)size;
+  info->inode = (uint64_t)inode;
+  info->mtime_sec = (int64_t)mtime_sec;
+  info->mtime_nsec = (int64_t)mtime_nsec;
+  return ret;
+}
+
+/**
+ * @brief           Write the digest of a decompressed kernelcache next to it along with its current identity
+ * @param[in]       path
+ * @param[in]       digest
+ * @return          Zero on success
+ */
+int kcache_write_digest(const char *path, const uint8_t *digest) {
+  struct kcache_digest_info info = {0};
+  if (kcache_file_info(path, &info)) {
+    return -1;
+  }
+  char digest_path[KCACHE_PATH_MAX + 8] = {0};
+  char tmp_path[KCACHE_PATH_MAX + 0x10] = {0};
+  snprintf(digest_path, sizeof(digest_path), "%s.digest", path);
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", digest_path);
+  FILE *file = fopen(tmp_path, "w");
+  if (!file) {
+    x8A4_log_debug("Failed to open %s (%d:%s)\n", tmp_path, errno, strerror(errno));
+    return -1;
+  }
+  fprintf(file, KCACHE_MAGIC " %d\nsize %llu\ninode %llu\nmtime %lld.%09lld\nsha256 ", KCACHE_VERSION,
+          (unsigned long long)info.size, (unsigned long long)info.inode, (long long)info.mtime_sec, (long long)info.mtime_nsec);
+  for (int i = 0; i < CC_SHA256_DIGEST_LENGTH; i++) {
+    fprintf(file, "%02x", digest[i]);
+  }
+  fprintf(file, "\n");
+  if (fclose(file) || rename(tmp_path, digest_path)) {
+    x8A4_log_debug("Failed to write kernelcache digest %s (%d:%s)\n", digest_path, errno, strerror(errno));
+    remove(tmp_path);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief           Find a decompressed kernelcache for the booted kernel whose contents match its stored digest. The
+ *                  file is only hashed again when its size, inode or mtime differ from the ones stored with the digest
+ * @return          Path, NULL if there is none or it is damaged
+ */
+const char *kcache_lookup(void) {
+  if (kcache_valid_cached) {
+    return kcache_valid_cached > 0 ? kcache_path_cached : NULL;
+  }
+  kcache_valid_cached = -1;
+  if (kcache_path(kcache_path_cached, sizeof(kcache_path_cached))) {
+    return NULL;
+  }
+  struct kcache_digest_info stored = {0};
+  struct kcache_digest_info current = {0};
+  if (kcache_read_digest(kcache_path_cached, &stored)) {
+    x8A4_log_debug("No decompressed kernelcache at %s\n", kcache_path_cached);
+    return NULL;
+  }
+  int unchanged = !kcache_file_info(kcache_path_cached, &current) && current.size == stored.size && current.inode == stored.inode &&
+                  current.mtime_sec == stored.mtime_sec && current.mtime_nsec == stored.mtime_nsec;
+  if (!unchanged) {
+    uint8_t digest[CC_SHA256_DIGEST_LENGTH] = {0};
+    size_t size = 0;
+    if (kcache_digest_file(kcache_path_cached, digest, &size) || size != stored.size || memcmp(digest, stored.sha256, sizeof(digest))) {
+      x8A4_log_debug("Removing damaged decompressed kernelcache %s\n", kcache_path_cached);
+      char digest_path[KCACHE_PATH_MAX + 8] = {0};
+      snprintf(digest_path, sizeof(digest_path), "%s.digest", kcache_path_cached);
+      remove(digest_path);
+      remove(kcache_path_cached);
+      return NULL;
+    }
+    kcache_write_digest(kcache_path_cached, digest);
+  }
+  kcache_valid_cached = 1;
+  x8A4_log_debug("Using decompressed kernelcache %s\n", kcache_path_cached);
+  return kcache_path_cached;
+}
+
+/**
+ * @brief           Store the decompressed kernelcache with its digest, the digest is written last so a partial store is ignored
+ * @param[in]       data
+ * @param[in]       size
+ * @return          Zero on success
+ */
+int kcache_store(const void *data, size_t size) {
+  char path[KCACHE_PATH_MAX] = {0};
+  if (!data || !size || kcache_path(path, sizeof(path))) {
+    return -1;
+  }
+  if (mkdir(kcache_dir(), 0755) && errno != EEXIST) {
+    x8A4_log_debug("Failed to create %s (%d:%s)\n", kcache_dir(), errno, strerror(errno));
+    return -1;
+  }
+  char tmp_path[KCACHE_PATH_MAX + 8] = {0};
+  char digest_path[KCACHE_PATH_MAX + 8] = {0};
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+  snprintf(digest_path, sizeof(digest_path), "%s.digest", path);
+  remove(digest_path);
+  FILE *file = fopen(tmp_path, "wb");
+  if (!file) {
+    x8A4_log_debug("Failed to open %s (%d:%s)\n", tmp_path, errno, strerror(errno));
+    return -1;
+  }
+  int ret = fwrite(data, 1, size, file) != size;
+  if (fclose(file) || ret || rename(tmp_path, path)) {
+    x8A4_log_debug("Failed to write decompressed kernelcache %s (%d:%s)\n", path, errno, strerror(errno));
+    remove(tmp_path);
+    return -1;
+  }
+  uint8_t digest[CC_SHA256_DIGEST_LENGTH] = {0};
+  kcache_digest(data, size, digest);
+  if (kcache_write_digest(path, digest)) {
+    return -1;
+  }
+  x8A4_log_debug("Stored decompressed kernelcache %s (0x%zX bytes)\n", path, size);
+  return 0;
+}
+
+/**
+ * @brief           Forget the decompressed kernelcache lookup
+ */
+void kcache_free(void) {
+  memset(kcache_path_cached, 0, sizeof(kcache_path_cached));
+  kcache_valid_cached = 0;
+}
@@ -13,9 +13,15 @@
  */
 
 /* Include headers */
-#include <libkrw.h>
 #include <sys/mount.h>
+#include <x8A4/Kernel/kcache.h>
 #include <x8A4/Kernel/kernel.h>
+#include <x8A4/Kernel/kmem.h>
+#include <x8A4/Kernel/kmem_phys.h>
+#include <x8A4/Kernel/kmem_static.h>
+#include <x8A4/Kernel/kpager.h>
+#include <x8A4/Kernel/kpf_cache.h>
+#include <x8A4/Kernel/kregistry.h>
 #include <x8A4/Kernel/offsets.h>
 #include <x8A4/Kernel/slide.h>
 #include <x8A4/Services/services.h>
@@ -27,34 +33,86 @@
 char *kernel_path_cached = NULL;
 uint64_t our_proc_cached = 0;
 uint64_t our_task_cached = 0;
+struct proc_index_entry *proc_index_cached = NULL;
+size_t proc_index_count_cached = 0;
+size_t proc_index_capacity_cached = 0;
+uint64_t ipc_table_cached = 0;
+uint64_t kbase_cached = 0;
+struct service_object_cache_entry service_object_cache_cached[SERVICE_OBJECT_CACHE_MAX] = {0};
+size_t service_object_cache_count_cached = 0;
+
+/* Structure Variables */
+/* task->itk_space, stable for the life of our task */
+const struct kwalk_step kwalk_itk_space_steps[] = {
+  KWALK_STEP(KWALK_LOAD, KWALK_FIELD(itk_space)),
+  KWALK_STEP_KPTR(KWALK_UNSIGN, KWALK_NONE),
+};
+const struct kwalk_path kwalk_itk_space_path = {"itk_space", NULL, KWALK_PATH_CACHED, 2, kwalk_itk_space_steps};
+
+/* itk_space->is_table, not cached since the table is reallocated as it grows */
+const struct kwalk_step kwalk_itk_table_steps[] = {
+  KWALK_STEP(KWALK_LOAD, KWALK_FIELD(task_itk_space_table)),
+  KWALK_STEP(KWALK_UNSIGN, KWALK_NONE),
+  KWALK_STEP_IF(KWALK_SMR, KWALK_NONE, KWALK_FIELD(table_smr)),
+  KWALK_STEP_KPTR(KWALK_UNSIGN, KWALK_NONE),
+};
+const struct kwalk_path kwalk_itk_table_path = {"itk_table", &kwalk_itk_space_path, 0, 4, kwalk_itk_table_steps};
+
+/* ip_kobject of an ipc_port, through the IOMachPort wrapper where there is one */
+const struct kwalk_step kwalk_ipc_kobject_steps[] = {
+  KWALK_STEP(KWALK_LOAD, KWALK_FIELD(ipc_port_kobject)),
+  KWALK_STEP_IF(KWALK_LOAD, KWALK_FIELD(iomachport_object), KWALK_FIELD(ipc_port_kobject_is_iomachport)),
+  KWALK_STEP_KPTR(KWALK_UNSIGN, KWALK_NONE),
+};
+const struct kwalk_path kwalk_ipc_kobject_path = {"ipc_kobject", NULL, 0, 3, kwalk_ipc_kobject_steps};
 
 /* Functions */
 /**
- * @brief           Get kernel's base from the libkrw library.
+ * @brief           Get kernel's base from the kmem backend.
  * @return          Kernel base, zero on failure
  */
 uint64_t krw_get_kbase(void) {
-  uint64_t base = 0;
-  if (kbase(&base) || !base) {
+  uint64_t base = kbase_cached;
+  if (base) {
+    return base;
+  }
+  if (kmem_kbase(&base) || !base) {
     x8A4_log_error("Failed get kernel base!\n", "");
     return 0;
   }
+  kbase_cached = base;
   return base;
 }
 
+/**
+ * @brief           Asks the kmem backend for the kernel's base ahead of the slide, backends without it are not an error
+ * @return          Zero
+ */
+int kbase_prefetch(void) {
+  uint64_t base = 0;
+  int ret = kmem_kbase(&base);
+  x8A4_log_debug("kbase ret: %d kbase: 0x%016llX!\n", ret, base);
+  if (!ret && base) {
+    kbase_cached = base;
+  }
+  return 0;
+}
+
 /**
  * @brief           Verifies if tfp0 kread works
  * @return          Zero on kread success
  */
 int tfp0_init(void) {
   uint32_t read_bytes = 0;
-  uint64_t base = 0;
-  int ret = kbase(&base);
-  x8A4_log_debug("kbase ret: %d kbase: 0x%016llX!\n", ret, base);
+  uint64_t base = kbase_cached;
+  if (!base) {
+    int ret = kmem_kbase(&base);
+    x8A4_log_debug("kbase ret: %d kbase: 0x%016llX!\n", ret, base);
+  }
   if (!base) {
     base = gXPF.kernelBase + get_slide();
   }
-  if(kread(base, &read_bytes, 4) || read_bytes != 0xFEEDFACF) {
+  if(kmem_read(base, &read_bytes, 4) || read_bytes != 0xFEEDFACF) {
     x8A4_log_error("Failed kread at kbase: 0x%016llX!\n", base);
     return -1;
   }
@@ -62,18 +120,89 @@ int tfp0_init(void) {
 }
 
 /**
- * @brief           Initializes XPF lib with filesystem kernel
+ * @brief           Serves bulk kernel reads through physread if the krw plugin implements it
+ * @return          Zero on success
+ */
+int physread_init(void) {
+  if (!kmem_phys_enabled_cached || kmem_backend_offline()) {
+    return 0;
+  }
+  uint64_t cpu_ttep = kpf_cache_item_resolve("kernelSymbol.cpu_ttep");
+  if (!cpu_ttep) {
+    x8A4_log_error("Failed to find kernel cpu_ttep, physread disabled!\n", "");
+    return -1;
+  }
+  uint64_t ttep = 0;
+  int ret = kmem_read(cpu_ttep + get_slide(), &ttep, sizeof(uint64_t));
+  if (ret || !ttep) {
+    x8A4_log_error("Failed to read kernel cpu_ttep (%d), physread disabled!\n", ret);
+    return -1;
+  }
+  ret = kmem_phys_backend_open(kmem_backend_get(), ttep, koffsets_cached->t1sz_boot);
+  if (ret) {
+    x8A4_log_error("Failed to translate through physread (%d), physread disabled!\n", ret);
+    return -1;
+  }
+  return kmem_backend_set(&kmem_phys_backend);
+}
+
+/**
+ * @brief           Initializes the kernel info from the kpf cache, or XPF with the filesystem kernel
  * @return          Zero on XPF init success
  */
 int xpf_init(void) {
-  int ret = xpf_start_with_kernel_path(get_kernel_path());
-  const char *err = xpf_get_error();
-  if(err) {
-    x8A4_log_error("Can't proceed with kernel init, failed to start xpf with kernel: \"%s\" error: %s\n", get_kernel_path(), err);
+  if (!kpf_cache_load()) {
+    return 0;
   }
-  if(!ret) {
-    x8A4_set_nonce_format();
+  return xpf_require();
+}
+
+/**
+ * @brief           Starts XPF with the filesystem kernel unless it is already running, preferring its decompressed copy
+ * @return          Zero on XPF init success
+ */
+int xpf_require(void) {
+  kpf_lock();
+  int ret = 0;
+  if (!gXPF.kernel) {
+    kpf_cache_release_info();
+    const char *cached = kcache_lookup();
+    ret = xpf_start_with_kernel_path(cached ? cached : get_kernel_path());
+    int fallback = 0;
+    if (ret && cached) {
+      x8A4_log_debug("Failed to start xpf with decompressed kernelcache \"%s\" error: %s, falling back to preboot\n", cached, xpf_get_error());
+      xpf_stop();
+      ret = xpf_start_with_kernel_path(get_kernel_path());
+      cached = NULL;
+      fallback = 1;
+    }
+    const char *err = xpf_get_error();
+    if(err && (ret || !fallback)) {
+      x8A4_log_error("Can't proceed with kernel init, failed to start xpf with kernel: \"%s\" error: %s\n", get_kernel_path(), err);
+    }
+    if (!ret && !cached && gXPF.decompressedKernel) {
+      kcache_store(gXPF.decompressedKernel, gXPF.decompressedKernelSize);
+    }
+    if (!ret && slide_cached) {
+      kmem_static_init();
+    }
   }
+  kpf_unlock();
+  return ret;
+}
+
+/**
+ * @brief           Make the IMG4 Kext sections available, paging them from an uncompressed fileset kernelcache on a
+ *                  warm start instead of bringing the whole kernelcache up through XPF
+ * @return          Zero on success
+ */
+int xpf_require_img4(void) {
+  kpf_lock();
+  int ret = 0;
+  if (!gXPF.kernel && !(gXPF.darwinVersion && gXPF.kernelIsFileset && !kpager_fileset_open(kpager_kernel_path()))) {
+    ret = xpf_require();
+  }
+  kpf_unlock();
   return ret;
 }
 // int xpf_init(void) { return
@@ -218,19 +347,14 @@ const char *get_kernel_path_legacy(void) {
 #endif
 
 /**
- * @brief           Kernel kread wrapper for reading from SMR pointers
- * @param[in]       addr
- * @param[out]      value
- * @param[in]       sz
- * @return          Zero on success
+ * @brief           Decode an unsigned SMR pointer
+ * @param[in,out]   value
+ * @return          Decoded value
  */
-int kread_smr(uint64_t addr, uint64_t *value, size_t sz) {
-  int ret = kread(addr, value, sz);
-  if (ret || !value) {
-    x8A4_log_error("Failed to read kernel smr pointer 0x%llX 0x%zX(%d)\n", addr, sz, ret);
-    return -1;
+uint64_t decode_smr_ptr(uint64_t *value) {
+  if (!value) {
+    return 0;
   }
-  unsign_ptr(value);
   uint64_t bits = (koffsets_cached->smr << (62 - koffsets_cached->t1sz_boot));
   uint64_t case1 = 0xFFFFFFFFFFFFC000 & ~bits;
   uint64_t case2 = 0xFFFFFFFFFFFFFFE0 & ~bits;
@@ -241,6 +365,24 @@ int kread_smr(uint64_t addr, uint64_t *value, size_t sz) {
   } else {
     *value = (*value & case2) | bits;
   }
+  return *value;
+}
+
+/**
+ * @brief           Kernel kread wrapper for reading from SMR pointers
+ * @param[in]       addr
+ * @param[out]      value
+ * @param[in]       sz
+ * @return          Zero on success
+ */
+int kread_smr(uint64_t addr, uint64_t *value, size_t sz) {
+  int ret = kmem_read(addr, value, sz);
+  if (ret || !value) {
+    x8A4_log_error("Failed to read kernel smr pointer 0x%llX 0x%zX(%d)\n", addr, sz, ret);
+    return -1;
+  }
+  unsign_ptr(value);
+  decode_smr_ptr(value);
   return 0;
 }
 
@@ -260,6 +402,169 @@ uint64_t unsign_ptr(uint64_t *addr) {
   return *addr;
 }
 
+/**
+ * @brief           Find a pid in the proc index
+ * @param[in]       pid
+ * @return          Pointer to the index entry, NULL if not indexed
+ */
+struct proc_index_entry *proc_index_find(pid_t pid) {
+  for (size_t i = 0; i < proc_index_count_cached; i++) {
+    if (proc_index_cached[i].pid == pid) {
+      return &proc_index_cached[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief           Add or update a pid in the proc index
+ * @param[in]       pid
+ * @param[in]       proc
+ * @return          Zero on success
+ */
+int proc_index_add(pid_t pid, uint64_t proc) {
+  struct proc_index_entry *entry = proc_index_find(pid);
+  if (entry) {
+    entry->proc = proc;
+    return 0;
+  }
+  if (proc_index_count_cached == proc_index_capacity_cached) {
+    size_t capacity = proc_index_capacity_cached ? proc_index_capacity_cached * 2 : PROC_INDEX_INITIAL;
+    struct proc_index_entry *index = (struct proc_index_entry *)realloc(proc_index_cached, capacity * sizeof(struct proc_index_entry));
+    if (!index) {
+      x8A4_log_error("Failed to realloc memory for proc index!\n", "");
+      return ENOMEM;
+    }
+    proc_index_cached = index;
+    proc_index_capacity_cached = capacity;
+  }
+  proc_index_cached[proc_index_count_cached++] = (struct proc_index_entry){pid, proc};
+  return 0;
+}
+
+/**
+ * @brief           Read a proc's list next pointer and pid, in one read when they are close together
+ * @param[in]       proc
+ * @param[out]      next
+ * @param[out]      pid
+ * @return          Zero on success
+ */
+int proc_read_link(uint64_t proc, uint64_t *next, pid_t *pid) {
+  uint64_t next_off = koffsets_cached->proc_list_next;
+  uint64_t pid_off = koffsets_cached->proc_pid;
+  uint64_t lo = next_off < pid_off ? next_off : pid_off;
+  uint64_t hi = (next_off + sizeof(uint64_t)) > (pid_off + sizeof(pid_t)) ? (next_off + sizeof(uint64_t)) : (pid_off + sizeof(pid_t));
+  if (hi - lo > PROC_LINK_SPAN_MAX) {
+    int ret = kmem_read(proc + next_off, next, sizeof(uint64_t));
+    return ret ? ret : kmem_read(proc + pid_off, pid, sizeof(pid_t));
+  }
+  uint8_t buf[PROC_LINK_SPAN_MAX] = {0};
+  int ret = kmem_read(proc + lo, buf, hi - lo);
+  if (ret) {
+    return ret;
+  }
+  memcpy(next, buf + (next_off - lo), sizeof(uint64_t));
+  memcpy(pid, buf + (pid_off - lo), sizeof(pid_t));
+  return 0;
+}
+
+/**
+ * @brief           Walk allproc once, indexing every proc seen, until all wanted pids are found
+ * @param[in]       pids
+ * @param[in]       count
+ * @return          Number of wanted pids not found
+ */
+size_t proc_index_walk(const pid_t *pids, size_t count) {
+  size_t missing = 0;
+  for (size_t i = 0; i < count; i++) {
+    missing += proc_index_find(pids[i]) ? 0 : 1;
+  }
+  uint64_t proc = 0;
+  int ret = kmem_read(koffsets_cached->all_proc + get_slide() + koffsets_cached->proc_list_next, &proc, sizeof(uint64_t));
+  if (ret) {
+    x8A4_log_error("Failed to read kernel allproc! (%d)\n", ret);
+    return missing;
+  }
+  for (size_t n = 0; proc && missing && n < PROC_WALK_MAX; n++) {
+    uint64_t next = 0;
+    pid_t pid = 0;
+    if (proc_read_link(proc, &next, &pid)) {
+      x8A4_log_debug_error("Failed to read proc 0x%016llX\n", proc);
+      break;
+    }
+    int wanted = 0;
+    for (size_t i = 0; i < count; i++) {
+      wanted |= pids[i] == pid;
+    }
+    if (wanted && !proc_index_find(pid)) {
+      missing--;
+    }
+    proc_index_add(pid, proc);
+    proc = next;
+  }
+  return missing;
+}
+
+/**
+ * @brief           Check that an indexed proc still belongs to its pid, reading past the kmem cache
+ * @param[in]       entry
+ * @return          Non zero if still valid
+ */
+int proc_index_valid(const struct proc_index_entry *entry) {
+  pid_t pid = -1;
+  return !kmem_backend_read(entry->proc + koffsets_cached->proc_pid, &pid, sizeof(pid_t)) && pid == entry->pid;
+}
+
+/**
+ * @brief           Resolve the proc addresses of several pids in a single allproc walk
+ * @param[in]       pids
+ * @param[in]       count
+ * @param[out]      procs
+ * @return          Number of pids that were not found
+ */
+size_t get_procs_for_pids(const pid_t *pids, size_t count, uint64_t *procs) {
+  if (!pids || !procs) {
+    return count;
+  }
+  for (size_t i = 0; i < count; i++) {
+    struct proc_index_entry *entry = proc_index_find(pids[i]);
+    if (entry && !proc_index_valid(entry)) {
+      *entry = proc_index_cached[--proc_index_count_cached];
+    }
+  }
+  proc_index_walk(pids, count);
+  size_t missing = 0;
+  for (size_t i = 0; i < count; i++) {
+    struct proc_index_entry *entry = proc_index_find(pids[i]);
+    procs[i] = entry ? entry->proc : 0;
+    missing += entry ? 0 : 1;
+  }
+  return missing;
+}
+
+/**
+ * @brief           Resolve the proc address of a pid
+ * @param[in]       pid
+ * @return          Address of the pid's proc entry, zero if not found
+ */
+uint64_t get_proc_for_pid(pid_t pid) {
+  uint64_t proc = 0;
+  get_procs_for_pids(&pid, 1, &proc);
+  return proc;
+}
+
+/**
+ * @brief           Drop the pid to proc index
+ */
+void proc_index_flush(void) {
+  free(proc_index_cached);
+  proc_index_cached = NULL;
+  proc_index_count_cached = 0;
+  proc_index_capacity_cached = 0;
+  our_proc_cached = 0;
+  our_task_cached = 0;
+}
+
 /**
  * @brief           Traverses kernel proc struct to find our pid's proc entry
  * @return          Address of our proc's proc entry
@@ -268,24 +573,11 @@ uint64_t get_our_proc(void) {
   if (our_proc_cached) {
     return our_proc_cached;
   }
-  pid_t our_pid = getpid();
-  pid_t pid = 0;
-  uint64_t proc = koffsets_cached->all_proc + get_slide();
-  bool found = false;
-  while (!kread(proc + koffsets_cached->proc_list_next, (void *)&proc, 8)) {
-    int ret = kread(proc + koffsets_cached->proc_pid, (void *)&pid, 4);
-    if (ret) {
-      continue;
-    }
-    if (pid == our_pid) {
-      found = true;
-      break;
-    }
-  }
-  if (!found) {
+  our_proc_cached = get_proc_for_pid(getpid());
+  if (!our_proc_cached) {
     x8A4_log_error("Failed to find ourproc in kernel allproc!\n", "");
   }
-  return found ? proc : 0;
+  return our_proc_cached;
 }
 
 /**
@@ -304,7 +596,7 @@ uint64_t get_our_task(void) {
   if (strcmp(gXPF.darwinVersion, "22.0.0") >= 0) {
     our_task_cached = proc + koffsets_cached->proc_struct_size;
   } else {
-    int ret = kread(proc + koffsets_cached->proc_task, &proc, 8);
+    int ret = kmem_read(proc + koffsets_cached->proc_task, &proc, 8);
     if (ret || !proc) {
       x8A4_log_error("Failed to read from proc proc_task! (%d:0x%016llX)\n", ret, proc);
       return 0;
@@ -315,6 +607,139 @@ uint64_t get_our_task(void) {
   return proc + koffsets_cached->proc_struct_size;
 }
 
+/**
+ * @brief           Drop the cached ipc entry table base, e.g. after the table may have grown
+ */
+void ipc_table_invalidate(void) {
+  ipc_table_cached = 0;
+}
+
+/**
+ * @brief           Read the ipc entries of several port names, in one read of the table slice covering them when it is small
+ * @param[in]       table
+ * @param[in,out]   ports
+ * @param[in]       count
+ * @return          Number of entries that are empty or belong to another generation of the name
+ */
+size_t ipc_entries_read(uint64_t table, struct ipc_port_resolution *ports, size_t count) {
+  uint64_t entry_size = koffsets_cached->ipc_entry_size;
+  uint64_t min = UINT64_MAX;
+  uint64_t max = 0;
+  for (size_t i = 0; i < count; i++) {
+    uint64_t index = MACH_PORT_INDEX(ports[i].name);
+    min = index < min ? index : min;
+    max = index > max ? index : max;
+    ports[i].port = 0;
+  }
+  size_t span = (max - min + 1) * entry_size;
+  bool slice = span <= IPC_TABLE_SLICE_MAX;
+  uint8_t *buf = (uint8_t *)calloc(1, slice ? span : count * entry_size);
+  struct kmem_read_req *reqs = slice ? NULL : (struct kmem_read_req *)calloc(count, sizeof(struct kmem_read_req));
+  if (!buf || (!slice && !reqs)) {
+    x8A4_log_error("Failed to calloc memory for ipc entries!\n", "");
+    free(buf);
+    free(reqs);
+    return count;
+  }
+  if (slice) {
+    int ret = kmem_read(table + min * entry_size, buf, span);
+    if (ret) {
+      x8A4_log_error("Failed to read ipc entry table slice 0x%016llX len: 0x%zX! (%d)\n", table + min * entry_size, span, ret);
+      free(buf);
+      return count;
+    }
+  } else {
+    for (size_t i = 0; i < count; i++) {
+      reqs[i] = (struct kmem_read_req){table + MACH_PORT_INDEX(ports[i].name) * entry_size, buf + i * entry_size, entry_size, 0, NULL};
+    }
+    kmem_read_batch(reqs, count);
+  }
+  size_t failed = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (!slice && reqs[i].ret) {
+      failed++;
+      continue;
+    }
+    const uint8_t *entry = buf + (slice ? (MACH_PORT_INDEX(ports[i].name) - min) : i) * entry_size;
+    uint64_t object = 0;
+    uint32_t bits = 0;
+    memcpy(&object, entry + koffsets_cached->ipc_entry_object, sizeof(object));
+    memcpy(&bits, entry + koffsets_cached->ipc_entry_bits, sizeof(bits));
+    if (!object || (bits & IPC_ENTRY_GEN_MASK) != MACH_PORT_GEN(ports[i].name)) {
+      failed++;
+      continue;
+    }
+    ports[i].port = object;
+  }
+  free(buf);
+  free(reqs);
+  return failed;
+}
+
+/**
+ * @brief           Resolve the ipc_port, and optionally the kobject, of several port names from our ipc entry table
+ * @param[in,out]   ports
+ * @param[in]       count
+ * @param[in]       kobjects
+ * @return          Number of names that could not be resolved
+ */
+size_t resolve_ipc_ports(struct ipc_port_resolution *ports, size_t count, bool kobjects) {
+  if (!ports || !count) {
+    return count;
+  }
+  for (size_t i = 0; i < count; i++) {
+    ports[i].port = 0;
+    ports[i].kobject = 0;
+  }
+  uint64_t task = get_our_task();
+  if (task == 0) {
+    x8A4_log_error("Task is NULL!\n", "");
+    return count;
+  }
+  bool fresh = !ipc_table_cached;
+  if (fresh && kwalk_resolve(&kwalk_itk_table_path, task, 0, &ipc_table_cached)) {
+    x8A4_log_error("Failed to read kernel task itk_space table!\n", "");
+    ipc_table_cached = 0;
+    return count;
+  }
+  size_t failed = ipc_entries_read(ipc_table_cached, ports, count);
+  if (failed && !fresh) {
+    x8A4_log_debug("Ipc entry table 0x%016llX looks stale, re-reading it\n", ipc_table_cached);
+    uint64_t space = 0;
+    if (!kwalk_resolve(&kwalk_itk_space_path, task, 0, &space)) {
+      kmem_cache_invalidate(space + koffsets_cached->task_itk_space_table, sizeof(uint64_t));
+    }
+    for (size_t i = 0; i < count; i++) {
+      kmem_cache_invalidate(ipc_table_cached + MACH_PORT_INDEX(ports[i].name) * koffsets_cached->ipc_entry_size, koffsets_cached->ipc_entry_size);
+    }
+    ipc_table_invalidate();
+    return resolve_ipc_ports(ports, count, kobjects);
+  }
+  if (!kobjects) {
+    return failed;
+  }
+  uint64_t *roots = (uint64_t *)calloc(count, sizeof(uint64_t));
+  uint64_t *objects = (uint64_t *)calloc(count, sizeof(uint64_t));
+  if (!roots || !objects) {
+    x8A4_log_error("Failed to calloc memory for kobjects!\n", "");
+    free(roots);
+    free(objects);
+    return count;
+  }
+  for (size_t i = 0; i < count; i++) {
+    roots[i] = ports[i].port;
+  }
+  kwalk_resolve_roots(&kwalk_ipc_kobject_path, roots, count, objects);
+  failed = 0;
+  for (size_t i = 0; i < count; i++) {
+    ports[i].kobject = objects[i];
+    failed += objects[i] ? 0 : 1;
+  }
+  free(roots);
+  free(objects);
+  return failed;
+}
+
 /**
  * @brief           Get ipc_port address a from port name
  * @param[in]       port_name
@@ -325,40 +750,12 @@ uint64_t get_ipc_port(mach_port_name_t port_name) {
     x8A4_log_error("Port 0x%X is invalid!\n", port_name);
     return 0;
   }
-  uint64_t task = get_our_task();
-  if (task == 0) {
-    x8A4_log_error("Task is NULL!\n", "");
-    return 0;
-  }
-  uint64_t itk_space = 0;
-  int ret = kread(task + koffsets_cached->itk_space, &itk_space, 8);
-  if (ret || !itk_space) {
-    x8A4_log_error("Failed to read kernel task itk_space! (%d:0x%016llX)\n", ret, itk_space);
-    return 0;
-  }
-  unsign_ptr(&itk_space);
-  uint64_t table = 0;
-  if (koffsets_cached->table_smr) {
-    ret =
-        kread_smr(itk_space + koffsets_cached->task_itk_space_table, &table, 8);
-  } else {
-    ret = kread(itk_space + koffsets_cached->task_itk_space_table, &table, 8);
-  }
-  if (ret || !table) {
-    x8A4_log_error("Failed to read kernel task itk_space table! (%d:0x%016llX)\n", ret, table);
-    return 0;
-  }
-  uint64_t port = 0;
-  unsign_ptr(&table);
-  ret = kread(
-      table + (MACH_PORT_INDEX(port_name) * koffsets_cached->ipc_entry_size) +
-          koffsets_cached->ipc_entry_object,
-      &port, 8);
-  if (ret || !port) {
-    x8A4_log_error("Failed to read port from kernel ipc_entry object! (%d:0x%016llX)\\n", ret, port);
+  struct ipc_port_resolution port = {port_name, 0, 0};
+  if (resolve_ipc_ports(&port, 1, false)) {
+    x8A4_log_error("Failed to read port from kernel ipc_entry object! (0x%X)\n", port_name);
     return 0;
   }
-  return port;
+  return port.port;
 }
 
 /**
@@ -376,7 +773,7 @@ uint64_t get_ipc_kobject_from_iomachport(uint64_t port_addr) {
     return 0;
   }
   uint64_t kobject = 0;
-  int ret = kread(port_addr + koffsets_cached->iomachport_object, &kobject, 8);
+  int ret = kmem_read(port_addr + koffsets_cached->iomachport_object, &kobject, 8);
   if (ret || !kobject) {
     x8A4_log_error("Failed to read kobject from IOMachPort address! (%d:0x%016llX)\n", ret, kobject);
     return 0;
@@ -384,28 +781,147 @@ uint64_t get_ipc_kobject_from_iomachport(uint64_t port_addr) {
   return kobject;
 }
 
+/**
+ * @brief           Find a service in the service object cache
+ * @param[in]       service
+ * @return          Pointer to the cache entry, NULL if not cached
+ */
+struct service_object_cache_entry *service_object_cache_find(io_service_t service) {
+  for (size_t i = 0; i < service_object_cache_count_cached; i++) {
+    if (service_object_cache_cached[i].service == service) {
+      return &service_object_cache_cached[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief           Resolve a service's port and kobject through our ipc space
+ * @param[in,out]   entry
+ * @return          Zero on success
+ */
+int service_object_resolve_ipc(struct service_object_cache_entry *entry) {
+  struct ipc_port_resolution port = {entry->service, 0, 0};
+  if (resolve_ipc_ports(&port, 1, true)) {
+    x8A4_log_error("Failed to read kobject from ipc port! (0x%X)\n", entry->service);
+    return -1;
+  }
+  uint64_t port_kobject = 0;
+  int ret = kmem_read(port.port + koffsets_cached->ipc_port_kobject, &port_kobject, sizeof(uint64_t));
+  if (ret || !port_kobject) {
+    x8A4_log_error("Failed to read kobject from ipc port! (%d:0x%016llX)\n", ret, port_kobject);
+    return -1;
+  }
+  entry->port = port.port;
+  entry->port_kobject = port_kobject;
+  entry->kobject = port.kobject;
+  return 0;
+}
+
+/**
+ * @brief           Resolve a service's kobject through the kernel IORegistry
+ * @param[in,out]   entry
+ * @return          Zero on success
+ */
+int service_object_resolve_registry(struct service_object_cache_entry *entry) {
+  if (IORegistryEntryGetRegistryEntryID(entry->service, &entry->registry_id) != KERN_SUCCESS) {
+    x8A4_log_error("Failed to get registry entry ID of service 0x%X!\n", entry->service);
+    return -1;
+  }
+  entry->kobject = kregistry_find_service(entry->service);
+  if (!entry->kobject) {
+    x8A4_log_error("Failed to find service 0x%X in the kernel registry!\n", entry->service);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief           Get a service's cached kobject, checking with uncached reads that it still holds the same object
+ * @param[in]       service
+ * @return          Pointer to the cache entry, NULL if the service could not be resolved
+ */
+struct service_object_cache_entry *service_object_cache_get(io_service_t service) {
+  struct service_object_cache_entry *entry = service_object_cache_find(service);
+  if (entry) {
+    bool valid = false;
+    if (entry->port) {
+      uint64_t port_kobject = 0;
+      int ret = kmem_backend_read(entry->port + koffsets_cached->ipc_port_kobject, &port_kobject, sizeof(uint64_t));
+      valid = !ret && port_kobject == entry->port_kobject;
+    } else {
+      uint64_t reserved = 0;
+      uint64_t registry_id = 0;
+      int ret = kmem_backend_read(entry->kobject + koffsets_cached->io_registry_reserved, &reserved, sizeof(uint64_t));
+      unsign_ptr(&reserved);
+      if (!ret && reserved) {
+        ret = kmem_backend_read(reserved + koffsets_cached->io_registry_reserved_id, &registry_id, sizeof(uint64_t));
+      }
+      valid = !ret && registry_id == entry->registry_id;
+    }
+    if (valid) {
+      return entry;
+    }
+    x8A4_log_debug("Service 0x%X kobject changed, resolving it again\n", service);
+    *entry = service_object_cache_cached[--service_object_cache_count_cached];
+  }
+  struct service_object_cache_entry resolved = {service, 0, 0, 0, 0, 0};
+  if (kregistry_preferred_cached || service_object_resolve_ipc(&resolved)) {
+    if (service_object_resolve_registry(&resolved)) {
+      return NULL;
+    }
+  }
+  if (service_object_cache_count_cached == SERVICE_OBJECT_CACHE_MAX) {
+    service_object_cache_count_cached--;
+  }
+  entry = &service_object_cache_cached[service_object_cache_count_cached++];
+  *entry = resolved;
+  return entry;
+}
+
+/**
+ * @brief           Drop every cached service object
+ */
+void service_object_cache_flush(void) {
+  memset(service_object_cache_cached, 0, sizeof(service_object_cache_cached));
+  service_object_cache_count_cached = 0;
+}
+
 /**
  * @brief           Gets a service's kobject from an ipc_port address
  * @param[in]       service
  * @return          Address of kobject in kernel space
  */
 uint64_t get_ipc_kobject(io_service_t service) {
-  uint64_t port = get_ipc_port(service);
-  if (port == 0) {
-    x8A4_log_error("Ipc port address is zero!\n", "");
-    return 0;
+  struct service_object_cache_entry *entry = service_object_cache_get(service);
+  return entry ? entry->kobject : 0;
+}
+
+/**
+ * @brief           Gets the kobjects of several services in one pass over our ipc entry table
+ * @param[in]       services
+ * @param[in]       count
+ * @param[out]      kobjects
+ * @return          Number of services whose kobject could not be resolved
+ */
+int get_ipc_kobjects(const io_service_t *services, size_t count, uint64_t *kobjects) {
+  if (!services || !kobjects || !count) {
+    return (int)count;
   }
-  uint64_t kobject = 0;
-  int ret = kread(port + koffsets_cached->ipc_port_kobject, &kobject, 8);
-  if (ret || !kobject) {
-    x8A4_log_error("Failed to read kobject from ipc port! (%d:0x%016llX)\n", ret, kobject);
-    return 0;
+  struct ipc_port_resolution *ports = (struct ipc_port_resolution *)calloc(count, sizeof(struct ipc_port_resolution));
+  if (!ports) {
+    x8A4_log_error("Failed to calloc memory for ipc ports!\n", "");
+    return (int)count;
   }
-  if (koffsets_cached->ipc_port_kobject_is_iomachport) {
-    kobject = get_ipc_kobject_from_iomachport(kobject);
+  for (size_t i = 0; i < count; i++) {
+    ports[i].name = services[i];
   }
-  unsign_ptr(&kobject);
-  return kobject;
+  int failed = (int)resolve_ipc_ports(ports, count, true);
+  for (size_t i = 0; i < count; i++) {
+    kobjects[i] = ports[i].kobject;
+  }
+  free(ports);
+  return failed;
 }
 
 #if 0
@@ -419,17 +935,17 @@ __unused uint64_t get_generic_expert_current(void) {
     return 0;
   }
   uint64_t genx = 0;
-  ret = kread(genx_addr, &genx, 0x8);
+  ret = kmem_read(genx_addr, &genx, 0x8);
   if (ret || !genx) {
     return 0;
   }
   uint64_t genx_10 = 0;
-  ret = kread(genx + 0x10, &genx_10, 0x8);
+  ret = kmem_read(genx + 0x10, &genx_10, 0x8);
   if (ret || !genx_10) {
     return 0;
   }
   uint64_t genx_10_10 = 0;
-  ret = kread(genx_10 + 0x10, &genx_10_10, 0x8);
+  ret = kmem_read(genx_10 + 0x10, &genx_10_10, 0x8);
   if (ret) {
     return 0;
   }
@@ -437,7 +953,7 @@ __unused uint64_t get_generic_expert_current(void) {
     return genx_10_10;
   }
   uint64_t genx_10_0 = 0;
-  ret = kread(genx_10, &genx_10_0, 0x8);
+  ret = kmem_read(genx_10, &genx_10_0, 0x8);
   if (ret || !genx_10_0) {
     return 0;
   }
@@ -453,12 +969,12 @@ __unused uint64_t expert_get_magazine(uint64_t gen_xprt) {
   }
   int ret = 0;
   uint64_t mag_ptr = 0;
-  ret = kread(gen_xprt + 0x10, &mag_ptr, 0x8);
+  ret = kmem_read(gen_xprt + 0x10, &mag_ptr, 0x8);
   if (ret || !mag_ptr) {
     return 0;
   }
   uint64_t mag = 0;
-  ret = kread(mag_ptr + 0x38, &mag, 0x8);
+  ret = kmem_read(mag_ptr + 0x38, &mag, 0x8);
   if (ret || !mag) {
     return 0;
   }
@@ -475,40 +991,40 @@ __unused uint64_t nonce_magazine_find_slot_img4(uint64_t mag) {
   }
   int ret = 0;
   uint64_t off1 = 0;
-  ret = kread(mag + 0x20, &off1, 8);
+  ret = kmem_read(mag + 0x20, &off1, 8);
   if (ret || !off1) {
     return 0;
   }
   uint64_t off2 = 0;
-  ret = kread(mag + 0x18, &off2, 8);
+  ret = kmem_read(mag + 0x18, &off2, 8);
   if (ret || !off2) {
     return 0;
   }
   uint64_t tmp = off2;
   uint64_t tmp2 = 0;
-  kread(tmp, &tmp2, 8);
+  kmem_read(tmp, &tmp2, 8);
   fprintf(stdout, "[+]: %s: off2: 0x%016llX\n", __FUNCTION__, off2);
   fprintf(stdout, "[+]: %s: tmp2: 0x%016llX\n", __FUNCTION__, tmp2);
-  kread(tmp2, &tmp2, 8);
+  kmem_read(tmp2, &tmp2, 8);
   fprintf(stdout, "[+]: %s: tmp2: 0x%016llX\n", __FUNCTION__, tmp2);
-  kread(tmp2 + 0x40, &tmp2, 8);
+  kmem_read(tmp2 + 0x40, &tmp2, 8);
   fprintf(stdout, "[+]: %s: tmp2: 0x%016llX\n", __FUNCTION__, tmp2);
-  ret = kread(tmp, &tmp, 8);
+  ret = kmem_read(tmp, &tmp, 8);
   if (ret || !tmp) {
     return 0;
   }
-  ret = kread(tmp, &tmp, 8);
+  ret = kmem_read(tmp, &tmp, 8);
   if (ret || !tmp) {
     return 0;
   }
-  while (!kread(tmp, &tmp, 8) && tmp && !kread(tmp + 0x40, &tmp, 8) &&
+  while (!kmem_read(tmp, &tmp, 8) && tmp && !kmem_read(tmp + 0x40, &tmp, 8) &&
          (tmp != nonce_domain)) {
     tmp += 8;
     if (!(off2 -= 1)) {
       return 0;
     }
   }
-  ret = kread(off2, &tmp, 8);
+  ret = kmem_read(off2, &tmp, 8);
   return ret ? 0 : tmp;
 }
 
@@ -540,6 +1056,7 @@ int io_generate_apnonce(void) {
     x8A4_log_error("!IOConnectCallStructMethod APPLE_MOBILE_AP_NONCE_GENERATE_NONCE_SEL 0x%08X(%s)", ret, mach_error_string(ret));
     return -1;
   }
+  kmem_cache_flush();
   if (options_cached) {
     IOObjectRelease(options_cached);
     options_cached = IO_OBJECT_NULL;
@@ -572,6 +1089,7 @@ int io_clear_apnonce(void) {
     x8A4_log_error("Failed IOConnectCallStructMethod APPLE_MOBILE_AP_NONCE_CLEAR_NONCE_SEL! (0x%08:X%s)", ret, mach_error_string(ret));
     return -1;
   }
+  kmem_cache_flush();
   if (options_cached) {
     IOObjectRelease(options_cached);
     options_cached = IO_OBJECT_NULL;
@@ -0,0 +1,113 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kinit.c
+ * @author Cryptiiiic
+ * @brief This file is for running init steps as a dependency graph, independent steps on their own threads.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <errno.h>
+#include <x8A4/Kernel/kinit.h>
+#include <x8A4/Logger/logger.h>
+
+/* Functions */
+/**
+ * @brief           Add every transitive dependency to a set of wanted nodes
+ * @param[in]       nodes
+ * @param[in]       count
+ * @param[in]       wanted
+ * @return          Node set closed over its dependencies
+ */
+uint32_t kinit_closure(const struct kinit_node *nodes, size_t count, uint32_t wanted) {
+  for (size_t i = count; i-- > 0;) {
+    if (wanted & KINIT_NODE(i)) {
+      wanted |= nodes[i].deps;
+    }
+  }
+  return wanted;
+}
+
+/**
+ * @brief           Run one node once its dependencies and the nodes it is ordered after are done, skip it if one of its
+ *                  dependencies failed
+ * @param[in]       arg
+ * @return          NULL
+ */
+void *kinit_worker(void *arg) {
+  struct kinit_task *task = (struct kinit_task *)arg;
+  struct kinit_state *state = task->state;
+  uint32_t deps = task->node->deps;
+  uint32_t wait = deps | task->after;
+  pthread_mutex_lock(&state->lock);
+  while ((state->done & wait) != wait && !(state->failed & deps)) {
+    pthread_cond_wait(&state->cond, &state->lock);
+  }
+  int skip = (state->failed & deps) != 0;
+  pthread_mutex_unlock(&state->lock);
+  int ret = skip ? ECANCELED : task->node->run();
+  if (ret && !skip) {
+    x8A4_log_debug_error("init %s failed (%d)\n", task->node->name, ret);
+  }
+  pthread_mutex_lock(&state->lock);
+  state->done |= task->bit;
+  if (ret) {
+    state->failed |= task->bit;
+  }
+  pthread_cond_broadcast(&state->cond);
+  pthread_mutex_unlock(&state->lock);
+  return NULL;
+}
+
+/**
+ * @brief           Run the wanted nodes and their dependencies, joining only on real dependencies. Nodes must be
+ *                  listed in dependency order so that a node can run inline when its thread cannot be created
+ * @param[in]       nodes
+ * @param[in]       count
+ * @param[in]       wanted
+ * @param[in,out]   done
+ * @return          Zero on success
+ */
+int kinit_run(const struct kinit_node *nodes, size_t count, uint32_t wanted, uint32_t *done) {
+  if (!nodes || !done || count > KINIT_NODES_MAX) {
+    return EINVAL;
+  }
+  for (size_t i = 0; i < count; i++) {
+    if ((nodes[i].deps | nodes[i].after) >> i) {
+      x8A4_log_error("init %s depends on a later node!\n", nodes[i].name);
+      return EINVAL;
+    }
+  }
+  uint32_t pending = kinit_closure(nodes, count, wanted) & ~*done;
+  if (!pending) {
+    return 0;
+  }
+  struct kinit_state state = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, *done, 0};
+  struct kinit_task tasks[KINIT_NODES_MAX] = {0};
+  for (size_t i = 0; i < count; i++) {
+    if (!(pending & KINIT_NODE(i))) {
+      continue;
+    }
+    tasks[i] = (struct kinit_task){&nodes[i], KINIT_NODE(i), nodes[i].after & pending, &state, 0, 0};
+    if (!pthread_create(&tasks[i].thread, NULL, kinit_worker, &tasks[i])) {
+      tasks[i].threaded = 1;
+    } else {
+      kinit_worker(&tasks[i]);
+    }
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (tasks[i].threaded) {
+      pthread_join(tasks[i].thread, NULL);
+    }
+  }
+  *done |= state.done & ~state.failed;
+  pthread_mutex_destroy(&state.lock);
+  pthread_cond_destroy(&state.cond);
+  return (state.failed & pending) ? -1 : 0;
+}
@@ -0,0 +1,730 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem.c
+ * @author Cryptiiiic
+ * @brief This file is for all kernel memory access related code.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <errno.h>
+#include <stdbool.h>
+#include <libkrw.h>
+#include <stdlib.h>
+#include <string.h>
+#include <x8A4/Kernel/kmem.h>
+#include <x8A4/Kernel/kmem_async.h>
+#include <x8A4/Kernel/kmem_file.h>
+#include <x8A4/Kernel/kmem_plugin.h>
+#include <x8A4/Kernel/kmem_prefetch.h>
+#include <x8A4/Kernel/kmem_static.h>
+#include <x8A4/Kernel/kmem_stats.h>
+#include <x8A4/Kernel/kmem_tfp0.h>
+#include <x8A4/Kernel/kmem_trace.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+const struct kmem_backend kmem_libkrw_backend = {
+  .name = "libkrw",
+  .flags = 0,
+  .kbase = kbase,
+  .kread = kread,
+  .kwrite = kwrite,
+  .physread = physread,
+  .kcall = kcall,
+  .free = NULL,
+};
+const struct kmem_backend *kmem_backend_cached = &kmem_libkrw_backend;
+const char *kmem_image_path_cached = NULL;
+const char *kmem_record_path_cached = NULL;
+const char *kmem_replay_path_cached = NULL;
+const char *kmem_plugin_path_cached = NULL;
+int kmem_backend_offline_cached = 0;
+struct kmem_cache_line *kmem_cache_lines_cached = NULL;
+struct kmem_cache_stats kmem_cache_stats_cached = {0};
+int kmem_cache_enabled_cached = 1;
+
+/* Functions */
+/**
+ * @brief           Get a backend path from its setter or its environment variable
+ * @param[in]       path
+ * @param[in]       env
+ * @return          Path, NULL if unset
+ */
+const char *kmem_backend_path(const char *path, const char *env) {
+  if (!path) {
+    path = getenv(env);
+  }
+  if (!path || !path[0]) {
+    return NULL;
+  }
+  return path;
+}
+
+/**
+ * @brief           Select the kernel memory backend: a trace replay, sparse memory image or directly bound krw plugin if one was requested, the kernel task port if available, libkrw otherwise, optionally recorded to a trace
+ * @return          Zero on success
+ */
+int kmem_backend_init(void) {
+  const char *replay_path = kmem_backend_path(kmem_replay_path_cached, KMEM_REPLAY_ENV);
+  const char *image_path = kmem_backend_path(kmem_image_path_cached, KMEM_IMAGE_ENV);
+  const char *record_path = kmem_backend_path(kmem_record_path_cached, KMEM_RECORD_ENV);
+  const char *plugin_path = kmem_backend_path(kmem_plugin_path_cached, KMEM_PLUGIN_ENV);
+  const char *standin_path = kmem_backend_path(NULL, KMEM_TFP0_STANDIN_ENV);
+  const struct kmem_backend *backend = &kmem_libkrw_backend;
+  if (replay_path) {
+    if (kmem_trace_replay_open(replay_path)) {
+      x8A4_log_error("Failed to open kmem trace: %s!\n", replay_path);
+      return -1;
+    }
+    backend = &kmem_trace_replay_backend;
+  } else if (image_path) {
+    if (kmem_file_backend_open(image_path)) {
+      x8A4_log_error("Failed to open kmem image: %s!\n", image_path);
+      return -1;
+    }
+    backend = &kmem_file_backend;
+  } else if (plugin_path) {
+    if (kmem_plugin_backend_open(plugin_path)) {
+      x8A4_log_error("Failed to bind krw plugin: %s!\n", plugin_path);
+      return -1;
+    }
+    backend = &kmem_plugin_backend;
+  } else if (standin_path) {
+    if (kmem_tfp0_backend_open_standin(standin_path)) {
+      x8A4_log_error("Failed to open kmem tfp0 stand-in: %s!\n", standin_path);
+      return -1;
+    }
+    backend = &kmem_tfp0_backend;
+  } else if (!kmem_tfp0_backend_open()) {
+    backend = &kmem_tfp0_backend;
+  }
+  kmem_backend_offline_cached = standin_path || (backend != &kmem_libkrw_backend && backend != &kmem_plugin_backend && backend != &kmem_tfp0_backend);
+  if (record_path) {
+    if (kmem_trace_record_open(record_path, backend)) {
+      x8A4_log_error("Failed to record kmem trace: %s!\n", record_path);
+      return -1;
+    }
+    backend = &kmem_trace_record_backend;
+  }
+  return kmem_backend_set(backend);
+}
+
+/**
+ * @brief           Check if kernel memory is served offline, without libkrw
+ * @return          Non zero if offline
+ */
+int kmem_backend_offline(void) {
+  return kmem_backend_offline_cached;
+}
+
+/**
+ * @brief           Set the kernel memory backend
+ * @param[in]       backend
+ * @return          Zero on success
+ */
+int kmem_backend_set(const struct kmem_backend *backend) {
+  if (!backend || !backend->kread) {
+    x8A4_log_error("Failed to set kmem backend, backend has no kread!\n", "");
+    return -1;
+  }
+  if (backend != kmem_backend_cached) {
+    kmem_cache_flush();
+  }
+  kmem_backend_cached = backend;
+  x8A4_log_debug("Using kmem backend: %s\n", backend->name);
+  return 0;
+}
+
+/**
+ * @brief           Get the current kernel memory backend
+ * @return          Pointer to the backend
+ */
+const struct kmem_backend *kmem_backend_get(void) {
+  return kmem_backend_cached;
+}
+
+/**
+ * @brief           Set the sparse memory image to serve kernel memory from
+ * @param[in]       path
+ */
+void kmem_backend_set_image_path(const char *path) {
+  kmem_image_path_cached = path;
+}
+
+/**
+ * @brief           Set the trace file to record kernel memory traffic to
+ * @param[in]       path
+ */
+void kmem_backend_set_record_path(const char *path) {
+  kmem_record_path_cached = path;
+}
+
+/**
+ * @brief           Set the trace file to replay kernel memory traffic from
+ * @param[in]       path
+ */
+void kmem_backend_set_replay_path(const char *path) {
+  kmem_replay_path_cached = path;
+}
+
+/**
+ * @brief           Set the krw plugin to bind directly instead of going through libkrw
+ * @param[in]       path
+ */
+void kmem_backend_set_plugin_path(const char *path) {
+  kmem_plugin_path_cached = path;
+}
+
+/**
+ * @brief           Free the current kernel memory backend and fall back to libkrw
+ */
+void kmem_backend_free(void) {
+  if (kmem_backend_cached->free) {
+    kmem_backend_cached->free();
+  }
+  kmem_backend_cached = &kmem_libkrw_backend;
+  kmem_backend_offline_cached = 0;
+}
+
+/**
+ * @brief           Get the kernel base from the current backend
+ * @param[out]      addr
+ * @return          Zero on success
+ */
+int kmem_kbase(uint64_t *addr) {
+  if (!kmem_backend_cached->kbase) {
+    return ENOTSUP;
+  }
+  return kmem_backend_cached->kbase(addr);
+}
+
+/**
+ * @brief           Read kernel memory from the current backend, bypassing the kmem cache
+ * @param[in]       from
+ * @param[out]      to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_backend_read(uint64_t from, void *to, size_t len) {
+  kmem_stats_backend_read();
+  return kmem_backend_cached->kread(from, to, len);
+}
+
+/**
+ * @brief           Read several kernel memory ranges in one call to the current backend
+ * @param[in,out]   iov
+ * @param[in]       count
+ * @return          Zero if every range was read, per range results are stored in ret
+ */
+int kmem_backend_readv(struct krw_iovec_s *iov, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    iov[i].ret = EIO;
+  }
+  if (!kmem_backend_cached->kreadv) {
+    return ENOTSUP;
+  }
+  kmem_stats_backend_read();
+  return kmem_backend_cached->kreadv(iov, count);
+}
+
+/**
+ * @brief           Get the cache line slot for a line aligned kernel address
+ * @param[in]       line_addr
+ * @return          Pointer to the cache line slot, NULL if the cache is not allocated
+ */
+struct kmem_cache_line *kmem_cache_slot(uint64_t line_addr) {
+  if (!kmem_cache_lines_cached) {
+    kmem_cache_lines_cached = (struct kmem_cache_line *)calloc(KMEM_CACHE_LINE_COUNT, sizeof(struct kmem_cache_line));
+    if (!kmem_cache_lines_cached) {
+      x8A4_log_error("Failed to calloc memory for kmem cache!\n", "");
+      return NULL;
+    }
+  }
+  uint64_t line = line_addr / KMEM_CACHE_LINE_SIZE;
+  return &kmem_cache_lines_cached[(line ^ (line >> 10)) & (KMEM_CACHE_LINE_COUNT - 1)];
+}
+
+/**
+ * @brief           Check if a line aligned kernel address is cached
+ * @param[in]       line_addr
+ * @return          Pointer to the cache line, NULL on a miss
+ */
+struct kmem_cache_line *kmem_cache_lookup(uint64_t line_addr) {
+  struct kmem_cache_line *line = kmem_cache_slot(line_addr);
+  if (line && line->valid && line->tag == line_addr) {
+    return line;
+  }
+  return NULL;
+}
+
+/**
+ * @brief           Check if a kernel range is fully held by the kmem cache
+ * @param[in]       addr
+ * @param[in]       len
+ * @return          Non zero if every line of the range is cached
+ */
+int kmem_cache_covers(uint64_t addr, size_t len) {
+  if (!kmem_cache_enabled_cached || !len) {
+    return 0;
+  }
+  for (uint64_t line_addr = addr & KMEM_CACHE_LINE_MASK; line_addr < addr + len; line_addr += KMEM_CACHE_LINE_SIZE) {
+    if (!kmem_cache_lookup(line_addr)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * @brief           Store the whole cache lines of a kernel range that was read outside the kmem cache
+ * @param[in]       addr
+ * @param[in]       buf
+ * @param[in]       len
+ */
+void kmem_cache_store(uint64_t addr, const void *buf, size_t len) {
+  if (!kmem_cache_enabled_cached) {
+    return;
+  }
+  uint64_t line_addr = (addr + KMEM_CACHE_LINE_SIZE - 1) & KMEM_CACHE_LINE_MASK;
+  for (; line_addr >= addr && line_addr + KMEM_CACHE_LINE_SIZE <= addr + len; line_addr += KMEM_CACHE_LINE_SIZE) {
+    struct kmem_cache_line *line = kmem_cache_slot(line_addr);
+    if (!line) {
+      return;
+    }
+    line->tag = line_addr;
+    line->valid = 1;
+    memcpy(line->data, (const uint8_t *)buf + (line_addr - addr), KMEM_CACHE_LINE_SIZE);
+  }
+}
+
+/**
+ * @brief           Fill a run of missing cache lines with a single kernel read
+ * @param[in]       line_addr
+ * @param[in]       line_count
+ * @param[in]       from
+ * @param[out]      to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_cache_fill(uint64_t line_addr, size_t line_count, uint64_t from, uint8_t *to, size_t len) {
+  size_t run_len = line_count * KMEM_CACHE_LINE_SIZE;
+  uint8_t *run = (uint8_t *)malloc(run_len);
+  if (!run) {
+    x8A4_log_error("Failed to malloc memory for kmem cache run!\n", "");
+    return ENOMEM;
+  }
+  int ret = kmem_backend_read(line_addr, run, run_len);
+  if (ret) {
+    x8A4_log_debug_error("Failed to fill kmem cache lines 0x%016llX-0x%016llX (%d)\n", line_addr, line_addr + run_len, ret);
+    free(run);
+    return ret;
+  }
+  for (size_t i = 0; i < line_count; i++) {
+    struct kmem_cache_line *line = kmem_cache_slot(line_addr + (i * KMEM_CACHE_LINE_SIZE));
+    if (!line) {
+      break;
+    }
+    line->tag = line_addr + (i * KMEM_CACHE_LINE_SIZE);
+    line->valid = 1;
+    memcpy(line->data, &run[i * KMEM_CACHE_LINE_SIZE], KMEM_CACHE_LINE_SIZE);
+  }
+  memcpy(to, &run[from - line_addr], len);
+  free(run);
+  return 0;
+}
+
+/**
+ * @brief           Read kernel memory through the kmem cache
+ * @param[in]       from
+ * @param[out]      to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_read_through(uint64_t from, void *to, size_t len) {
+  if (!to || !len || from + len < from) {
+    return EINVAL;
+  }
+  if (!kmem_static_read(from, to, len)) {
+    return 0;
+  }
+  if (!kmem_cache_enabled_cached) {
+    kmem_cache_stats_cached.bypasses++;
+    return kmem_backend_read(from, to, len);
+  }
+  uint8_t *out = (uint8_t *)to;
+  uint64_t addr = from;
+  uint64_t end = from + len;
+  while (addr < end) {
+    uint64_t line_addr = addr & KMEM_CACHE_LINE_MASK;
+    struct kmem_cache_line *line = kmem_cache_lookup(line_addr);
+    if (line) {
+      kmem_cache_stats_cached.hits++;
+      size_t chunk = KMEM_CACHE_LINE_SIZE - (addr - line_addr);
+      if (chunk > end - addr) {
+        chunk = end - addr;
+      }
+      memcpy(out, &line->data[addr - line_addr], chunk);
+      out += chunk;
+      addr += chunk;
+      continue;
+    }
+    size_t line_count = 0;
+    uint64_t run_end = line_addr;
+    while (run_end < end && line_count < KMEM_CACHE_FILL_MAX && (line_count == 0 || !kmem_cache_lookup(run_end))) {
+      run_end += KMEM_CACHE_LINE_SIZE;
+      line_count++;
+    }
+    size_t chunk = (run_end < end ? run_end : end) - addr;
+    kmem_cache_stats_cached.misses += line_count;
+    int ret = kmem_cache_fill(line_addr, line_count, addr, out, chunk);
+    if (ret) {
+      kmem_cache_stats_cached.bypasses++;
+      ret = kmem_backend_read(addr, out, chunk);
+      if (ret) {
+        return ret;
+      }
+    }
+    out += chunk;
+    addr += chunk;
+  }
+  return 0;
+}
+
+/**
+ * @brief           Read kernel memory through the kmem cache, accounted to a call site
+ * @param[in]       site
+ * @param[in]       from
+ * @param[out]      to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_read_site(const char *site, uint64_t from, void *to, size_t len) {
+  kmem_prefetch_flush();
+  uint64_t start = kmem_stats_begin(site);
+  int ret = kmem_read_through(from, to, len);
+  kmem_stats_end(start, KMEM_STATS_READ, len, ret);
+  return ret;
+}
+
+/**
+ * @brief           Sort compare kmem read requests by kernel address
+ * @param[in]       a
+ * @param[in]       b
+ * @return          Sort order
+ */
+int kmem_read_req_compare(const void *a, const void *b) {
+  const struct kmem_read_req *req_a = *(const struct kmem_read_req **)a;
+  const struct kmem_read_req *req_b = *(const struct kmem_read_req **)b;
+  if (req_a->addr != req_b->addr) {
+    return req_a->addr < req_b->addr ? -1 : 1;
+  }
+  return req_a->len < req_b->len ? -1 : (req_a->len > req_b->len);
+}
+
+/**
+ * @brief           Read the deferred ranges of a batch in one vectored backend call
+ * @param[in,out]   ranges
+ * @param[in]       range_count
+ * @param[in]       deferred_count
+ */
+void kmem_read_batch_vectored(struct kmem_batch_range *ranges, size_t range_count, size_t deferred_count) {
+  if (!deferred_count) {
+    return;
+  }
+  struct krw_iovec_s *iov = (struct krw_iovec_s *)calloc(deferred_count, sizeof(struct krw_iovec_s));
+  if (!iov) {
+    x8A4_log_error("Failed to calloc memory for kmem vectored read!\n", "");
+    for (size_t r = 0; r < range_count; r++) {
+      if (ranges[r].deferred && ranges[r].req.buf) {
+        ranges[r].req.ret = ENOMEM;
+      }
+    }
+    return;
+  }
+  size_t iov_count = 0;
+  for (size_t r = 0; r < range_count; r++) {
+    if (ranges[r].deferred && ranges[r].req.buf) {
+      iov[iov_count++] = (struct krw_iovec_s){ranges[r].req.addr, ranges[r].req.buf, ranges[r].req.len, 0};
+    }
+  }
+  kmem_backend_readv(iov, iov_count);
+  for (size_t r = 0, v = 0; r < range_count; r++) {
+    if (ranges[r].deferred && ranges[r].req.buf) {
+      ranges[r].req.ret = iov[v++].ret;
+    }
+  }
+  free(iov);
+}
+
+/**
+ * @brief           Read a batch of kernel ranges, coalescing adjacent and overlapping ranges
+ * @param[in]       site
+ * @param[in,out]   reqs
+ * @param[in]       count
+ * @return          Number of failed requests, each failed request has a non zero ret
+ */
+int kmem_read_batch_site(const char *site, struct kmem_read_req *reqs, size_t count) {
+  if (!reqs) {
+    count = 0;
+  }
+  if (!count && !kmem_prefetch_count_cached) {
+    return 0;
+  }
+  uint64_t stats_start = kmem_stats_begin(site);
+  size_t prefetch_count = 0;
+  struct kmem_read_req *prefetch = kmem_prefetch_take(&prefetch_count);
+  struct kmem_read_req **sorted = (struct kmem_read_req **)calloc(count + prefetch_count, sizeof(struct kmem_read_req *));
+  if (!sorted) {
+    x8A4_log_error("Failed to calloc memory for kmem batch!\n", "");
+    kmem_prefetch_done();
+    kmem_stats_end(stats_start, KMEM_STATS_READ, 0, (int)count);
+    return (int)count;
+  }
+  size_t sorted_count = 0;
+  for (size_t i = 0; i < count; i++) {
+    reqs[i].ret = EINVAL;
+    if (reqs[i].buf && reqs[i].len && reqs[i].addr + reqs[i].len > reqs[i].addr) {
+      sorted[sorted_count++] = &reqs[i];
+    }
+  }
+  for (size_t i = 0; i < prefetch_count; i++) {
+    sorted[sorted_count++] = &prefetch[i];
+  }
+  qsort(sorted, sorted_count, sizeof(struct kmem_read_req *), kmem_read_req_compare);
+  struct kmem_batch_range *ranges = (struct kmem_batch_range *)calloc(sorted_count + 1, sizeof(struct kmem_batch_range));
+  struct kmem_async_group group = KMEM_ASYNC_GROUP_INITIALIZER;
+  int vectored = ranges && kmem_backend_cached->kreadv;
+  int async = ranges && !vectored && kmem_async_enabled();
+  size_t deferred_count = 0;
+  size_t range_count = 0;
+  size_t i = 0;
+  while (i < sorted_count) {
+    uint64_t start = sorted[i]->addr;
+    uint64_t end = start + sorted[i]->len;
+    size_t j = i + 1;
+    while (j < sorted_count) {
+      uint64_t next = sorted[j]->addr;
+      bool same_page = (next & KMEM_PAGE_MASK) == ((end - 1) & KMEM_PAGE_MASK);
+      if (next > end && !(same_page && next - end <= KMEM_BATCH_GAP_MAX)) {
+        break;
+      }
+      if (next + sorted[j]->len > end) {
+        end = next + sorted[j]->len;
+      }
+      j++;
+    }
+    int submit = (async || vectored) && !kmem_cache_covers(start, end - start) && !kmem_static_covers(start, end - start);
+    if (j - i == 1 && !submit) {
+      sorted[i]->ret = kmem_read_through(start, sorted[i]->buf, sorted[i]->len);
+    } else if (ranges) {
+      struct kmem_batch_range *range = &ranges[range_count++];
+      range->first = i;
+      range->last = j;
+      range->deferred = submit;
+      range->req.addr = start;
+      range->req.len = end - start;
+      range->req.buf = malloc(end - start);
+      if (!range->req.buf) {
+        range->req.ret = ENOMEM;
+      } else if (submit && vectored) {
+        deferred_count++;
+      } else if (submit) {
+        kmem_async_submit(&group, &range->req);
+      } else {
+        range->req.ret = kmem_read_through(start, range->req.buf, end - start);
+      }
+    } else {
+      for (size_t k = i; k < j; k++) {
+        sorted[k]->ret = kmem_read_through(sorted[k]->addr, sorted[k]->buf, sorted[k]->len);
+      }
+    }
+    i = j;
+  }
+  kmem_async_wait(&group);
+  kmem_read_batch_vectored(ranges, range_count, deferred_count);
+  for (size_t r = 0; r < range_count; r++) {
+    struct kmem_batch_range *range = &ranges[r];
+    uint8_t *buf = (uint8_t *)range->req.buf;
+    if (!range->req.ret && range->deferred) {
+      if (!vectored) {
+        kmem_stats_backend_read();
+      }
+      kmem_cache_store(range->req.addr, buf, range->req.len);
+    }
+    for (size_t k = range->first; k < range->last; k++) {
+      if (!range->req.ret) {
+        memcpy(sorted[k]->buf, &buf[sorted[k]->addr - range->req.addr], sorted[k]->len);
+        sorted[k]->ret = 0;
+      } else {
+        sorted[k]->ret = kmem_read_through(sorted[k]->addr, sorted[k]->buf, sorted[k]->len);
+      }
+    }
+    if (buf) {
+      free(buf);
+    }
+  }
+  if (ranges) {
+    free(ranges);
+  }
+  free(sorted);
+  kmem_prefetch_done();
+  int failed = 0;
+  size_t len = 0;
+  for (size_t k = 0; k < count; k++) {
+    len += reqs[k].len;
+    if (reqs[k].ret) {
+      failed++;
+    } else if (reqs[k].prefetch) {
+      kmem_prefetch_struct(reqs[k].prefetch, reqs[k].buf, reqs[k].len);
+    }
+  }
+  kmem_stats_end(stats_start, KMEM_STATS_READ, len, failed);
+  return failed;
+}
+
+/**
+ * @brief           Write kernel memory and invalidate the overlapping kmem cache lines, accounted to a call site
+ * @param[in]       site
+ * @param[in]       from
+ * @param[in]       to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_write_site(const char *site, void *from, uint64_t to, size_t len) {
+  if (!from || !len || to + len < to) {
+    return EINVAL;
+  }
+  if (!kmem_backend_cached->kwrite) {
+    return ENOTSUP;
+  }
+  uint64_t start = kmem_stats_begin(site);
+  int ret = kmem_backend_cached->kwrite(from, to, len);
+  kmem_cache_invalidate(to, len);
+  kmem_stats_end(start, KMEM_STATS_WRITE, len, ret);
+  return ret;
+}
+
+/**
+ * @brief           Read physical memory through the current backend
+ * @param[in]       from
+ * @param[out]      to
+ * @param[in]       len
+ * @param[in]       granule
+ * @return          Zero on success
+ */
+int kmem_physread(uint64_t from, void *to, size_t len, uint8_t granule) {
+  if (!to || !len || from + len < from) {
+    return EINVAL;
+  }
+  if (!kmem_backend_cached->physread) {
+    return ENOTSUP;
+  }
+  return kmem_backend_cached->physread(from, to, len, granule);
+}
+
+/**
+ * @brief           Map kernel memory into our address space for zero copy access through the current backend
+ * @param[in]       addr
+ * @param[in]       len
+ * @param[out]      out
+ * @return          Zero on success, the mapping stays valid until the backend is freed
+ */
+int kmem_map(uint64_t addr, size_t len, const void **out) {
+  if (!out || !len || addr + len < addr) {
+    return EINVAL;
+  }
+  if (!kmem_backend_cached->map) {
+    return ENOTSUP;
+  }
+  return kmem_backend_cached->map(addr, len, out);
+}
+
+/**
+ * @brief           Call a kernel function through the current backend
+ * @param[in]       func
+ * @param[in]       argc
+ * @param[in]       argv
+ * @param[out]      ret
+ * @return          Zero on success
+ */
+int kmem_kcall(uint64_t func, size_t argc, const uint64_t *argv, uint64_t *ret) {
+  if (!kmem_backend_cached->kcall) {
+    return ENOTSUP;
+  }
+  kmem_cache_flush();
+  return kmem_backend_cached->kcall(func, argc, argv, ret);
+}
+
+/**
+ * @brief           Invalidate the kmem cache lines overlapping a kernel range
+ * @param[in]       addr
+ * @param[in]       len
+ */
+void kmem_cache_invalidate(uint64_t addr, size_t len) {
+  if (!kmem_cache_lines_cached || !len) {
+    return;
+  }
+  uint64_t end = addr + len;
+  for (uint64_t line_addr = addr & KMEM_CACHE_LINE_MASK; line_addr < end; line_addr += KMEM_CACHE_LINE_SIZE) {
+    struct kmem_cache_line *line = kmem_cache_slot(line_addr);
+    if (line->valid && line->tag == line_addr) {
+      line->valid = 0;
+      kmem_cache_stats_cached.invalidations++;
+    }
+  }
+}
+
+/**
+ * @brief           Invalidate every kmem cache line
+ */
+void kmem_cache_flush(void) {
+  if (!kmem_cache_lines_cached) {
+    return;
+  }
+  for (int i = 0; i < KMEM_CACHE_LINE_COUNT; i++) {
+    if (kmem_cache_lines_cached[i].valid) {
+      kmem_cache_lines_cached[i].valid = 0;
+      kmem_cache_stats_cached.invalidations++;
+    }
+  }
+}
+
+/**
+ * @brief           Enable or disable the kmem cache
+ * @param[in]       enabled
+ */
+void kmem_cache_set_enabled(int enabled) {
+  if (!enabled) {
+    kmem_cache_flush();
+  }
+  kmem_cache_enabled_cached = enabled ? 1 : 0;
+}
+
+/**
+ * @brief           Get the kmem cache hit/miss counters
+ * @param[out]      stats
+ */
+void kmem_cache_get_stats(struct kmem_cache_stats *stats) {
+  if (!stats) {
+    return;
+  }
+  memcpy(stats, &kmem_cache_stats_cached, sizeof(struct kmem_cache_stats));
+}
+
+/**
+ * @brief           Free the kmem cache
+ */
+void kmem_cache_free(void) {
+  kmem_prefetch_free();
+  if (kmem_cache_lines_cached) {
+    free(kmem_cache_lines_cached);
+    kmem_cache_lines_cached = NULL;
+  }
+}
@@ -0,0 +1,179 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_async.c
+ * @author Cryptiiiic
+ * @brief This file is for the asynchronous kernel memory read queue.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <errno.h>
+#include <stdlib.h>
+#include <x8A4/Kernel/kmem_async.h>
+#include <x8A4/Kernel/kmem_plugin.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+uint32_t kmem_async_workers_cached = 0;
+int kmem_async_force_cached = 0;
+pthread_t kmem_async_threads_cached[KMEM_ASYNC_WORKERS_MAX];
+pthread_mutex_t kmem_async_lock_cached = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t kmem_async_cond_cached = PTHREAD_COND_INITIALIZER;
+struct kmem_async_work *kmem_async_head_cached = NULL;
+struct kmem_async_work *kmem_async_tail_cached = NULL;
+int kmem_async_stop_cached = 0;
+
+/* Functions */
+/**
+ * @brief           Worker thread, drives the backend for queued reads
+ * @param[in]       arg
+ * @return          NULL
+ */
+void *kmem_async_worker(void *arg) {
+  pthread_mutex_lock(&kmem_async_lock_cached);
+  while (1) {
+    while (!kmem_async_head_cached && !kmem_async_stop_cached) {
+      pthread_cond_wait(&kmem_async_cond_cached, &kmem_async_lock_cached);
+    }
+    if (!kmem_async_head_cached) {
+      break;
+    }
+    struct kmem_async_work *work = kmem_async_head_cached;
+    kmem_async_head_cached = work->next;
+    if (!kmem_async_head_cached) {
+      kmem_async_tail_cached = NULL;
+    }
+    pthread_mutex_unlock(&kmem_async_lock_cached);
+    struct kmem_read_req *req = work->req;
+    req->ret = kmem_backend_get()->kread(req->addr, req->buf, req->len);
+    struct kmem_async_group *group = work->group;
+    free(work);
+    pthread_mutex_lock(&group->lock);
+    if (req->ret) {
+      group->failed++;
+    }
+    if (--group->pending == 0) {
+      pthread_cond_broadcast(&group->cond);
+    }
+    pthread_mutex_unlock(&group->lock);
+    pthread_mutex_lock(&kmem_async_lock_cached);
+  }
+  pthread_mutex_unlock(&kmem_async_lock_cached);
+  return NULL;
+}
+
+/**
+ * @brief           Start the worker pool, zero workers runs every read serially. libkrw cannot tell if its plugin is
+ *                  thread safe, force marks it as such
+ * @param[in]       workers
+ * @param[in]       force
+ * @return          Zero on success
+ */
+int kmem_async_set_workers(uint32_t workers, int force) {
+  kmem_async_free();
+  if (workers > KMEM_ASYNC_WORKERS_MAX) {
+    workers = KMEM_ASYNC_WORKERS_MAX;
+  }
+  kmem_async_force_cached = force;
+  for (uint32_t i = 0; i < workers; i++) {
+    if (pthread_create(&kmem_async_threads_cached[i], NULL, kmem_async_worker, NULL)) {
+      x8A4_log_error("Failed to create kmem worker thread %u!\n", i);
+      break;
+    }
+    kmem_async_workers_cached++;
+  }
+  x8A4_log_debug("Started %u kmem worker threads\n", kmem_async_workers_cached);
+  return kmem_async_workers_cached == workers ? 0 : -1;
+}
+
+/**
+ * @brief           Check if reads are driven concurrently by the worker pool
+ * @return          Non zero if enabled
+ */
+int kmem_async_enabled(void) {
+  const struct kmem_backend *backend = kmem_backend_get();
+  return kmem_async_workers_cached &&
+         ((backend->flags & KMEM_BACKEND_THREAD_SAFE) || (kmem_async_force_cached && (backend == &kmem_libkrw_backend || backend == &kmem_plugin_backend)));
+}
+
+/**
+ * @brief           Submit a read, completed when its group is waited on
+ * @param[in]       group
+ * @param[in,out]   req
+ * @return          Zero on success
+ */
+int kmem_async_submit(struct kmem_async_group *group, struct kmem_read_req *req) {
+  if (!group || !req) {
+    return EINVAL;
+  }
+  struct kmem_async_work *work = NULL;
+  if (kmem_async_enabled()) {
+    work = (struct kmem_async_work *)calloc(1, sizeof(struct kmem_async_work));
+  }
+  if (!work) {
+    req->ret = kmem_read_through(req->addr, req->buf, req->len);
+    if (req->ret) {
+      pthread_mutex_lock(&group->lock);
+      group->failed++;
+      pthread_mutex_unlock(&group->lock);
+    }
+    return 0;
+  }
+  work->req = req;
+  work->group = group;
+  pthread_mutex_lock(&group->lock);
+  group->pending++;
+  pthread_mutex_unlock(&group->lock);
+  pthread_mutex_lock(&kmem_async_lock_cached);
+  if (kmem_async_tail_cached) {
+    kmem_async_tail_cached->next = work;
+  } else {
+    kmem_async_head_cached = work;
+  }
+  kmem_async_tail_cached = work;
+  pthread_cond_signal(&kmem_async_cond_cached);
+  pthread_mutex_unlock(&kmem_async_lock_cached);
+  return 0;
+}
+
+/**
+ * @brief           Wait for every read submitted to a group
+ * @param[in]       group
+ * @return          Number of failed reads
+ */
+int kmem_async_wait(struct kmem_async_group *group) {
+  if (!group) {
+    return 0;
+  }
+  pthread_mutex_lock(&group->lock);
+  while (group->pending) {
+    pthread_cond_wait(&group->cond, &group->lock);
+  }
+  int failed = group->failed;
+  pthread_mutex_unlock(&group->lock);
+  return failed;
+}
+
+/**
+ * @brief           Stop the worker pool
+ */
+void kmem_async_free(void) {
+  if (!kmem_async_workers_cached) {
+    return;
+  }
+  pthread_mutex_lock(&kmem_async_lock_cached);
+  kmem_async_stop_cached = 1;
+  pthread_cond_broadcast(&kmem_async_cond_cached);
+  pthread_mutex_unlock(&kmem_async_lock_cached);
+  for (uint32_t i = 0; i < kmem_async_workers_cached; i++) {
+    pthread_join(kmem_async_threads_cached[i], NULL);
+  }
+  kmem_async_workers_cached = 0;
+  kmem_async_stop_cached = 0;
+}
@@ -0,0 +1,259 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_file.c
+ * @author Cryptiiiic
+ * @brief This file is for the sparse memory image kernel memory backend.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <x8A4/Kernel/kmem_file.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+const struct kmem_backend kmem_file_backend = {
+  .name = "file",
+  .flags = KMEM_BACKEND_THREAD_SAFE,
+  .kbase = kmem_file_kbase,
+  .kread = kmem_file_kread,
+  .kwrite = kmem_file_kwrite,
+  .physread = NULL,
+  .kcall = NULL,
+  .free = kmem_file_backend_free,
+  .map = kmem_file_map,
+};
+uint8_t *kmem_file_image_cached = NULL;
+size_t kmem_file_image_size_cached = 0;
+struct kmem_image_region *kmem_file_regions_cached = NULL;
+uint32_t kmem_file_region_count_cached = 0;
+uint64_t kmem_file_kbase_cached = 0;
+
+/* Functions */
+/**
+ * @brief           Sort compare image regions by kernel address
+ * @param[in]       a
+ * @param[in]       b
+ * @return          Sort order
+ */
+int kmem_file_region_compare(const void *a, const void *b) {
+  const struct kmem_image_region *region_a = (const struct kmem_image_region *)a;
+  const struct kmem_image_region *region_b = (const struct kmem_image_region *)b;
+  if (region_a->addr == region_b->addr) {
+    return 0;
+  }
+  return region_a->addr < region_b->addr ? -1 : 1;
+}
+
+/**
+ * @brief           Open a sparse memory image and serve kernel memory from it. This replaces the jailbreak primitive
+ *                  only, the walkers built on kmem still link IOKit and mach and run on an Apple host
+ * @param[in]       path
+ * @return          Zero on success
+ */
+int kmem_file_backend_open(const char *path) {
+  if (!path) {
+    return EINVAL;
+  }
+  kmem_file_backend_free();
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    x8A4_log_error("Failed to open kmem image %s (%d)!\n", path, errno);
+    return errno;
+  }
+  struct stat st = {0};
+  if (fstat(fd, &st) || st.st_size < sizeof(struct kmem_image_header)) {
+    x8A4_log_error("Failed to stat kmem image %s or image too small!\n", path);
+    close(fd);
+    return EINVAL;
+  }
+  uint8_t *image = (uint8_t *)mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (image == MAP_FAILED) {
+    x8A4_log_error("Failed to mmap kmem image %s (%d)!\n", path, errno);
+    return errno;
+  }
+  struct kmem_image_header *header = (struct kmem_image_header *)image;
+  size_t regions_size = header->region_count * sizeof(struct kmem_image_region);
+  if (header->magic != KMEM_IMAGE_MAGIC || header->version != KMEM_IMAGE_VERSION ||
+      sizeof(struct kmem_image_header) + regions_size > st.st_size) {
+    x8A4_log_error("Invalid kmem image header in %s!\n", path);
+    munmap(image, st.st_size);
+    return EINVAL;
+  }
+  struct kmem_image_region *regions = (struct kmem_image_region *)calloc(header->region_count + 1, sizeof(struct kmem_image_region));
+  if (!regions) {
+    x8A4_log_error("Failed to calloc memory for kmem image regions!\n", "");
+    munmap(image, st.st_size);
+    return ENOMEM;
+  }
+  memcpy(regions, image + sizeof(struct kmem_image_header), regions_size);
+  for (uint32_t i = 0; i < header->region_count; i++) {
+    if (regions[i].addr + regions[i].size < regions[i].addr ||
+        regions[i].offset + regions[i].size < regions[i].offset ||
+        regions[i].offset + regions[i].size > st.st_size) {
+      x8A4_log_error("Invalid kmem image region %u in %s!\n", i, path);
+      free(regions);
+      munmap(image, st.st_size);
+      return EINVAL;
+    }
+  }
+  qsort(regions, header->region_count, sizeof(struct kmem_image_region), kmem_file_region_compare);
+  kmem_file_image_cached = image;
+  kmem_file_image_size_cached = st.st_size;
+  kmem_file_regions_cached = regions;
+  kmem_file_region_count_cached = header->region_count;
+  kmem_file_kbase_cached = header->kbase;
+  x8A4_log_debug("Opened kmem image %s kbase: 0x%016llX regions: %u\n", path, header->kbase, header->region_count);
+  return 0;
+}
+
+/**
+ * @brief           Find the image region containing a kernel address
+ * @param[in]       addr
+ * @return          Pointer to the region, NULL if the address is not mapped
+ */
+struct kmem_image_region *kmem_file_find_region(uint64_t addr) {
+  uint32_t lo = 0;
+  uint32_t hi = kmem_file_region_count_cached;
+  while (lo < hi) {
+    uint32_t mid = lo + ((hi - lo) / 2);
+    if (kmem_file_regions_cached[mid].addr <= addr) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (!lo) {
+    return NULL;
+  }
+  struct kmem_image_region *region = &kmem_file_regions_cached[lo - 1];
+  if (addr - region->addr >= region->size) {
+    return NULL;
+  }
+  return region;
+}
+
+/**
+ * @brief           Copy between the image and a buffer, spanning adjacent regions
+ * @param[in]       addr
+ * @param[in,out]   buf
+ * @param[in]       len
+ * @param[in]       write
+ * @return          Zero on success
+ */
+int kmem_file_copy(uint64_t addr, uint8_t *buf, size_t len, int write) {
+  if (!kmem_file_image_cached) {
+    return ENXIO;
+  }
+  if (!buf || !len || addr + len < addr) {
+    return EINVAL;
+  }
+  while (len) {
+    struct kmem_image_region *region = kmem_file_find_region(addr);
+    if (!region) {
+      x8A4_log_debug_error("kmem image has no mapping for 0x%016llX\n", addr);
+      return EFAULT;
+    }
+    size_t chunk = region->size - (addr - region->addr);
+    if (chunk > len) {
+      chunk = len;
+    }
+    uint8_t *image = kmem_file_image_cached + region->offset + (addr - region->addr);
+    if (write) {
+      memcpy(image, buf, chunk);
+    } else {
+      memcpy(buf, image, chunk);
+    }
+    buf += chunk;
+    addr += chunk;
+    len -= chunk;
+  }
+  return 0;
+}
+
+/**
+ * @brief           Get the kernel base recorded in the image
+ * @param[out]      addr
+ * @return          Zero on success
+ */
+int kmem_file_kbase(uint64_t *addr) {
+  if (!addr) {
+    return EINVAL;
+  }
+  if (!kmem_file_kbase_cached) {
+    return ENOTSUP;
+  }
+  *addr = kmem_file_kbase_cached;
+  return 0;
+}
+
+/**
+ * @brief           Read kernel memory from the image
+ * @param[in]       from
+ * @param[out]      to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_file_kread(uint64_t from, void *to, size_t len) {
+  return kmem_file_copy(from, (uint8_t *)to, len, 0);
+}
+
+/**
+ * @brief           Write kernel memory to the private copy of the image
+ * @param[in]       from
+ * @param[in]       to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_file_kwrite(void *from, uint64_t to, size_t len) {
+  return kmem_file_copy(to, (uint8_t *)from, len, 1);
+}
+
+/**
+ * @brief           Get a pointer into the private copy of the image for a kernel range
+ * @param[in]       addr
+ * @param[in]       len
+ * @param[out]      out
+ * @return          Zero on success, EFAULT if the range is not inside a single region
+ */
+int kmem_file_map(uint64_t addr, size_t len, const void **out) {
+  if (!kmem_file_image_cached) {
+    return ENXIO;
+  }
+  struct kmem_image_region *region = kmem_file_find_region(addr);
+  if (!region || len > region->size - (addr - region->addr)) {
+    return EFAULT;
+  }
+  *out = kmem_file_image_cached + region->offset + (addr - region->addr);
+  return 0;
+}
+
+/**
+ * @brief           Unmap the image
+ */
+void kmem_file_backend_free(void) {
+  if (kmem_file_image_cached) {
+    munmap(kmem_file_image_cached, kmem_file_image_size_cached);
+    kmem_file_image_cached = NULL;
+    kmem_file_image_size_cached = 0;
+  }
+  if (kmem_file_regions_cached) {
+    free(kmem_file_regions_cached);
+    kmem_file_regions_cached = NULL;
+  }
+  kmem_file_region_count_cached = 0;
+  kmem_file_kbase_cached = 0;
+}
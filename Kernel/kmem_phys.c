@@ -0,0 +1,328 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_phys.c
+ * @author Cryptiiiic
+ * @brief This file is for the physical read kernel memory backend and its translation cache.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <errno.h>
+#include <string.h>
+#include <x8A4/Kernel/kmem_phys.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+const struct kmem_backend kmem_phys_backend = {
+  .name = "phys",
+  .flags = 0,
+  .kbase = kmem_phys_kbase,
+  .kread = kmem_phys_kread,
+  .kwrite = kmem_phys_kwrite,
+  .physread = kmem_phys_physread,
+  .kcall = kmem_phys_kcall,
+  .free = kmem_phys_backend_free,
+};
+int kmem_phys_enabled_cached = 0;
+const struct kmem_backend *kmem_phys_inner_cached = NULL;
+uint64_t kmem_phys_ttep_cached = 0;
+uint64_t kmem_phys_va_bits_cached = 0;
+struct kmem_phys_tlb_entry kmem_phys_tlb_cached[KMEM_PHYS_TLB_SIZE] = {0};
+uint64_t kmem_phys_tick_cached = 0;
+struct kmem_phys_stats kmem_phys_stats_cached = {0};
+
+/* Functions */
+/**
+ * @brief           Enable or disable serving bulk reads through physread
+ * @param[in]       enabled
+ */
+void kmem_phys_set_enabled(int enabled) {
+  kmem_phys_enabled_cached = enabled ? 1 : 0;
+}
+
+/**
+ * @brief           Wrap a backend and serve its bulk reads through physread
+ * @param[in]       inner
+ * @param[in]       ttep
+ * @param[in]       t1sz
+ * @return          Zero on success
+ */
+int kmem_phys_backend_open(const struct kmem_backend *inner, uint64_t ttep, uint64_t t1sz) {
+  if (!inner || !inner->kread || !ttep || !t1sz || t1sz >= 64) {
+    return EINVAL;
+  }
+  if (!inner->physread) {
+    return ENOTSUP;
+  }
+  kmem_phys_inner_cached = inner;
+  kmem_phys_ttep_cached = ttep & KMEM_PHYS_OA_MASK;
+  kmem_phys_va_bits_cached = 64 - t1sz;
+  kmem_phys_tlb_flush();
+  memset(&kmem_phys_stats_cached, 0, sizeof(struct kmem_phys_stats));
+  uint64_t kbase = 0;
+  uint64_t pa = 0;
+  int ret = inner->kbase ? inner->kbase(&kbase) : ENOTSUP;
+  if (!ret) {
+    ret = kmem_phys_translate(kbase, &pa);
+  }
+  if (!ret) {
+    ret = kmem_phys_check(kbase, pa);
+  }
+  if (ret) {
+    x8A4_log_debug_error("Failed to translate kernel base through physread (%d)!\n", ret);
+    kmem_phys_inner_cached = NULL;
+    return ret;
+  }
+  x8A4_log_debug("Serving %s bulk reads through physread ttep: 0x%016llX kbase pa: 0x%016llX\n", inner->name, kmem_phys_ttep_cached, pa);
+  return 0;
+}
+
+/**
+ * @brief           Check a translation of the kernel base by reading its Mach-O header through both kread and physread,
+ *                  the header ends mid page so the in page offset is checked along with the page base
+ * @param[in]       kbase
+ * @param[in]       pa
+ * @return          Zero if both reads agree
+ */
+int kmem_phys_check(uint64_t kbase, uint64_t pa) {
+  uint8_t virt[KMEM_PHYS_CHECK_SIZE] = {0};
+  uint8_t phys[KMEM_PHYS_CHECK_SIZE] = {0};
+  uint64_t end_pa = 0;
+  if ((pa & (KMEM_PAGE_SIZE - 1)) != (kbase & (KMEM_PAGE_SIZE - 1))) {
+    return EFAULT;
+  }
+  int ret = kmem_phys_translate(kbase + KMEM_PHYS_CHECK_SIZE - sizeof(uint32_t), &end_pa);
+  if (!ret && end_pa != pa + KMEM_PHYS_CHECK_SIZE - sizeof(uint32_t)) {
+    ret = EFAULT;
+  }
+  if (!ret) {
+    ret = kmem_phys_inner_cached->kread(kbase, virt, sizeof(virt));
+  }
+  if (!ret) {
+    ret = kmem_phys_inner_cached->physread(pa, phys, sizeof(phys), sizeof(uint32_t));
+  }
+  if (!ret && (*(uint32_t *)phys != 0xFEEDFACF || memcmp(virt, phys, sizeof(phys)))) {
+    ret = EFAULT;
+  }
+  return ret;
+}
+
+/**
+ * @brief           Walk the kernel page tables for a virtual address
+ * @param[in]       va
+ * @param[out]      pa
+ * @return          Zero on success
+ */
+int kmem_phys_walk(uint64_t va, uint64_t *pa) {
+  uint64_t table = kmem_phys_ttep_cached;
+  uint64_t va_bits = kmem_phys_va_bits_cached;
+  int level = 3;
+  while (level > 0 && KMEM_PHYS_PAGE_SHIFT + ((4 - level) * KMEM_PHYS_LEVEL_BITS) < va_bits) {
+    level--;
+  }
+  for (; level <= 3; level++) {
+    uint64_t shift = KMEM_PHYS_PAGE_SHIFT + ((3 - level) * KMEM_PHYS_LEVEL_BITS);
+    uint64_t index_bits = va_bits - shift < KMEM_PHYS_LEVEL_BITS ? va_bits - shift : KMEM_PHYS_LEVEL_BITS;
+    uint64_t index = (va >> shift) & ((1ULL << index_bits) - 1);
+    uint64_t tte = 0;
+    int ret = kmem_phys_inner_cached->physread(table + (index * sizeof(uint64_t)), &tte, sizeof(uint64_t), sizeof(uint64_t));
+    if (ret) {
+      return ret;
+    }
+    if (!(tte & KMEM_PHYS_TTE_VALID)) {
+      return EFAULT;
+    }
+    uint64_t out = tte & KMEM_PHYS_OA_MASK;
+    if (level == 3) {
+      if (!(tte & KMEM_PHYS_TTE_TABLE)) {
+        return EFAULT;
+      }
+      *pa = out;
+      return 0;
+    }
+    if (!(tte & KMEM_PHYS_TTE_TABLE)) {
+      uint64_t block_mask = (1ULL << shift) - 1;
+      *pa = (out & ~block_mask) | (va & block_mask & KMEM_PAGE_MASK);
+      return 0;
+    }
+    table = out;
+  }
+  return EFAULT;
+}
+
+/**
+ * @brief           Translate a kernel virtual address, walking the page tables once per page
+ * @param[in]       va
+ * @param[out]      pa
+ * @return          Zero on success
+ */
+int kmem_phys_translate(uint64_t va, uint64_t *pa) {
+  if (!pa || !kmem_phys_inner_cached) {
+    return EINVAL;
+  }
+  uint64_t page = va & KMEM_PAGE_MASK;
+  struct kmem_phys_tlb_entry *victim = &kmem_phys_tlb_cached[0];
+  for (int i = 0; i < KMEM_PHYS_TLB_SIZE; i++) {
+    struct kmem_phys_tlb_entry *entry = &kmem_phys_tlb_cached[i];
+    if (entry->tick && entry->va == page) {
+      entry->tick = ++kmem_phys_tick_cached;
+      kmem_phys_stats_cached.tlb_hits++;
+      *pa = entry->pa | (va & (KMEM_PAGE_SIZE - 1));
+      return 0;
+    }
+    if (entry->tick < victim->tick) {
+      victim = entry;
+    }
+  }
+  kmem_phys_stats_cached.tlb_misses++;
+  uint64_t page_pa = 0;
+  int ret = kmem_phys_walk(page, &page_pa);
+  if (ret) {
+    kmem_phys_stats_cached.walks_failed++;
+    x8A4_log_debug_error("Failed to translate 0x%016llX (%d)\n", va, ret);
+    return ret;
+  }
+  victim->va = page;
+  victim->pa = page_pa;
+  victim->tick = ++kmem_phys_tick_cached;
+  *pa = page_pa | (va & (KMEM_PAGE_SIZE - 1));
+  return 0;
+}
+
+/**
+ * @brief           Drop every cached translation
+ */
+void kmem_phys_tlb_flush(void) {
+  memset(kmem_phys_tlb_cached, 0, sizeof(kmem_phys_tlb_cached));
+  kmem_phys_tick_cached = 0;
+}
+
+/**
+ * @brief           Get the kernel base from the wrapped backend
+ * @param[out]      addr
+ * @return          Zero on success
+ */
+int kmem_phys_kbase(uint64_t *addr) {
+  if (!kmem_phys_inner_cached->kbase) {
+    return ENOTSUP;
+  }
+  return kmem_phys_inner_cached->kbase(addr);
+}
+
+/**
+ * @brief           Read kernel memory, serving bulk reads page by page through physread
+ * @param[in]       from
+ * @param[out]      to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_phys_kread(uint64_t from, void *to, size_t len) {
+  if (len < KMEM_PHYS_BULK_MIN) {
+    return kmem_phys_inner_cached->kread(from, to, len);
+  }
+  uint8_t *buf = (uint8_t *)to;
+  while (len) {
+    uint64_t pa = 0;
+    if (kmem_phys_translate(from, &pa)) {
+      break;
+    }
+    size_t run = KMEM_PAGE_SIZE - (from & (KMEM_PAGE_SIZE - 1));
+    if (run > len) {
+      run = len;
+    }
+    while (run < len) {
+      uint64_t next_pa = 0;
+      if (kmem_phys_translate(from + run, &next_pa) || next_pa != pa + run) {
+        break;
+      }
+      run += len - run < KMEM_PAGE_SIZE ? len - run : KMEM_PAGE_SIZE;
+    }
+    uint8_t granule = ((pa | run) & (sizeof(uint64_t) - 1)) ? 1 : sizeof(uint64_t);
+    if (kmem_phys_inner_cached->physread(pa, buf, run, granule)) {
+      break;
+    }
+    kmem_phys_stats_cached.phys_reads++;
+    kmem_phys_stats_cached.phys_bytes += run;
+    buf += run;
+    from += run;
+    len -= run;
+  }
+  if (!len) {
+    return 0;
+  }
+  kmem_phys_stats_cached.fallbacks++;
+  return kmem_phys_inner_cached->kread(from, buf, len);
+}
+
+/**
+ * @brief           Write kernel memory through the wrapped backend
+ * @param[in]       from
+ * @param[in]       to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_phys_kwrite(void *from, uint64_t to, size_t len) {
+  if (!kmem_phys_inner_cached->kwrite) {
+    return ENOTSUP;
+  }
+  return kmem_phys_inner_cached->kwrite(from, to, len);
+}
+
+/**
+ * @brief           Read physical memory through the wrapped backend
+ * @param[in]       from
+ * @param[out]      to
+ * @param[in]       len
+ * @param[in]       granule
+ * @return          Zero on success
+ */
+int kmem_phys_physread(uint64_t from, void *to, size_t len, uint8_t granule) {
+  return kmem_phys_inner_cached->physread(from, to, len, granule);
+}
+
+/**
+ * @brief           Call a kernel function through the wrapped backend
+ * @param[in]       func
+ * @param[in]       argc
+ * @param[in]       argv
+ * @param[out]      ret
+ * @return          Zero on success
+ */
+int kmem_phys_kcall(uint64_t func, size_t argc, const uint64_t *argv, uint64_t *ret) {
+  if (!kmem_phys_inner_cached->kcall) {
+    return ENOTSUP;
+  }
+  kmem_phys_tlb_flush();
+  return kmem_phys_inner_cached->kcall(func, argc, argv, ret);
+}
+
+/**
+ * @brief           Get the physical read counters
+ * @param[out]      stats
+ */
+void kmem_phys_get_stats(struct kmem_phys_stats *stats) {
+  if (stats) {
+    *stats = kmem_phys_stats_cached;
+  }
+}
+
+/**
+ * @brief           Drop the translations and free the wrapped backend
+ */
+void kmem_phys_backend_free(void) {
+  kmem_phys_tlb_flush();
+  if (kmem_phys_inner_cached) {
+    if (kmem_phys_inner_cached->free) {
+      kmem_phys_inner_cached->free();
+    }
+    kmem_phys_inner_cached = NULL;
+  }
+  kmem_phys_ttep_cached = 0;
+  kmem_phys_va_bits_cached = 0;
+}
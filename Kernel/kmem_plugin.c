@@ -0,0 +1,183 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_plugin.c
+ * @author Cryptiiiic
+ * @brief This file is for binding a krw plugin's handlers directly, without the libkrw dispatch layer.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <dirent.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <x8A4/Kernel/kmem_plugin.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+struct kmem_backend kmem_plugin_backend = {
+  .name = "plugin",
+  .flags = 0,
+  .free = kmem_plugin_backend_free,
+};
+struct kmem_plugin_handlers kmem_plugin_handlers_cached = {0};
+void *kmem_plugin_handle_cached = NULL;
+
+/* Functions */
+/**
+ * @brief           Load a single krw plugin and bind its handlers
+ * @param[in]       path
+ * @return          Zero on success
+ */
+int kmem_plugin_load(const char *path) {
+  void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+  if (!handle) {
+    x8A4_log_debug_error("Failed to dlopen krw plugin %s: %s\n", path, dlerror());
+    return ENOENT;
+  }
+  krw_plugin_initializer_t krw_initializer = (krw_plugin_initializer_t)dlsym(handle, "krw_initializer");
+  krw_plugin_initializer_t kcall_initializer = (krw_plugin_initializer_t)dlsym(handle, "kcall_initializer");
+  if (!krw_initializer && !kcall_initializer) {
+    x8A4_log_debug_error("krw plugin %s has no initializer!\n", path);
+    dlclose(handle);
+    return ENOTSUP;
+  }
+  struct kmem_plugin_handlers handlers = {0};
+  handlers.base.version = KMEM_PLUGIN_HANDLERS_VERSION;
+  int ret = krw_initializer ? krw_initializer(&handlers.base) : ENOTSUP;
+  if (ret || !handlers.base.kread) {
+    x8A4_log_debug_error("krw plugin %s has no kread (%d)\n", path, ret);
+    dlclose(handle);
+    return ret ? ret : ENOTSUP;
+  }
+  if (kcall_initializer) {
+    handlers.base.version = KMEM_PLUGIN_HANDLERS_VERSION;
+    kcall_initializer(&handlers.base);
+  }
+  if (handlers.base.version < KMEM_PLUGIN_HANDLERS_VERSION) {
+    handlers.flags = 0;
+    handlers.kreadv = NULL;
+  }
+  kmem_plugin_handlers_cached = handlers;
+  kmem_plugin_handle_cached = handle;
+  kmem_plugin_backend.flags = (handlers.flags & KMEM_PLUGIN_THREAD_SAFE) ? KMEM_BACKEND_THREAD_SAFE : 0;
+  kmem_plugin_backend.kbase = handlers.base.kbase;
+  kmem_plugin_backend.kread = handlers.base.kread;
+  kmem_plugin_backend.kwrite = handlers.base.kwrite;
+  kmem_plugin_backend.physread = handlers.base.physread;
+  kmem_plugin_backend.kcall = handlers.base.kcall;
+  kmem_plugin_backend.kreadv = handlers.kreadv;
+  x8A4_log_debug("Bound krw plugin %s version: %llu kreadv: %s\n", path, handlers.base.version, handlers.kreadv ? "yes" : "no");
+  return 0;
+}
+
+/**
+ * @brief           Sort compare plugin file names
+ * @param[in]       a
+ * @param[in]       b
+ * @return          Sort order
+ */
+int kmem_plugin_name_compare(const void *a, const void *b) {
+  return strcmp(*(const char **)a, *(const char **)b);
+}
+
+/**
+ * @brief           Load the first plugin in a directory that provides kread, in name order like libkrw
+ * @param[in]       dir_path
+ * @return          Zero on success
+ */
+int kmem_plugin_load_dir(const char *dir_path) {
+  DIR *dir = opendir(dir_path);
+  if (!dir) {
+    return ENOENT;
+  }
+  char **names = NULL;
+  size_t count = 0;
+  struct dirent *entry = NULL;
+  while ((entry = readdir(dir))) {
+    size_t len = strlen(entry->d_name);
+    if (len < 7 || strcmp(&entry->d_name[len - 6], ".dylib") != 0) {
+      continue;
+    }
+    char **grown = (char **)realloc(names, (count + 1) * sizeof(char *));
+    if (!grown) {
+      break;
+    }
+    names = grown;
+    names[count] = strdup(entry->d_name);
+    if (names[count]) {
+      count++;
+    }
+  }
+  closedir(dir);
+  int ret = ENOENT;
+  if (names) {
+    qsort(names, count, sizeof(char *), kmem_plugin_name_compare);
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (ret) {
+      char path[PATH_MAX] = {0};
+      snprintf(path, sizeof(path), "%s/%s", dir_path, names[i]);
+      ret = kmem_plugin_load(path);
+    }
+    free(names[i]);
+  }
+  free(names);
+  return ret;
+}
+
+/**
+ * @brief           Bind a krw plugin directly, path may be a plugin, a plugin directory, or "auto"
+ * @param[in]       path
+ * @return          Zero on success
+ */
+int kmem_plugin_backend_open(const char *path) {
+  if (!path) {
+    return EINVAL;
+  }
+  kmem_plugin_backend_free();
+  if (strcmp(path, "auto") == 0) {
+    int ret = kmem_plugin_load_dir(KMEM_PLUGIN_DIR_ROOTLESS);
+    if (ret) {
+      ret = kmem_plugin_load_dir(KMEM_PLUGIN_DIR);
+    }
+    return ret;
+  }
+  struct stat st = {0};
+  if (stat(path, &st)) {
+    x8A4_log_error("Failed to stat krw plugin %s (%d)!\n", path, errno);
+    return errno;
+  }
+  if (S_ISDIR(st.st_mode)) {
+    return kmem_plugin_load_dir(path);
+  }
+  return kmem_plugin_load(path);
+}
+
+/**
+ * @brief           Unbind the krw plugin and close it
+ */
+void kmem_plugin_backend_free(void) {
+  if (kmem_plugin_handle_cached) {
+    dlclose(kmem_plugin_handle_cached);
+    kmem_plugin_handle_cached = NULL;
+  }
+  memset(&kmem_plugin_handlers_cached, 0, sizeof(struct kmem_plugin_handlers));
+  kmem_plugin_backend.flags = 0;
+  kmem_plugin_backend.kbase = NULL;
+  kmem_plugin_backend.kread = NULL;
+  kmem_plugin_backend.kwrite = NULL;
+  kmem_plugin_backend.physread = NULL;
+  kmem_plugin_backend.kcall = NULL;
+  kmem_plugin_backend.kreadv = NULL;
+}
@@ -0,0 +1,133 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_prefetch.c
+ * @author Cryptiiiic
+ * @brief This file is for speculative pointer following kernel memory prefetch.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <stdlib.h>
+#include <string.h>
+#include <x8A4/Kernel/kernel.h>
+#include <x8A4/Kernel/kmem_prefetch.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+struct kmem_read_req *kmem_prefetch_reqs_cached = NULL;
+size_t kmem_prefetch_count_cached = 0;
+uint8_t *kmem_prefetch_scratch_cached = NULL;
+
+/* Functions */
+/**
+ * @brief           Queue a kernel range to be fetched into the kmem cache with the next batch
+ * @param[in]       addr
+ * @param[in]       len
+ */
+void kmem_prefetch_queue(uint64_t addr, size_t len) {
+  if (!kmem_cache_enabled_cached || !addr || !len || addr + len < addr) {
+    return;
+  }
+  if (len > KMEM_PREFETCH_LEN_MAX) {
+    len = KMEM_PREFETCH_LEN_MAX;
+  }
+  if (!kmem_prefetch_reqs_cached) {
+    kmem_prefetch_reqs_cached = (struct kmem_read_req *)calloc(KMEM_PREFETCH_MAX, sizeof(struct kmem_read_req));
+    if (!kmem_prefetch_reqs_cached) {
+      x8A4_log_error("Failed to calloc memory for kmem prefetch!\n", "");
+      return;
+    }
+  }
+  if (kmem_prefetch_count_cached == KMEM_PREFETCH_MAX) {
+    return;
+  }
+  struct kmem_read_req *req = &kmem_prefetch_reqs_cached[kmem_prefetch_count_cached++];
+  memset(req, 0, sizeof(struct kmem_read_req));
+  req->addr = addr;
+  req->len = len;
+}
+
+/**
+ * @brief           Queue the pointer fields of a struct that was just read
+ * @param[in]       desc
+ * @param[in]       buf
+ * @param[in]       len
+ */
+void kmem_prefetch_struct(const struct kmem_prefetch_desc *desc, const void *buf, size_t len) {
+  if (!desc || !buf) {
+    return;
+  }
+  for (uint32_t i = 0; i < desc->count; i++) {
+    const struct kmem_prefetch_field *field = &desc->fields[i];
+    if (field->offset + sizeof(uint64_t) > len) {
+      continue;
+    }
+    uint64_t ptr = 0;
+    memcpy(&ptr, (const uint8_t *)buf + field->offset, sizeof(uint64_t));
+    if (field->flags & KMEM_PREFETCH_UNSIGN) {
+      unsign_ptr(&ptr);
+    }
+    kmem_prefetch_queue(ptr, field->len);
+  }
+}
+
+/**
+ * @brief           Take the queued prefetch requests for a batch
+ * @param[out]      count
+ * @return          Pointer to the queued requests(struct array), NULL if none are queued
+ */
+struct kmem_read_req *kmem_prefetch_take(size_t *count) {
+  *count = 0;
+  if (!kmem_prefetch_count_cached) {
+    return NULL;
+  }
+  kmem_prefetch_scratch_cached = (uint8_t *)malloc(KMEM_PREFETCH_LEN_MAX);
+  if (!kmem_prefetch_scratch_cached) {
+    kmem_prefetch_count_cached = 0;
+    return NULL;
+  }
+  for (size_t i = 0; i < kmem_prefetch_count_cached; i++) {
+    kmem_prefetch_reqs_cached[i].buf = kmem_prefetch_scratch_cached;
+  }
+  *count = kmem_prefetch_count_cached;
+  return kmem_prefetch_reqs_cached;
+}
+
+/**
+ * @brief           Release the prefetch requests taken by a batch
+ */
+void kmem_prefetch_done(void) {
+  if (kmem_prefetch_scratch_cached) {
+    free(kmem_prefetch_scratch_cached);
+    kmem_prefetch_scratch_cached = NULL;
+  }
+  kmem_prefetch_count_cached = 0;
+}
+
+/**
+ * @brief           Fetch the queued prefetch requests now
+ * @return          Number of failed prefetch requests
+ */
+int kmem_prefetch_flush(void) {
+  if (!kmem_prefetch_count_cached) {
+    return 0;
+  }
+  return kmem_read_batch(NULL, 0);
+}
+
+/**
+ * @brief           Free the prefetch queue
+ */
+void kmem_prefetch_free(void) {
+  kmem_prefetch_done();
+  if (kmem_prefetch_reqs_cached) {
+    free(kmem_prefetch_reqs_cached);
+    kmem_prefetch_reqs_cached = NULL;
+  }
+}
@@ -0,0 +1,196 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_static.c
+ * @author Cryptiiiic
+ * @brief This file is for serving reads of immutable kernel image regions from the local kernelcache.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <errno.h>
+#include <string.h>
+#include <x8A4/Kernel/kmem.h>
+#include <x8A4/Kernel/kmem_static.h>
+#include <x8A4/Kernel/kpf.h>
+#include <x8A4/Kernel/kpf_cache.h>
+#include <x8A4/Kernel/slide.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+struct kmem_static_region kmem_static_regions_cached[KMEM_STATIC_REGIONS_MAX] = {0};
+size_t kmem_static_regions_count_cached = 0;
+struct kmem_static_stats kmem_static_stats_cached = {0};
+
+/* Functions */
+/**
+ * @brief           Add an XPF section to a set of static regions, classified by its segment
+ * @param[in,out]   regions
+ * @param[in,out]   count
+ * @param[in]       section
+ */
+void kmem_static_add_section(struct kmem_static_region *regions, size_t *count, PFSection *section) {
+  if (!section || !section->size || *count >= KMEM_STATIC_REGIONS_MAX) {
+    return;
+  }
+  char segname[sizeof(section->segname) + 1] = {0};
+  memcpy(segname, section->segname, sizeof(section->segname));
+  uint32_t flags = 0;
+  if (strstr(segname, "DATA_CONST")) {
+    flags = KMEM_STATIC_POINTERS;
+  } else if (strstr(segname, "TEXT")) {
+    flags = KMEM_STATIC_RAW | KMEM_STATIC_POINTERS;
+  }
+  if (!flags) {
+    return;
+  }
+  for (size_t i = 0; i < *count; i++) {
+    if (regions[i].section == section) {
+      return;
+    }
+  }
+  regions[(*count)++] = (struct kmem_static_region){section, section->vmaddr, section->vmaddr + section->size, flags};
+  x8A4_log_debug("kmem static region %s,%.16s: 0x%016llX-0x%016llX\n", segname, section->sectname, section->vmaddr, section->vmaddr + section->size);
+}
+
+/**
+ * @brief           Collect the immutable kernelcache sections XPF has mapped. The regions are built aside and published
+ *                  with a release store of their count, kmem reads on other init threads walk them without kpf_lock
+ * @return          Zero on success
+ */
+int kmem_static_init(void) {
+  kpf_lock();
+  if (!kmem_static_regions_count_cached && gXPF.kernel && slide_cached) {
+    struct kmem_static_region regions[KMEM_STATIC_REGIONS_MAX] = {0};
+    size_t count = 0;
+    kmem_static_add_section(regions, &count, gXPF.kernelTextSection);
+    kmem_static_add_section(regions, &count, gXPF.kernelStringSection);
+    kmem_static_add_section(regions, &count, gXPF.kernelConstSection);
+    kmem_static_add_section(regions, &count, gXPF.kernelOSLogSection);
+    kmem_static_add_section(regions, &count, gXPF.kernelPrelinkTextSection);
+    kmem_static_add_section(regions, &count, gXPF.kernelPLKTextSection);
+    kmem_static_add_section(regions, &count, gXPF.kernelDataConstSection);
+    kmem_static_add_section(regions, &count, gXPF.kernelPLKDataConstSection);
+    if (!xpf_setup_fileset_sections()) {
+      for (size_t i = 0; i < sizeof(apple_image4_fileset_sections) / sizeof(apple_image4_fileset_sections[0]); i++) {
+        kmem_static_add_section(regions, &count, apple_image4_fileset_sections[i]);
+      }
+    }
+    memcpy(kmem_static_regions_cached, regions, sizeof(regions));
+    __atomic_store_n(&kmem_static_regions_count_cached, count, __ATOMIC_RELEASE);
+  }
+  int ret = kmem_static_regions_count_cached ? 0 : -1;
+  kpf_unlock();
+  return ret;
+}
+
+/**
+ * @brief           Find the static region holding a whole slid kernel range
+ * @param[in]       addr
+ * @param[in]       len
+ * @param[in]       flags
+ * @return          Pointer to the region, NULL if the range is not fully inside one
+ */
+struct kmem_static_region *kmem_static_find(uint64_t addr, size_t len, uint32_t flags) {
+  if (!slide_cached || addr < slide_cached) {
+    return NULL;
+  }
+  uint64_t start = addr - slide_cached;
+  uint64_t end = start + len;
+  if (end < start) {
+    return NULL;
+  }
+  size_t count = __atomic_load_n(&kmem_static_regions_count_cached, __ATOMIC_ACQUIRE);
+  for (size_t i = 0; i < count; i++) {
+    struct kmem_static_region *region = &kmem_static_regions_cached[i];
+    if ((region->flags & flags) == flags && start >= region->start && end <= region->end) {
+      return region;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief           Check if a slid kernel range can be read raw from the kernelcache
+ * @param[in]       addr
+ * @param[in]       len
+ * @return          Non zero if covered
+ */
+int kmem_static_covers(uint64_t addr, size_t len) {
+  return kmem_static_find(addr, len, KMEM_STATIC_RAW) != NULL;
+}
+
+/**
+ * @brief           Read a slid kernel range holding no pointers from the kernelcache
+ * @param[in]       addr
+ * @param[out]      buf
+ * @param[in]       len
+ * @return          Zero on success, ENOENT if the range is not static
+ */
+int kmem_static_read(uint64_t addr, void *buf, size_t len) {
+  struct kmem_static_region *region = kmem_static_find(addr, len, KMEM_STATIC_RAW);
+  if (!region) {
+    return ENOENT;
+  }
+  if (pfsec_read_at_address(region->section, addr - slide_cached, buf, len)) {
+    kmem_static_stats_cached.fallbacks++;
+    return EFAULT;
+  }
+  kmem_static_stats_cached.reads++;
+  kmem_static_stats_cached.bytes += len;
+  return 0;
+}
+
+/**
+ * @brief           Read an array of kernel pointers, decoding chained fixups when it is static
+ * @param[in]       addr
+ * @param[out]      out
+ * @param[in]       count
+ * @return          Zero on success
+ */
+int kmem_static_read_pointers(uint64_t addr, uint64_t *out, size_t count) {
+  if (!out || !count) {
+    return EINVAL;
+  }
+  struct kmem_static_region *region = kmem_static_find(addr, count * sizeof(uint64_t), KMEM_STATIC_POINTERS);
+  if (!region) {
+    kmem_static_stats_cached.fallbacks++;
+    return kmem_read(addr, out, count * sizeof(uint64_t));
+  }
+  uint64_t vmaddr = addr - slide_cached;
+  for (size_t i = 0; i < count; i++, vmaddr += sizeof(uint64_t)) {
+    uint64_t value = pfsec_read64(region->section, vmaddr);
+    if (value) {
+      value = xpfsec_decode_pointer(region->section, vmaddr, value);
+    }
+    out[i] = value ? value + slide_cached : 0;
+  }
+  kmem_static_stats_cached.pointers += count;
+  return 0;
+}
+
+/**
+ * @brief           Get the static region stats
+ * @param[out]      stats
+ */
+void kmem_static_get_stats(struct kmem_static_stats *stats) {
+  if (stats) {
+    *stats = kmem_static_stats_cached;
+  }
+}
+
+/**
+ * @brief           Drop the static regions, must run before the XPF sections are freed
+ */
+void kmem_static_free(void) {
+  kpf_lock();
+  __atomic_store_n(&kmem_static_regions_count_cached, 0, __ATOMIC_RELEASE);
+  memset(kmem_static_regions_cached, 0, sizeof(kmem_static_regions_cached));
+  kpf_unlock();
+  memset(&kmem_static_stats_cached, 0, sizeof(kmem_static_stats_cached));
+}
@@ -0,0 +1,214 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_stats.c
+ * @author Cryptiiiic
+ * @brief This file is for per call site kernel memory access instrumentation.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <mach/mach_time.h>
+#include <stdlib.h>
+#include <string.h>
+#include <x8A4/Kernel/kmem_stats.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+int kmem_stats_enabled_cached = 0;
+struct kmem_site_stats *kmem_stats_sites_cached = NULL;
+size_t kmem_stats_site_count_cached = 0;
+struct kmem_site_stats *kmem_stats_current_cached = NULL;
+mach_timebase_info_data_t kmem_stats_timebase_cached = {0};
+
+/* Functions */
+/**
+ * @brief           Enable or disable kernel memory access instrumentation
+ * @param[in]       enabled
+ */
+void kmem_stats_set_enabled(int enabled) {
+  if (enabled && !kmem_stats_timebase_cached.denom) {
+    mach_timebase_info(&kmem_stats_timebase_cached);
+  }
+  kmem_stats_enabled_cached = enabled ? 1 : 0;
+}
+
+/**
+ * @brief           Get the counters for a call site, adding it if it is new
+ * @param[in]       site
+ * @return          Pointer to the call site counters, NULL if the table is full
+ */
+struct kmem_site_stats *kmem_stats_site(const char *site) {
+  if (!kmem_stats_sites_cached) {
+    kmem_stats_sites_cached = (struct kmem_site_stats *)calloc(KMEM_STATS_SITE_MAX, sizeof(struct kmem_site_stats));
+    if (!kmem_stats_sites_cached) {
+      x8A4_log_error("Failed to calloc memory for kmem stats!\n", "");
+      return NULL;
+    }
+  }
+  for (size_t i = 0; i < kmem_stats_site_count_cached; i++) {
+    if (kmem_stats_sites_cached[i].site == site) {
+      return &kmem_stats_sites_cached[i];
+    }
+  }
+  for (size_t i = 0; i < kmem_stats_site_count_cached; i++) {
+    if (strcmp(kmem_stats_sites_cached[i].site, site) == 0) {
+      return &kmem_stats_sites_cached[i];
+    }
+  }
+  if (kmem_stats_site_count_cached == KMEM_STATS_SITE_MAX) {
+    return NULL;
+  }
+  struct kmem_site_stats *stats = &kmem_stats_sites_cached[kmem_stats_site_count_cached++];
+  stats->site = site;
+  return stats;
+}
+
+/**
+ * @brief           Start timing a kernel memory access from a call site
+ * @param[in]       site
+ * @return          Start timestamp, zero if instrumentation is disabled
+ */
+uint64_t kmem_stats_begin(const char *site) {
+  if (!kmem_stats_enabled_cached || !site) {
+    return 0;
+  }
+  kmem_stats_current_cached = kmem_stats_site(site);
+  return mach_absolute_time();
+}
+
+/**
+ * @brief           Finish timing a kernel memory access and account it to its call site
+ * @param[in]       start
+ * @param[in]       op
+ * @param[in]       len
+ * @param[in]       ret
+ */
+void kmem_stats_end(uint64_t start, enum kmem_stats_op op, size_t len, int ret) {
+  struct kmem_site_stats *stats = kmem_stats_current_cached;
+  if (!start || !stats) {
+    return;
+  }
+  kmem_stats_current_cached = NULL;
+  uint64_t ns = ((mach_absolute_time() - start) * kmem_stats_timebase_cached.numer) / kmem_stats_timebase_cached.denom;
+  if (op == KMEM_STATS_WRITE) {
+    stats->writes++;
+    stats->write_bytes += len;
+  } else {
+    stats->reads++;
+    stats->read_bytes += len;
+  }
+  if (ret) {
+    stats->errors++;
+  }
+  stats->total_ns += ns;
+  int bucket = 63 - __builtin_clzll(ns | 1);
+  if (bucket >= KMEM_STATS_HIST_BUCKETS) {
+    bucket = KMEM_STATS_HIST_BUCKETS - 1;
+  }
+  stats->hist[bucket]++;
+}
+
+/**
+ * @brief           Account a backend read to the current call site
+ */
+void kmem_stats_backend_read(void) {
+  if (kmem_stats_current_cached) {
+    kmem_stats_current_cached->backend_reads++;
+  }
+}
+
+/**
+ * @brief           Get the per call site counters
+ * @param[out]      count
+ * @return          Pointer to the call site counters(struct array)
+ */
+const struct kmem_site_stats *kmem_stats_get(size_t *count) {
+  if (count) {
+    *count = kmem_stats_site_count_cached;
+  }
+  return kmem_stats_sites_cached;
+}
+
+/**
+ * @brief           Get a latency percentile from a call site histogram
+ * @param[in]       stats
+ * @param[in]       percent
+ * @return          Upper bound of the percentile bucket in nanoseconds
+ */
+uint64_t kmem_stats_percentile(const struct kmem_site_stats *stats, int percent) {
+  uint64_t calls = stats->reads + stats->writes;
+  uint64_t target = ((calls * percent) + 99) / 100;
+  uint64_t seen = 0;
+  for (int i = 0; i < KMEM_STATS_HIST_BUCKETS; i++) {
+    seen += stats->hist[i];
+    if (seen >= target) {
+      return 2ULL << i;
+    }
+  }
+  return 2ULL << (KMEM_STATS_HIST_BUCKETS - 1);
+}
+
+/**
+ * @brief           Sort compare call sites by total time spent
+ * @param[in]       a
+ * @param[in]       b
+ * @return          Sort order
+ */
+int kmem_stats_compare(const void *a, const void *b) {
+  const struct kmem_site_stats *stats_a = *(const struct kmem_site_stats **)a;
+  const struct kmem_site_stats *stats_b = *(const struct kmem_site_stats **)b;
+  if (stats_a->total_ns == stats_b->total_ns) {
+    return 0;
+  }
+  return stats_a->total_ns > stats_b->total_ns ? -1 : 1;
+}
+
+/**
+ * @brief           Print the per call site counters as a table
+ */
+void kmem_stats_print(void) {
+  if (!kmem_stats_site_count_cached) {
+    x8A4_log("No kernel memory accesses recorded\n", "");
+    return;
+  }
+  const struct kmem_site_stats **sorted = (const struct kmem_site_stats **)calloc(kmem_stats_site_count_cached, sizeof(struct kmem_site_stats *));
+  if (!sorted) {
+    x8A4_log_error("Failed to calloc memory for kmem stats!\n", "");
+    return;
+  }
+  for (size_t i = 0; i < kmem_stats_site_count_cached; i++) {
+    sorted[i] = &kmem_stats_sites_cached[i];
+  }
+  qsort(sorted, kmem_stats_site_count_cached, sizeof(struct kmem_site_stats *), kmem_stats_compare);
+  x8A4_log("%-40s %8s %10s %8s %10s %8s %6s %12s %10s %10s %10s\n", "site", "reads", "rbytes", "writes", "wbytes", "backend", "errors", "total(ms)", "avg(us)", "p50(us)", "p99(us)");
+  uint64_t total_ns = 0;
+  for (size_t i = 0; i < kmem_stats_site_count_cached; i++) {
+    const struct kmem_site_stats *stats = sorted[i];
+    uint64_t calls = stats->reads + stats->writes;
+    x8A4_log("%-40s %8llu %10llu %8llu %10llu %8llu %6llu %12.3f %10.3f %10.3f %10.3f\n", stats->site,
+             stats->reads, stats->read_bytes, stats->writes, stats->write_bytes, stats->backend_reads, stats->errors,
+             stats->total_ns / 1000000.0, calls ? (stats->total_ns / (double)calls) / 1000.0 : 0.0,
+             kmem_stats_percentile(stats, 50) / 1000.0, kmem_stats_percentile(stats, 99) / 1000.0);
+    total_ns += stats->total_ns;
+  }
+  x8A4_log("%-40s %12.3f\n", "total(ms)", total_ns / 1000000.0);
+  free(sorted);
+}
+
+/**
+ * @brief           Reset and free the per call site counters
+ */
+void kmem_stats_reset(void) {
+  if (kmem_stats_sites_cached) {
+    free(kmem_stats_sites_cached);
+    kmem_stats_sites_cached = NULL;
+  }
+  kmem_stats_site_count_cached = 0;
+  kmem_stats_current_cached = NULL;
+}
@@ -0,0 +1,140 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_string.c
+ * @author Cryptiiiic
+ * @brief This file is for reading NUL terminated kernel strings into an intern table.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <stdlib.h>
+#include <string.h>
+#include <x8A4/Kernel/kmem_string.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+struct kmem_string **kmem_string_buckets_cached = NULL;
+
+/* Functions */
+/**
+ * @brief           Hash a string for the intern table(FNV-1a)
+ * @param[in]       str
+ * @param[in]       len
+ * @return          Hash of the string
+ */
+uint32_t kmem_string_hash(const char *str, size_t len) {
+  uint32_t hash = 0x811C9DC5U;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= (uint8_t)str[i];
+    hash *= 0x01000193U;
+  }
+  return hash;
+}
+
+/**
+ * @brief           Get the interned copy of a string, adding it if it is new
+ * @param[in]       str
+ * @param[in]       len
+ * @return          Pointer to the interned string, NULL on failure
+ */
+const char *kmem_string_intern(const char *str, size_t len) {
+  if (!str || len >= UINT32_MAX) {
+    return NULL;
+  }
+  if (!kmem_string_buckets_cached) {
+    kmem_string_buckets_cached = (struct kmem_string **)calloc(KMEM_STRING_BUCKETS, sizeof(struct kmem_string *));
+    if (!kmem_string_buckets_cached) {
+      x8A4_log_error("Failed to calloc memory for kmem string table!\n", "");
+      return NULL;
+    }
+  }
+  uint32_t hash = kmem_string_hash(str, len);
+  struct kmem_string **bucket = &kmem_string_buckets_cached[hash % KMEM_STRING_BUCKETS];
+  for (struct kmem_string *entry = *bucket; entry; entry = entry->next) {
+    if (entry->hash == hash && entry->len == len && memcmp(entry->str, str, len) == 0) {
+      return entry->str;
+    }
+  }
+  struct kmem_string *entry = (struct kmem_string *)malloc(sizeof(struct kmem_string) + len + 1);
+  if (!entry) {
+    x8A4_log_error("Failed to malloc memory for kmem string!\n", "");
+    return NULL;
+  }
+  entry->hash = hash;
+  entry->len = (uint32_t)len;
+  memcpy(entry->str, str, len);
+  entry->str[len] = '\0';
+  entry->next = *bucket;
+  *bucket = entry;
+  return entry->str;
+}
+
+/**
+ * @brief           Read a NUL terminated kernel string one cache line at a time
+ * @param[in]       site
+ * @param[in]       addr
+ * @param[in]       max_len
+ * @return          Pointer to the interned string, NULL if unreadable or unterminated within max_len
+ */
+const char *kmem_read_string_site(const char *site, uint64_t addr, size_t max_len) {
+  if (!addr) {
+    return NULL;
+  }
+  if (!max_len || max_len > KMEM_STRING_MAX) {
+    max_len = KMEM_STRING_MAX;
+  }
+  char *buf = (char *)malloc(max_len);
+  if (!buf) {
+    x8A4_log_error("Failed to malloc memory for kmem string!\n", "");
+    return NULL;
+  }
+  size_t len = 0;
+  while (len < max_len) {
+    uint64_t from = addr + len;
+    size_t chunk = KMEM_CACHE_LINE_SIZE - (from & (KMEM_CACHE_LINE_SIZE - 1));
+    if (chunk > max_len - len) {
+      chunk = max_len - len;
+    }
+    int ret = kmem_read_site(site, from, &buf[len], chunk);
+    if (ret) {
+      x8A4_log_debug_error("Failed to read kernel string chunk at 0x%016llX (%d)!\n", from, ret);
+      free(buf);
+      return NULL;
+    }
+    char *nul = (char *)memchr(&buf[len], '\0', chunk);
+    if (nul) {
+      const char *str = kmem_string_intern(buf, nul - buf);
+      free(buf);
+      return str;
+    }
+    len += chunk;
+  }
+  x8A4_log_debug_error("Kernel string at 0x%016llX is not terminated within 0x%zX bytes!\n", addr, max_len);
+  free(buf);
+  return NULL;
+}
+
+/**
+ * @brief           Free every interned string
+ */
+void kmem_string_free(void) {
+  if (!kmem_string_buckets_cached) {
+    return;
+  }
+  for (size_t i = 0; i < KMEM_STRING_BUCKETS; i++) {
+    struct kmem_string *entry = kmem_string_buckets_cached[i];
+    while (entry) {
+      struct kmem_string *next = entry->next;
+      free(entry);
+      entry = next;
+    }
+  }
+  free(kmem_string_buckets_cached);
+  kmem_string_buckets_cached = NULL;
+}
@@ -0,0 +1,313 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_tfp0.c
+ * @author Cryptiiiic
+ * @brief This file is for the kernel task port kernel memory backend.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <errno.h>
+#include <string.h>
+#include <x8A4/Kernel/kmem_file.h>
+#include <x8A4/Kernel/kmem_tfp0.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+const struct kmem_backend kmem_tfp0_backend = {
+  .name = "tfp0",
+  .flags = KMEM_BACKEND_THREAD_SAFE,
+  .kbase = kmem_tfp0_kbase,
+  .kread = kmem_tfp0_kread,
+  .kwrite = kmem_tfp0_kwrite,
+  .physread = NULL,
+  .kcall = NULL,
+  .free = kmem_tfp0_backend_free,
+  .map = kmem_tfp0_map,
+};
+const struct kmem_tfp0_ops *kmem_tfp0_ops_cached = NULL;
+struct kmem_tfp0_mapping kmem_tfp0_mappings_cached[KMEM_TFP0_MAPPING_MAX] = {0};
+size_t kmem_tfp0_mapping_count_cached = 0;
+#ifdef __APPLE__
+mach_port_t kmem_tfp0_port_cached = MACH_PORT_NULL;
+#endif
+
+/* Functions */
+#ifdef __APPLE__
+/**
+ * @brief           Get the kernel base the jailbreak stored in the kernel task's dyld info
+ * @param[out]      addr
+ * @return          Zero on success
+ */
+int kmem_tfp0_mach_kbase(uint64_t *addr) {
+  struct task_dyld_info info = {0};
+  mach_msg_type_number_t count = TASK_DYLD_INFO_COUNT;
+  kern_return_t kr = task_info(kmem_tfp0_port_cached, TASK_DYLD_INFO, (task_info_t)&info, &count);
+  if (kr != KERN_SUCCESS || !info.all_image_info_addr) {
+    return ENOTSUP;
+  }
+  *addr = info.all_image_info_addr;
+  return 0;
+}
+
+/**
+ * @brief           Read kernel memory with the kernel task port
+ * @param[in]       from
+ * @param[out]      to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_tfp0_mach_read(uint64_t from, void *to, size_t len) {
+  mach_vm_size_t out_size = 0;
+  kern_return_t kr = mach_vm_read_overwrite(kmem_tfp0_port_cached, from, len, (mach_vm_address_t)to, &out_size);
+  if (kr != KERN_SUCCESS || out_size != len) {
+    x8A4_log_debug_error("mach_vm_read_overwrite 0x%016llX len: 0x%zX failed: %s\n", from, len, mach_error_string(kr));
+    return EFAULT;
+  }
+  return 0;
+}
+
+/**
+ * @brief           Write kernel memory with the kernel task port
+ * @param[in]       from
+ * @param[in]       to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_tfp0_mach_write(void *from, uint64_t to, size_t len) {
+  kern_return_t kr = mach_vm_write(kmem_tfp0_port_cached, to, (vm_offset_t)from, (mach_msg_type_number_t)len);
+  if (kr != KERN_SUCCESS) {
+    x8A4_log_debug_error("mach_vm_write 0x%016llX len: 0x%zX failed: %s\n", to, len, mach_error_string(kr));
+    return EFAULT;
+  }
+  return 0;
+}
+
+/**
+ * @brief           Share page aligned kernel memory into our address space
+ * @param[in]       addr
+ * @param[in]       len
+ * @param[out]      out
+ * @return          Zero on success
+ */
+int kmem_tfp0_mach_remap(uint64_t addr, size_t len, void **out) {
+  mach_vm_address_t local = 0;
+  vm_prot_t cur_protection = VM_PROT_NONE;
+  vm_prot_t max_protection = VM_PROT_NONE;
+  kern_return_t kr = mach_vm_remap(mach_task_self(), &local, len, 0, VM_FLAGS_ANYWHERE, kmem_tfp0_port_cached, addr, FALSE,
+                                   &cur_protection, &max_protection, VM_INHERIT_NONE);
+  if (kr != KERN_SUCCESS) {
+    x8A4_log_debug_error("mach_vm_remap 0x%016llX len: 0x%zX failed: %s\n", addr, len, mach_error_string(kr));
+    return EFAULT;
+  }
+  *out = (void *)local;
+  return 0;
+}
+
+/**
+ * @brief           Unmap shared kernel memory
+ * @param[in]       local
+ * @param[in]       len
+ */
+void kmem_tfp0_mach_unmap(void *local, size_t len) {
+  mach_vm_deallocate(mach_task_self(), (mach_vm_address_t)local, len);
+}
+
+const struct kmem_tfp0_ops kmem_tfp0_mach_ops = {
+  .name = "mach",
+  .kbase = kmem_tfp0_mach_kbase,
+  .read = kmem_tfp0_mach_read,
+  .write = kmem_tfp0_mach_write,
+  .remap = kmem_tfp0_mach_remap,
+  .unmap = kmem_tfp0_mach_unmap,
+};
+#endif
+
+/**
+ * @brief           Point at the stand-in image instead of mapping kernel memory
+ * @param[in]       addr
+ * @param[in]       len
+ * @param[out]      out
+ * @return          Zero on success
+ */
+int kmem_tfp0_file_remap(uint64_t addr, size_t len, void **out) {
+  const void *local = NULL;
+  int ret = kmem_file_map(addr, len, &local);
+  if (!ret) {
+    *out = (void *)local;
+  }
+  return ret;
+}
+
+/**
+ * @brief           Nothing to unmap for the stand-in image
+ * @param[in]       local
+ * @param[in]       len
+ */
+void kmem_tfp0_file_unmap(void *local, size_t len) {
+}
+
+const struct kmem_tfp0_ops kmem_tfp0_file_ops = {
+  .name = "file",
+  .kbase = kmem_file_kbase,
+  .read = kmem_file_kread,
+  .write = kmem_file_kwrite,
+  .remap = kmem_tfp0_file_remap,
+  .unmap = kmem_tfp0_file_unmap,
+};
+
+/**
+ * @brief           Get the kernel task port and serve kernel memory with it
+ * @return          Zero on success, ENOTSUP if no kernel task port is available
+ */
+int kmem_tfp0_backend_open(void) {
+#ifdef __APPLE__
+  kmem_tfp0_backend_free();
+  mach_port_t port = MACH_PORT_NULL;
+  kern_return_t kr = task_for_pid(mach_task_self(), 0, &port);
+  if (kr != KERN_SUCCESS || !MACH_PORT_VALID(port)) {
+    port = MACH_PORT_NULL;
+    kr = host_get_special_port(mach_host_self(), HOST_LOCAL_NODE, KMEM_TFP0_HOST_SPECIAL_PORT, &port);
+  }
+  if (kr != KERN_SUCCESS || !MACH_PORT_VALID(port)) {
+    x8A4_log_debug_error("No kernel task port available (%s)\n", mach_error_string(kr));
+    return ENOTSUP;
+  }
+  kmem_tfp0_port_cached = port;
+  kmem_tfp0_ops_cached = &kmem_tfp0_mach_ops;
+  x8A4_log_debug("Got kernel task port: 0x%X\n", port);
+  return 0;
+#else
+  return ENOTSUP;
+#endif
+}
+
+/**
+ * @brief           Serve the tfp0 backend from a sparse memory image standing in for the kernel task, for running its
+ *                  read, write and map paths on a device without a kernel task port
+ * @param[in]       path
+ * @return          Zero on success
+ */
+int kmem_tfp0_backend_open_standin(const char *path) {
+  kmem_tfp0_backend_free();
+  int ret = kmem_file_backend_open(path);
+  if (ret) {
+    return ret;
+  }
+  kmem_tfp0_ops_cached = &kmem_tfp0_file_ops;
+  x8A4_log_debug("Using kmem image %s as the kernel task\n", path);
+  return 0;
+}
+
+/**
+ * @brief           Get the kernel base
+ * @param[out]      addr
+ * @return          Zero on success
+ */
+int kmem_tfp0_kbase(uint64_t *addr) {
+  if (!addr) {
+    return EINVAL;
+  }
+  return kmem_tfp0_ops_cached->kbase(addr);
+}
+
+/**
+ * @brief           Find an existing mapping covering a kernel range
+ * @param[in]       addr
+ * @param[in]       len
+ * @return          Local pointer to addr, NULL if no mapping covers the range
+ */
+const void *kmem_tfp0_find_mapping(uint64_t addr, size_t len) {
+  for (size_t i = 0; i < kmem_tfp0_mapping_count_cached; i++) {
+    struct kmem_tfp0_mapping *mapping = &kmem_tfp0_mappings_cached[i];
+    if (addr >= mapping->addr && addr - mapping->addr <= mapping->size && len <= mapping->size - (addr - mapping->addr)) {
+      return (uint8_t *)mapping->local + (addr - mapping->addr);
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief           Read kernel memory from a mapping if one covers it, otherwise in one call over the whole range
+ * @param[in]       from
+ * @param[out]      to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_tfp0_kread(uint64_t from, void *to, size_t len) {
+  const void *local = kmem_tfp0_find_mapping(from, len);
+  if (local) {
+    memcpy(to, local, len);
+    return 0;
+  }
+  return kmem_tfp0_ops_cached->read(from, to, len);
+}
+
+/**
+ * @brief           Write kernel memory
+ * @param[in]       from
+ * @param[in]       to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_tfp0_kwrite(void *from, uint64_t to, size_t len) {
+  return kmem_tfp0_ops_cached->write(from, to, len);
+}
+
+/**
+ * @brief           Map the pages of a kernel range into our address space, reusing earlier mappings
+ * @param[in]       addr
+ * @param[in]       len
+ * @param[out]      out
+ * @return          Zero on success, ENOMEM if the mapping table is full
+ */
+int kmem_tfp0_map(uint64_t addr, size_t len, const void **out) {
+  const void *mapped = kmem_tfp0_find_mapping(addr, len);
+  if (mapped) {
+    *out = mapped;
+    return 0;
+  }
+  if (kmem_tfp0_mapping_count_cached == KMEM_TFP0_MAPPING_MAX) {
+    return ENOMEM;
+  }
+  uint64_t start = addr & KMEM_PAGE_MASK;
+  size_t size = (((addr + len) - start) + KMEM_PAGE_SIZE - 1) & KMEM_PAGE_MASK;
+  void *local = NULL;
+  int ret = kmem_tfp0_ops_cached->remap(start, size, &local);
+  if (ret) {
+    return ret;
+  }
+  kmem_tfp0_mappings_cached[kmem_tfp0_mapping_count_cached++] = (struct kmem_tfp0_mapping){start, size, local};
+  x8A4_log_debug("Mapped kernel 0x%016llX len: 0x%zX at %p\n", start, size, local);
+  *out = (uint8_t *)local + (addr - start);
+  return 0;
+}
+
+/**
+ * @brief           Unmap every mapping and release the kernel task
+ */
+void kmem_tfp0_backend_free(void) {
+  for (size_t i = 0; i < kmem_tfp0_mapping_count_cached; i++) {
+    if (kmem_tfp0_ops_cached) {
+      kmem_tfp0_ops_cached->unmap(kmem_tfp0_mappings_cached[i].local, kmem_tfp0_mappings_cached[i].size);
+    }
+  }
+  memset(kmem_tfp0_mappings_cached, 0, sizeof(kmem_tfp0_mappings_cached));
+  kmem_tfp0_mapping_count_cached = 0;
+  if (kmem_tfp0_ops_cached == &kmem_tfp0_file_ops) {
+    kmem_file_backend_free();
+  }
+#ifdef __APPLE__
+  if (MACH_PORT_VALID(kmem_tfp0_port_cached)) {
+    mach_port_deallocate(mach_task_self(), kmem_tfp0_port_cached);
+  }
+  kmem_tfp0_port_cached = MACH_PORT_NULL;
+#endif
+  kmem_tfp0_ops_cached = NULL;
+}
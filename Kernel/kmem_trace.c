@@ -0,0 +1,647 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kmem_trace.c
+ * @author Cryptiiiic
+ * @brief This file is for recording and replaying kernel memory traffic.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <compression.h>
+#include <errno.h>
+#include <mach/mach_time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <x8A4/Kernel/kmem_trace.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+const struct kmem_backend kmem_trace_record_backend = {
+  .name = "record",
+  .flags = 0,
+  .kbase = kmem_trace_record_kbase,
+  .kread = kmem_trace_record_kread,
+  .kwrite = kmem_trace_record_kwrite,
+  .physread = NULL,
+  .kcall = NULL,
+  .free = kmem_trace_record_free,
+};
+const struct kmem_backend kmem_trace_replay_backend = {
+  .name = "replay",
+  .flags = 0,
+  .kbase = kmem_trace_replay_kbase,
+  .kread = kmem_trace_replay_kread,
+  .kwrite = kmem_trace_replay_kwrite,
+  .physread = NULL,
+  .kcall = NULL,
+  .free = kmem_trace_replay_free,
+};
+struct kmem_trace_stats kmem_trace_stats_cached = {0};
+const struct kmem_backend *kmem_trace_inner_cached = NULL;
+FILE *kmem_trace_file_cached = NULL;
+compression_stream kmem_trace_stream_cached;
+uint8_t *kmem_trace_chunk_cached = NULL;
+size_t kmem_trace_chunk_len_cached = 0;
+uint8_t *kmem_trace_out_cached = NULL;
+uint64_t kmem_trace_kbase_cached = 0;
+uint8_t *kmem_trace_data_cached = NULL;
+struct kmem_trace_entry *kmem_trace_entries_cached = NULL;
+size_t kmem_trace_entry_count_cached = 0;
+struct kmem_trace_page **kmem_trace_pages_cached = NULL;
+size_t kmem_trace_page_count_cached = 0;
+size_t kmem_trace_page_capacity_cached = 0;
+
+/* Functions */
+/**
+ * @brief           Compress and write the staged trace bytes
+ * @param[in]       finalize
+ * @return          Zero on success
+ */
+int kmem_trace_flush(int finalize) {
+  kmem_trace_stream_cached.src_ptr = kmem_trace_chunk_cached;
+  kmem_trace_stream_cached.src_size = kmem_trace_chunk_len_cached;
+  compression_status status = COMPRESSION_STATUS_OK;
+  do {
+    kmem_trace_stream_cached.dst_ptr = kmem_trace_out_cached;
+    kmem_trace_stream_cached.dst_size = KMEM_TRACE_CHUNK_SIZE;
+    status = compression_stream_process(&kmem_trace_stream_cached, finalize ? COMPRESSION_STREAM_FINALIZE : 0);
+    if (status == COMPRESSION_STATUS_ERROR) {
+      x8A4_log_error("Failed to compress kmem trace!\n", "");
+      return EIO;
+    }
+    size_t out_len = KMEM_TRACE_CHUNK_SIZE - kmem_trace_stream_cached.dst_size;
+    if (out_len && fwrite(kmem_trace_out_cached, 1, out_len, kmem_trace_file_cached) != out_len) {
+      x8A4_log_error("Failed to write kmem trace!\n", "");
+      return EIO;
+    }
+  } while (kmem_trace_stream_cached.src_size || (finalize && status != COMPRESSION_STATUS_END) ||
+           (!finalize && !kmem_trace_stream_cached.dst_size));
+  kmem_trace_chunk_len_cached = 0;
+  return 0;
+}
+
+/**
+ * @brief           Stage bytes for the compressed trace
+ * @param[in]       buf
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_trace_append(const void *buf, size_t len) {
+  const uint8_t *in = (const uint8_t *)buf;
+  while (len) {
+    size_t chunk = KMEM_TRACE_CHUNK_SIZE - kmem_trace_chunk_len_cached;
+    if (chunk > len) {
+      chunk = len;
+    }
+    memcpy(&kmem_trace_chunk_cached[kmem_trace_chunk_len_cached], in, chunk);
+    kmem_trace_chunk_len_cached += chunk;
+    in += chunk;
+    len -= chunk;
+    if (kmem_trace_chunk_len_cached == KMEM_TRACE_CHUNK_SIZE && kmem_trace_flush(0)) {
+      return EIO;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief           Append one kernel memory call to the trace
+ * @param[in]       op
+ * @param[in]       addr
+ * @param[in]       buf
+ * @param[in]       len
+ * @param[in]       ret
+ */
+void kmem_trace_log(enum kmem_trace_op op, uint64_t addr, const void *buf, size_t len, int ret) {
+  if (!kmem_trace_file_cached) {
+    return;
+  }
+  struct kmem_trace_record record = {0};
+  record.op = op;
+  record.ret = ret;
+  record.addr = addr;
+  record.len = len;
+  record.timestamp = mach_absolute_time();
+  if (kmem_trace_append(&record, sizeof(struct kmem_trace_record)) ||
+      ((op == KMEM_TRACE_WRITE || !ret) && kmem_trace_append(buf, len))) {
+    x8A4_log_error("Failed to record kmem trace, recording stopped!\n", "");
+    compression_stream_destroy(&kmem_trace_stream_cached);
+    fclose(kmem_trace_file_cached);
+    kmem_trace_file_cached = NULL;
+  }
+}
+
+/**
+ * @brief           Start recording kernel memory traffic of a backend to a trace file
+ * @param[in]       path
+ * @param[in]       inner
+ * @return          Zero on success
+ */
+int kmem_trace_record_open(const char *path, const struct kmem_backend *inner) {
+  if (!path || !inner || !inner->kread) {
+    return EINVAL;
+  }
+  kmem_trace_record_free();
+  kmem_trace_chunk_cached = (uint8_t *)malloc(KMEM_TRACE_CHUNK_SIZE);
+  kmem_trace_out_cached = (uint8_t *)malloc(KMEM_TRACE_CHUNK_SIZE);
+  if (!kmem_trace_chunk_cached || !kmem_trace_out_cached) {
+    x8A4_log_error("Failed to malloc memory for kmem trace!\n", "");
+    kmem_trace_record_free();
+    return ENOMEM;
+  }
+  struct kmem_trace_header header = {0};
+  header.magic = KMEM_TRACE_MAGIC;
+  header.version = KMEM_TRACE_VERSION;
+  if (inner->kbase) {
+    inner->kbase(&header.kbase);
+  }
+  kmem_trace_file_cached = fopen(path, "wb");
+  if (!kmem_trace_file_cached) {
+    x8A4_log_error("Failed to open kmem trace %s (%d)!\n", path, errno);
+    kmem_trace_record_free();
+    return EIO;
+  }
+  if (fwrite(&header, sizeof(struct kmem_trace_header), 1, kmem_trace_file_cached) != 1 ||
+      compression_stream_init(&kmem_trace_stream_cached, COMPRESSION_STREAM_ENCODE, COMPRESSION_LZFSE) != COMPRESSION_STATUS_OK) {
+    x8A4_log_error("Failed to start kmem trace %s!\n", path);
+    fclose(kmem_trace_file_cached);
+    kmem_trace_file_cached = NULL;
+    kmem_trace_record_free();
+    return EIO;
+  }
+  kmem_trace_inner_cached = inner;
+  x8A4_log_debug("Recording kmem backend %s to %s\n", inner->name, path);
+  return 0;
+}
+
+/**
+ * @brief           Get the kernel base from the recorded backend
+ * @param[out]      addr
+ * @return          Zero on success
+ */
+int kmem_trace_record_kbase(uint64_t *addr) {
+  if (!kmem_trace_inner_cached->kbase) {
+    return ENOTSUP;
+  }
+  return kmem_trace_inner_cached->kbase(addr);
+}
+
+/**
+ * @brief           Read kernel memory from the recorded backend and log it
+ * @param[in]       from
+ * @param[out]      to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_trace_record_kread(uint64_t from, void *to, size_t len) {
+  int ret = kmem_trace_inner_cached->kread(from, to, len);
+  kmem_trace_stats_cached.reads++;
+  kmem_trace_stats_cached.read_bytes += len;
+  kmem_trace_log(KMEM_TRACE_READ, from, to, len, ret);
+  return ret;
+}
+
+/**
+ * @brief           Write kernel memory to the recorded backend and log it
+ * @param[in]       from
+ * @param[in]       to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_trace_record_kwrite(void *from, uint64_t to, size_t len) {
+  if (!kmem_trace_inner_cached->kwrite) {
+    return ENOTSUP;
+  }
+  int ret = kmem_trace_inner_cached->kwrite(from, to, len);
+  kmem_trace_stats_cached.writes++;
+  kmem_trace_stats_cached.write_bytes += len;
+  kmem_trace_log(KMEM_TRACE_WRITE, to, from, len, ret);
+  return ret;
+}
+
+/**
+ * @brief           Finish the trace file and free the recorded backend
+ */
+void kmem_trace_record_free(void) {
+  if (kmem_trace_file_cached) {
+    kmem_trace_flush(1);
+    compression_stream_destroy(&kmem_trace_stream_cached);
+    fclose(kmem_trace_file_cached);
+    kmem_trace_file_cached = NULL;
+  }
+  if (kmem_trace_chunk_cached) {
+    free(kmem_trace_chunk_cached);
+    kmem_trace_chunk_cached = NULL;
+  }
+  if (kmem_trace_out_cached) {
+    free(kmem_trace_out_cached);
+    kmem_trace_out_cached = NULL;
+  }
+  kmem_trace_chunk_len_cached = 0;
+  if (kmem_trace_inner_cached) {
+    if (kmem_trace_inner_cached->free) {
+      kmem_trace_inner_cached->free();
+    }
+    kmem_trace_inner_cached = NULL;
+  }
+}
+
+/**
+ * @brief           Order replay entries by call, then by the time they were recorded
+ * @param[in]       a
+ * @param[in]       b
+ * @return          Negative, zero or positive like strcmp
+ */
+int kmem_trace_entry_compare(const void *a, const void *b) {
+  const struct kmem_trace_entry *left = (const struct kmem_trace_entry *)a;
+  const struct kmem_trace_entry *right = (const struct kmem_trace_entry *)b;
+  if (left->op != right->op) {
+    return left->op < right->op ? -1 : 1;
+  }
+  if (left->addr != right->addr) {
+    return left->addr < right->addr ? -1 : 1;
+  }
+  if (left->len != right->len) {
+    return left->len < right->len ? -1 : 1;
+  }
+  if (left->timestamp != right->timestamp) {
+    return left->timestamp < right->timestamp ? -1 : 1;
+  }
+  return left->seq < right->seq ? -1 : (left->seq > right->seq);
+}
+
+/**
+ * @brief           Find the next unanswered record of a call, the last answer repeats once every record is used
+ * @param[in]       op
+ * @param[in]       addr
+ * @param[in]       len
+ * @return          Pointer to the record, NULL if the call was never recorded
+ */
+struct kmem_trace_entry *kmem_trace_match(enum kmem_trace_op op, uint64_t addr, uint64_t len) {
+  struct kmem_trace_entry key = {0};
+  key.op = op;
+  key.addr = addr;
+  key.len = len;
+  size_t lo = 0;
+  size_t hi = kmem_trace_entry_count_cached;
+  while (lo < hi) {
+    size_t mid = lo + ((hi - lo) / 2);
+    if (kmem_trace_entry_compare(&kmem_trace_entries_cached[mid], &key) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  struct kmem_trace_entry *last = NULL;
+  for (size_t i = lo; i < kmem_trace_entry_count_cached; i++) {
+    struct kmem_trace_entry *entry = &kmem_trace_entries_cached[i];
+    if (entry->op != op || entry->addr != addr || entry->len != len) {
+      break;
+    }
+    if (!entry->used) {
+      entry->used = 1;
+      return entry;
+    }
+    last = entry;
+  }
+  if (last) {
+    kmem_trace_stats_cached.repeats++;
+  }
+  return last;
+}
+
+/**
+ * @brief           Find the byte view page for a page aligned kernel address
+ * @param[in]       page_addr
+ * @param[out]      index
+ * @return          Pointer to the page, NULL if no read of the page was recorded
+ */
+struct kmem_trace_page *kmem_trace_find_page(uint64_t page_addr, size_t *index) {
+  size_t lo = 0;
+  size_t hi = kmem_trace_page_count_cached;
+  while (lo < hi) {
+    size_t mid = lo + ((hi - lo) / 2);
+    if (kmem_trace_pages_cached[mid]->addr < page_addr) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (index) {
+    *index = lo;
+  }
+  if (lo < kmem_trace_page_count_cached && kmem_trace_pages_cached[lo]->addr == page_addr) {
+    return kmem_trace_pages_cached[lo];
+  }
+  return NULL;
+}
+
+/**
+ * @brief           Apply the bytes of a successful recorded read to the byte view, later reads win
+ * @param[in]       addr
+ * @param[in]       buf
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_trace_apply(uint64_t addr, const uint8_t *buf, size_t len) {
+  while (len) {
+    uint64_t page_addr = addr & KMEM_PAGE_MASK;
+    size_t index = 0;
+    struct kmem_trace_page *page = kmem_trace_find_page(page_addr, &index);
+    if (!page) {
+      if (kmem_trace_page_count_cached == kmem_trace_page_capacity_cached) {
+        size_t capacity = kmem_trace_page_capacity_cached ? kmem_trace_page_capacity_cached * 2 : 0x40;
+        struct kmem_trace_page **pages = (struct kmem_trace_page **)realloc(kmem_trace_pages_cached, capacity * sizeof(struct kmem_trace_page *));
+        if (!pages) {
+          return ENOMEM;
+        }
+        kmem_trace_pages_cached = pages;
+        kmem_trace_page_capacity_cached = capacity;
+      }
+      page = (struct kmem_trace_page *)calloc(1, sizeof(struct kmem_trace_page));
+      if (!page) {
+        return ENOMEM;
+      }
+      page->addr = page_addr;
+      memmove(&kmem_trace_pages_cached[index + 1], &kmem_trace_pages_cached[index],
+              (kmem_trace_page_count_cached - index) * sizeof(struct kmem_trace_page *));
+      kmem_trace_pages_cached[index] = page;
+      kmem_trace_page_count_cached++;
+    }
+    size_t offset = addr - page_addr;
+    size_t chunk = KMEM_PAGE_SIZE - offset;
+    if (chunk > len) {
+      chunk = len;
+    }
+    memcpy(&page->data[offset], buf, chunk);
+    for (size_t i = offset; i < offset + chunk; i++) {
+      page->valid[i / 8] |= (uint8_t)(1 << (i % 8));
+    }
+    addr += chunk;
+    buf += chunk;
+    len -= chunk;
+  }
+  return 0;
+}
+
+/**
+ * @brief           Read kernel memory from the byte view, every byte must have been seen by a recorded read
+ * @param[in]       from
+ * @param[out]      to
+ * @param[in]       len
+ * @return          Zero on success
+ */
+int kmem_trace_view_read(uint64_t from, uint8_t *to, size_t len) {
+  uint64_t addr = from;
+  while (len) {
+    uint64_t page_addr = addr & KMEM_PAGE_MASK;
+    struct kmem_trace_page *page = kmem_trace_find_page(page_addr, NULL);
+    size_t offset = addr - page_addr;
+    size_t chunk = KMEM_PAGE_SIZE - offset;
+    if (chunk > len) {
+      chunk = len;
+    }
+    for (size_t i = offset; page && i < offset + chunk; i++) {
+      if (!(page->valid[i / 8] & (1 << (i % 8)))) {
+        page = NULL;
+      }
+    }
+    if (!page) {
+      return EFAULT;
+    }
+    memcpy(to, &page->data[offset], chunk);
+    to += chunk;
+    addr += chunk;
+    len -= chunk;
+  }
+  return 0;
+}
+
+/**
+ * @brief           Load a trace file and serve kernel memory from it
+ * @param[in]       path
+ * @return          Zero on success
+ */
+int kmem_trace_replay_open(const char *path) {
+  if (!path) {
+    return EINVAL;
+  }
+  kmem_trace_replay_free();
+  FILE *fp = fopen(path, "rb");
+  if (!fp) {
+    x8A4_log_error("Failed to open kmem trace %s (%d)!\n", path, errno);
+    return EIO;
+  }
+  struct kmem_trace_header header = {0};
+  if (fread(&header, sizeof(struct kmem_trace_header), 1, fp) != 1 ||
+      header.magic != KMEM_TRACE_MAGIC || header.version != KMEM_TRACE_VERSION) {
+    x8A4_log_error("Invalid kmem trace header in %s!\n", path);
+    fclose(fp);
+    return EINVAL;
+  }
+  compression_stream stream;
+  if (compression_stream_init(&stream, COMPRESSION_STREAM_DECODE, COMPRESSION_LZFSE) != COMPRESSION_STATUS_OK) {
+    fclose(fp);
+    return EIO;
+  }
+  uint8_t *in = (uint8_t *)malloc(KMEM_TRACE_CHUNK_SIZE);
+  uint8_t *trace = NULL;
+  size_t trace_len = 0;
+  size_t trace_capacity = 0;
+  int ret = in ? 0 : ENOMEM;
+  compression_status status = COMPRESSION_STATUS_OK;
+  stream.src_size = 0;
+  while (!ret && status == COMPRESSION_STATUS_OK) {
+    if (!stream.src_size) {
+      stream.src_ptr = in;
+      stream.src_size = fread(in, 1, KMEM_TRACE_CHUNK_SIZE, fp);
+    }
+    if (trace_capacity - trace_len < KMEM_TRACE_CHUNK_SIZE) {
+      uint8_t *grown = (uint8_t *)realloc(trace, trace_capacity + (KMEM_TRACE_CHUNK_SIZE * 0x10));
+      if (!grown) {
+        ret = ENOMEM;
+        break;
+      }
+      trace = grown;
+      trace_capacity += KMEM_TRACE_CHUNK_SIZE * 0x10;
+    }
+    stream.dst_ptr = &trace[trace_len];
+    stream.dst_size = trace_capacity - trace_len;
+    status = compression_stream_process(&stream, feof(fp) ? COMPRESSION_STREAM_FINALIZE : 0);
+    trace_len = trace_capacity - stream.dst_size;
+    if (status == COMPRESSION_STATUS_ERROR || (status == COMPRESSION_STATUS_OK && !stream.src_size && feof(fp) && stream.dst_size)) {
+      x8A4_log_error("Failed to decompress kmem trace %s!\n", path);
+      ret = EINVAL;
+    }
+  }
+  compression_stream_destroy(&stream);
+  fclose(fp);
+  if (in) {
+    free(in);
+  }
+  size_t pos = 0;
+  size_t capacity = 0;
+  while (!ret && pos + sizeof(struct kmem_trace_record) <= trace_len) {
+    struct kmem_trace_record record;
+    memcpy(&record, &trace[pos], sizeof(struct kmem_trace_record));
+    pos += sizeof(struct kmem_trace_record);
+    int has_data = record.op == KMEM_TRACE_WRITE || !record.ret;
+    if (has_data && record.len > trace_len - pos) {
+      x8A4_log_error("Truncated kmem trace record at 0x%zX in %s!\n", pos, path);
+      ret = EINVAL;
+      break;
+    }
+    if (kmem_trace_entry_count_cached == capacity) {
+      capacity = capacity ? capacity * 2 : 0x400;
+      struct kmem_trace_entry *entries = (struct kmem_trace_entry *)realloc(kmem_trace_entries_cached, capacity * sizeof(struct kmem_trace_entry));
+      if (!entries) {
+        ret = ENOMEM;
+        break;
+      }
+      kmem_trace_entries_cached = entries;
+    }
+    struct kmem_trace_entry *entry = &kmem_trace_entries_cached[kmem_trace_entry_count_cached];
+    memset(entry, 0, sizeof(struct kmem_trace_entry));
+    entry->op = record.op;
+    entry->ret = record.ret;
+    entry->addr = record.addr;
+    entry->len = record.len;
+    entry->timestamp = record.timestamp;
+    entry->seq = kmem_trace_entry_count_cached;
+    entry->data = has_data ? &trace[pos] : NULL;
+    kmem_trace_entry_count_cached++;
+    if (record.op == KMEM_TRACE_READ && !record.ret) {
+      ret = kmem_trace_apply(record.addr, &trace[pos], record.len);
+    }
+    if (has_data) {
+      pos += record.len;
+    }
+  }
+  kmem_trace_data_cached = trace;
+  if (ret) {
+    kmem_trace_replay_free();
+    return ret;
+  }
+  qsort(kmem_trace_entries_cached, kmem_trace_entry_count_cached, sizeof(struct kmem_trace_entry), kmem_trace_entry_compare);
+  kmem_trace_kbase_cached = header.kbase;
+  x8A4_log_debug("Loaded kmem trace %s records: %zu pages: %zu\n", path, kmem_trace_entry_count_cached, kmem_trace_page_count_cached);
+  return 0;
+}
+
+/**
+ * @brief           Get the kernel base recorded in the trace
+ * @param[out]      addr
+ * @return          Zero on success
+ */
+int kmem_trace_replay_kbase(uint64_t *addr) {
+  if (!addr) {
+    return EINVAL;
+  }
+  if (!kmem_trace_kbase_cached) {
+    return ENOTSUP;
+  }
+  *addr = kmem_trace_kbase_cached;
+  return 0;
+}
+
+/**
+ * @brief           Answer a kernel memory read with the recorded result of the same call, or from the bytes of other
+ *                  recorded reads when the call itself was never recorded
+ * @param[in]       from
+ * @param[out]      to
+ * @param[in]       len
+ * @return          Recorded result
+ */
+int kmem_trace_replay_kread(uint64_t from, void *to, size_t len) {
+  if (!to || !len || from + len < from) {
+    return EINVAL;
+  }
+  kmem_trace_stats_cached.reads++;
+  kmem_trace_stats_cached.read_bytes += len;
+  struct kmem_trace_entry *entry = kmem_trace_match(KMEM_TRACE_READ, from, len);
+  if (!entry && !kmem_trace_view_read(from, (uint8_t *)to, len)) {
+    kmem_trace_stats_cached.views++;
+    return 0;
+  }
+  if (!entry) {
+    kmem_trace_stats_cached.misses++;
+    x8A4_log_debug_error("kmem trace has no read of 0x%016llX-0x%016llX\n", from, from + len);
+    return EFAULT;
+  }
+  if (!entry->ret) {
+    memcpy(to, entry->data, len);
+  }
+  return entry->ret;
+}
+
+/**
+ * @brief           Answer a kernel memory write with the recorded result of the same call
+ * @param[in]       from
+ * @param[in]       to
+ * @param[in]       len
+ * @return          Recorded result
+ */
+int kmem_trace_replay_kwrite(void *from, uint64_t to, size_t len) {
+  if (!from || !len || to + len < to) {
+    return EINVAL;
+  }
+  kmem_trace_stats_cached.writes++;
+  kmem_trace_stats_cached.write_bytes += len;
+  struct kmem_trace_entry *entry = kmem_trace_match(KMEM_TRACE_WRITE, to, len);
+  if (!entry) {
+    kmem_trace_stats_cached.misses++;
+    x8A4_log_debug_error("kmem trace has no write of 0x%016llX-0x%016llX\n", to, to + len);
+    return EFAULT;
+  }
+  if (memcmp(from, entry->data, len)) {
+    x8A4_log_debug_error("kmem trace write of 0x%016llX-0x%016llX differs from the recording\n", to, to + len);
+  }
+  return entry->ret;
+}
+
+/**
+ * @brief           Free the replayed trace
+ */
+void kmem_trace_replay_free(void) {
+  if (kmem_trace_entries_cached) {
+    x8A4_log_debug("kmem replay reads: %llu (%llu bytes) writes: %llu (%llu bytes) misses: %llu repeats: %llu views: %llu\n",
+                   kmem_trace_stats_cached.reads, kmem_trace_stats_cached.read_bytes,
+                   kmem_trace_stats_cached.writes, kmem_trace_stats_cached.write_bytes,
+                   kmem_trace_stats_cached.misses, kmem_trace_stats_cached.repeats, kmem_trace_stats_cached.views);
+    free(kmem_trace_entries_cached);
+    kmem_trace_entries_cached = NULL;
+  }
+  if (kmem_trace_pages_cached) {
+    for (size_t i = 0; i < kmem_trace_page_count_cached; i++) {
+      free(kmem_trace_pages_cached[i]);
+    }
+    free(kmem_trace_pages_cached);
+    kmem_trace_pages_cached = NULL;
+  }
+  kmem_trace_page_count_cached = 0;
+  kmem_trace_page_capacity_cached = 0;
+  if (kmem_trace_data_cached) {
+    free(kmem_trace_data_cached);
+    kmem_trace_data_cached = NULL;
+  }
+  kmem_trace_entry_count_cached = 0;
+  kmem_trace_kbase_cached = 0;
+}
+
+/**
+ * @brief           Get the record/replay traffic counters
+ * @param[out]      stats
+ */
+void kmem_trace_get_stats(struct kmem_trace_stats *stats) {
+  if (!stats) {
+    return;
+  }
+  memcpy(stats, &kmem_trace_stats_cached, sizeof(struct kmem_trace_stats));
+}
@@ -0,0 +1,325 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kpager.c
+ * @author Cryptiiiic
+ * @brief This file is for reading an uncompressed kernelcache lazily through a capped page cache.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <x8A4/Kernel/kcache.h>
+#include <x8A4/Kernel/kernel.h>
+#include <x8A4/Kernel/kpager.h>
+#include <x8A4/Kernel/kpf_cache.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+Fat *kpager_fileset_fat_cached = NULL;
+MachO *kpager_fileset_macho_cached = NULL;
+struct kpager *kpager_fileset_pager_cached = NULL;
+
+/* Functions */
+/**
+ * @brief           Get the page cache cap from its environment variable or the default, at least one page
+ * @return          Cap in bytes
+ */
+size_t kpager_cap(void) {
+  const char *env = getenv(KPAGER_CAP_ENV);
+  size_t cap = env ? (size_t)strtoull(env, NULL, 0) : KPAGER_CAP_DEFAULT;
+  return cap < KPAGER_PAGE_SIZE ? KPAGER_PAGE_SIZE : cap;
+}
+
+/**
+ * @brief           Get the page at a page aligned file offset, reading it over the least recently used page at the cap.
+ *                  The pager lock must be held
+ * @param[in]       pager
+ * @param[in]       offset
+ * @return          Page, NULL on read failure
+ */
+struct kpager_page *kpager_page_get(struct kpager *pager, uint64_t offset) {
+  struct kpager_page *page = NULL;
+  if (pager->last < pager->pages_count && pager->pages[pager->last].offset == offset) {
+    page = &pager->pages[pager->last];
+  }
+  for (size_t i = 0; i < pager->pages_count && !page; i++) {
+    if (pager->pages[i].offset == offset) {
+      page = &pager->pages[i];
+    }
+  }
+  if (page) {
+    pager->stats.hits++;
+    page->last_use = ++pager->clock;
+    pager->last = page - pager->pages;
+    return page;
+  }
+  if (pager->pages_count < pager->pages_max) {
+    uint8_t *data = (uint8_t *)malloc(KPAGER_PAGE_SIZE);
+    if (!data) {
+      return NULL;
+    }
+    page = &pager->pages[pager->pages_count++];
+    page->data = data;
+  } else {
+    page = &pager->pages[0];
+    for (size_t i = 1; i < pager->pages_count; i++) {
+      if (pager->pages[i].last_use < page->last_use) {
+        page = &pager->pages[i];
+      }
+    }
+    pager->stats.evictions++;
+  }
+  size_t len = pager->size - offset < KPAGER_PAGE_SIZE ? pager->size - offset : KPAGER_PAGE_SIZE;
+  if (pread(pager->fd, page->data, len, (off_t)offset) != (ssize_t)len) {
+    x8A4_log_error("Failed to page in kernelcache at 0x%llX (%d:%s)!\n", offset, errno, strerror(errno));
+    page->offset = UINT64_MAX;
+    page->last_use = 0;
+    return NULL;
+  }
+  pager->stats.misses++;
+  page->offset = offset;
+  page->last_use = ++pager->clock;
+  pager->last = page - pager->pages;
+  return page;
+}
+
+/**
+ * @brief           MemoryStream read through the page cache
+ * @param[in]       stream
+ * @param[in]       offset
+ * @param[in]       size
+ * @param[out]      outBuf
+ * @return          Zero on success
+ */
+int kpager_stream_read(MemoryStream *stream, uint64_t offset, size_t size, void *outBuf) {
+  struct kpager *pager = (struct kpager *)stream->context;
+  if (offset > pager->size || size > pager->size - offset) {
+    return -1;
+  }
+  int ret = 0;
+  uint8_t *out = (uint8_t *)outBuf;
+  pthread_mutex_lock(&pager->lock);
+  while (size && !ret) {
+    uint64_t page_offset = offset & ~(uint64_t)(KPAGER_PAGE_SIZE - 1);
+    size_t in_page = (size_t)(offset - page_offset);
+    size_t len = KPAGER_PAGE_SIZE - in_page < size ? KPAGER_PAGE_SIZE - in_page : size;
+    struct kpager_page *page = kpager_page_get(pager, page_offset);
+    if (!page) {
+      ret = -1;
+      continue;
+    }
+    memcpy(out, page->data + in_page, len);
+    out += len;
+    offset += len;
+    size -= len;
+  }
+  pthread_mutex_unlock(&pager->lock);
+  return ret;
+}
+
+/**
+ * @brief           MemoryStream write, the pager is read only
+ * @param[in]       stream
+ * @param[in]       offset
+ * @param[in]       size
+ * @param[in]       inBuf
+ * @return          -1
+ */
+int kpager_stream_write(MemoryStream *stream, uint64_t offset, size_t size, const void *inBuf) {
+  return -1;
+}
+
+/**
+ * @brief           MemoryStream size of the paged file
+ * @param[in]       stream
+ * @param[out]      sizeOut
+ * @return          Zero
+ */
+int kpager_stream_get_size(MemoryStream *stream, size_t *sizeOut) {
+  *sizeOut = ((struct kpager *)stream->context)->size;
+  return 0;
+}
+
+/**
+ * @brief           MemoryStream raw pointer, there is none since nothing is mapped as a whole
+ * @param[in]       stream
+ * @return          NULL
+ */
+uint8_t *kpager_stream_get_raw_ptr(MemoryStream *stream) {
+  return NULL;
+}
+
+/**
+ * @brief           MemoryStream soft clone sharing the page cache
+ * @param[in]       stream
+ * @return          Clone, NULL on failure
+ */
+MemoryStream *kpager_stream_softclone(MemoryStream *stream) {
+  MemoryStream *clone = (MemoryStream *)malloc(sizeof(MemoryStream));
+  if (!clone) {
+    return NULL;
+  }
+  *clone = *stream;
+  struct kpager *pager = (struct kpager *)stream->context;
+  pthread_mutex_lock(&pager->lock);
+  pager->refs++;
+  pthread_mutex_unlock(&pager->lock);
+  return clone;
+}
+
+/**
+ * @brief           MemoryStream free, the pages go with the last clone
+ * @param[in]       stream
+ */
+void kpager_stream_free(MemoryStream *stream) {
+  struct kpager *pager = (struct kpager *)stream->context;
+  pthread_mutex_lock(&pager->lock);
+  int refs = --pager->refs;
+  pthread_mutex_unlock(&pager->lock);
+  if (!refs) {
+    x8A4_log_debug("kpager: %llu hits, %llu misses, %llu evictions\n", pager->stats.hits, pager->stats.misses, pager->stats.evictions);
+    for (size_t i = 0; i < pager->pages_count; i++) {
+      free(pager->pages[i].data);
+    }
+    free(pager->pages);
+    close(pager->fd);
+    pthread_mutex_destroy(&pager->lock);
+    if (kpager_fileset_pager_cached == pager) {
+      kpager_fileset_pager_cached = NULL;
+    }
+    free(pager);
+  }
+  free(stream);
+}
+
+/**
+ * @brief           Open a file as a read only MemoryStream that keeps at most cap bytes of it in memory
+ * @param[in]       path
+ * @param[in]       cap
+ * @return          Stream, NULL on failure
+ */
+MemoryStream *kpager_stream_init(const char *path, size_t cap) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    x8A4_log_debug("Failed to open %s for paging (%d:%s)\n", path, errno, strerror(errno));
+    return NULL;
+  }
+  struct stat st = {0};
+  MemoryStream *stream = (MemoryStream *)calloc(1, sizeof(MemoryStream));
+  struct kpager *pager = (struct kpager *)calloc(1, sizeof(struct kpager));
+  size_t pages_max = cap / KPAGER_PAGE_SIZE ? cap / KPAGER_PAGE_SIZE : 1;
+  struct kpager_page *pages = (struct kpager_page *)calloc(pages_max, sizeof(struct kpager_page));
+  if (fstat(fd, &st) || !st.st_size || !stream || !pager || !pages) {
+    x8A4_log_error("Failed to set up pager for %s!\n", path);
+    close(fd);
+    free(stream);
+    free(pager);
+    free(pages);
+    return NULL;
+  }
+  pthread_mutex_init(&pager->lock, NULL);
+  pager->fd = fd;
+  pager->size = (size_t)st.st_size;
+  pager->pages = pages;
+  pager->pages_max = pages_max;
+  pager->refs = 1;
+  stream->context = pager;
+  stream->read = kpager_stream_read;
+  stream->write = kpager_stream_write;
+  stream->getSize = kpager_stream_get_size;
+  stream->getRawPtr = kpager_stream_get_raw_ptr;
+  stream->softclone = kpager_stream_softclone;
+  stream->free = kpager_stream_free;
+  return stream;
+}
+
+/**
+ * @brief           Get the uncompressed kernelcache to page from its environment variable, the decompressed kernelcache
+ *                  cache or the booted kernel path
+ * @return          Path, NULL if unknown
+ */
+const char *kpager_kernel_path(void) {
+  const char *path = getenv(KPAGER_KERNEL_ENV);
+  if (!path || !path[0]) {
+    path = kcache_lookup();
+  }
+  return path ? path : get_kernel_path();
+}
+
+/**
+ * @brief           Parse only the header and fileset entries of an uncompressed fileset kernelcache, section data is
+ *                  paged in on demand
+ * @param[in]       path
+ * @return          Zero on success, -1 if the file is compressed or not a fileset
+ */
+int kpager_fileset_open(const char *path) {
+  kpf_lock();
+  int ret = 0;
+  if (!kpager_fileset_macho_cached) {
+    ret = -1;
+    MemoryStream *stream = path ? kpager_stream_init(path, kpager_cap()) : NULL;
+    uint32_t magic = 0;
+    if (stream && (memory_stream_read(stream, 0, sizeof(magic), &magic) || magic != MH_MAGIC_64)) {
+      x8A4_log_debug("%s is not an uncompressed kernelcache, not paging it\n", path);
+      memory_stream_free(stream);
+      stream = NULL;
+    }
+    struct kpager *pager = stream ? (struct kpager *)stream->context : NULL;
+    Fat *fat = stream ? fat_init_from_memory_stream(stream) : NULL;
+    MachO *macho = fat ? fat_get_single_slice(fat) : NULL;
+    if (macho && macho->filesetCount) {
+      kpager_fileset_fat_cached = fat;
+      kpager_fileset_macho_cached = macho;
+      kpager_fileset_pager_cached = pager;
+      x8A4_log_debug("Paging %u fileset entries of %s through %zu pages\n", macho->filesetCount, path, pager->pages_max);
+      ret = 0;
+    } else if (fat) {
+      fat_free(fat);
+    }
+  }
+  kpf_unlock();
+  return ret;
+}
+
+/**
+ * @brief           Get a section of a fileset entry from the paged kernelcache
+ * @param[in]       filesetEntryId
+ * @param[in]       segName
+ * @param[in]       sectName
+ * @return          Section, NULL if the kernelcache is not paged or has no such section
+ */
+PFSection *kpager_fileset_section(const char *filesetEntryId, const char *segName, const char *sectName) {
+  if (!kpager_fileset_macho_cached) {
+    return NULL;
+  }
+  PFSection *section = pfsec_init_from_macho(kpager_fileset_macho_cached, filesetEntryId, segName, sectName);
+  if (section) {
+    pfsec_set_pointer_decoder(section, xpfsec_decode_pointer);
+  }
+  return section;
+}
+
+/**
+ * @brief           Drop the paged kernelcache, its sections must be freed first
+ */
+void kpager_fileset_close(void) {
+  kpf_lock();
+  if (kpager_fileset_fat_cached) {
+    fat_free(kpager_fileset_fat_cached);
+  }
+  kpager_fileset_fat_cached = NULL;
+  kpager_fileset_macho_cached = NULL;
+  kpager_fileset_pager_cached = NULL;
+  kpf_unlock();
+}
@@ -14,7 +14,12 @@
 
 /* Include Headers */
 #include <x8A4/Kernel/nvram.h>
+#include <x8A4/Kernel/kernel.h>
 #include <x8A4/Kernel/kpf.h>
+#include <x8A4/Kernel/kpager.h>
+#include <x8A4/Kernel/kpf_cache.h>
+#include <x8A4/Kernel/kpf_scan.h>
+#include <x8A4/Kernel/kpf_xref.h>
 #include <x8A4/Logger/logger.h>
 #include <x8A4/x8A4.h>
 
@@ -24,40 +29,96 @@ PFSection *apple_image4_fileset_sections[3] = {0};
 /* Cached Variables */
 uint64_t kpf_nonce_domains_cached = 0;
 int kpf_nonce_domains_length_cached = 0;
+uint64_t kpf_registry_root_candidates_cached[KPF_REGISTRY_ROOT_CANDIDATES_MAX] = {0};
+int kpf_registry_root_candidates_count_cached = 0;
+struct kpf_img4_sections kpf_img4_sections_cached = {0};
+struct kpf_scan_target kpf_img4_targets_cached[KPF_IMG4_TARGETS_COUNT] = {
+  [KPF_IMG4_TARGET_KRN] = {kAppleSystemVarGUID"krn.", 0, {0}, 1, 0},
+  [KPF_IMG4_TARGET_NONCE_DOMAIN] = {"invalid nonce domain: %llu", 0, {0}, 1, 0},
+};
+int kpf_img4_scan_done_cached = 0;
 
 /* Functions */
 /**
- * @brief           Sets up XPF fileset kernel sections for the IMG4 Kext
+ * @brief           Sets up XPF fileset kernel sections for the IMG4 Kext, from the paged kernelcache when XPF is not running
  * @return          Zero on success
  */
 int xpf_setup_fileset_sections(void) {
+  int ret = 0;
+  kpf_lock();
   if (gXPF.kernelIsFileset &&
       !(apple_image4_fileset_sections[0] && apple_image4_fileset_sections[1] &&
         apple_image4_fileset_sections[2])) {
-    apple_image4_fileset_sections[0] = xpf_pfsec_init("com.apple.security.AppleImage4", "__TEXT_EXEC", "__text");
-    apple_image4_fileset_sections[1] = xpf_pfsec_init("com.apple.security.AppleImage4", "__DATA_CONST", "__const");
-    apple_image4_fileset_sections[2] = xpf_pfsec_init("com.apple.security.AppleImage4", "__TEXT", "__cstring");
-    return (apple_image4_fileset_sections[0] &&
-            apple_image4_fileset_sections[1] &&
-            apple_image4_fileset_sections[2])
-               ? 0
-               : -1;
-  }
-  return 0;
+    PFSection *(*pfsec_init)(const char *, const char *, const char *) = gXPF.kernel ? xpf_pfsec_init : kpager_fileset_section;
+    apple_image4_fileset_sections[0] = pfsec_init("com.apple.security.AppleImage4", "__TEXT_EXEC", "__text");
+    apple_image4_fileset_sections[1] = pfsec_init("com.apple.security.AppleImage4", "__DATA_CONST", "__const");
+    apple_image4_fileset_sections[2] = pfsec_init("com.apple.security.AppleImage4", "__TEXT", "__cstring");
+    ret = (apple_image4_fileset_sections[0] &&
+           apple_image4_fileset_sections[1] &&
+           apple_image4_fileset_sections[2])
+              ? 0
+              : -1;
+  }
+  kpf_unlock();
+  return ret;
 }
 
 /**
  * @brief           Frees XPF fileset kernel sections for the IMG4 Kext
  */
 void xpf_free_fileset_sections(void) {
-  if (gXPF.kernelIsFileset) {
-    if (apple_image4_fileset_sections[0])
-      pfsec_free(apple_image4_fileset_sections[0]);
-    if (apple_image4_fileset_sections[1])
-      pfsec_free(apple_image4_fileset_sections[1]);
-    if (apple_image4_fileset_sections[2])
-      pfsec_free(apple_image4_fileset_sections[2]);
+  if (apple_image4_fileset_sections[0])
+    pfsec_free(apple_image4_fileset_sections[0]);
+  if (apple_image4_fileset_sections[1])
+    pfsec_free(apple_image4_fileset_sections[1]);
+  if (apple_image4_fileset_sections[2])
+    pfsec_free(apple_image4_fileset_sections[2]);
+  memset(apple_image4_fileset_sections, 0, sizeof(apple_image4_fileset_sections));
+  memset(&kpf_img4_sections_cached, 0, sizeof(kpf_img4_sections_cached));
+  kpf_scan_reset(kpf_img4_targets_cached, KPF_IMG4_TARGETS_COUNT);
+  kpf_img4_scan_done_cached = 0;
+}
+
+/**
+ * @brief           Resolve the IMG4 Kext text, const and cstring sections once for the fileset, prelinked or plain kernel
+ * @return          Zero on success
+ */
+int xpf_setup_img4_sections(void) {
+  kpf_lock();
+  if (!kpf_img4_sections_cached.text) {
+    if (gXPF.kernelIsFileset) {
+      if (!xpf_setup_fileset_sections()) {
+        kpf_img4_sections_cached = (struct kpf_img4_sections){apple_image4_fileset_sections[0], apple_image4_fileset_sections[1], apple_image4_fileset_sections[2]};
+      }
+    } else if (strcmp(gXPF.darwinVersion, "22.0.0") >= 0) {
+      kpf_img4_sections_cached = (struct kpf_img4_sections){gXPF.kernelPLKTextSection, gXPF.kernelPLKDataConstSection, gXPF.kernelPrelinkTextSection};
+    } else {
+      kpf_img4_sections_cached = (struct kpf_img4_sections){gXPF.kernelTextSection, gXPF.kernelDataConstSection, gXPF.kernelStringSection};
+    }
+    if (!kpf_img4_sections_cached.text || !kpf_img4_sections_cached.cstring) {
+      x8A4_log_error("Failed to setup kernel sections!\n", "");
+      memset(&kpf_img4_sections_cached, 0, sizeof(kpf_img4_sections_cached));
+    }
   }
+  int ret = kpf_img4_sections_cached.text ? 0 : -1;
+  kpf_unlock();
+  return ret;
+}
+
+/**
+ * @brief           Find every IMG4 Kext string the finders need, then their references, in one pass over each section
+ * @return          Zero once scanned, missing targets are left zero for the finders to report
+ */
+int xpf_scan_img4_targets(void) {
+  kpf_lock();
+  if (!kpf_img4_scan_done_cached && !xpf_setup_img4_sections()) {
+    kpf_scan_strings(kpf_img4_sections_cached.cstring, kpf_img4_targets_cached, KPF_IMG4_TARGETS_COUNT);
+    kpf_xref_index_scan(kpf_img4_sections_cached.text, kpf_img4_targets_cached, KPF_IMG4_TARGETS_COUNT);
+    kpf_img4_scan_done_cached = 1;
+  }
+  int ret = kpf_img4_scan_done_cached ? 0 : -1;
+  kpf_unlock();
+  return ret;
 }
 
 
@@ -65,72 +126,31 @@ void xpf_free_fileset_sections(void) {
  * @brief           XPF Kernel patchfind the nonce slots array
  * @return          Address of nonce slots array
  */
-uint64_t xpf_find_nonce_slots_array(void) {
+uint64_t xpf_find_nonce_slots_array_scan(void) {
   if(strcmp(gXPF.darwinVersion, "23.0.0") < 0 && !nonce_slot_format_cached) {
     return 0;
   }
-  PFSection *kernel_security_appleimage4_text_section = NULL;
-  PFSection *kernel_security_appleimage4_dataconst_section = NULL;
-  PFSection *kernel_security_appleimage4_string_section = NULL;
-  if (gXPF.kernelIsFileset) {
-    if (xpf_setup_fileset_sections()) {
-      return 0;
-    }
-    kernel_security_appleimage4_text_section = apple_image4_fileset_sections[0];
-    kernel_security_appleimage4_dataconst_section = apple_image4_fileset_sections[1];
-    kernel_security_appleimage4_string_section = apple_image4_fileset_sections[2];
-  } else {
-    if (strcmp(gXPF.darwinVersion, "22.0.0") >= 0) {
-      kernel_security_appleimage4_text_section = gXPF.kernelPLKTextSection;
-      kernel_security_appleimage4_dataconst_section = gXPF.kernelPLKTextSection;
-      kernel_security_appleimage4_string_section =
-          gXPF.kernelPrelinkTextSection;
-    } else {
-      kernel_security_appleimage4_text_section = gXPF.kernelTextSection;
-      kernel_security_appleimage4_dataconst_section = gXPF.kernelTextSection;
-      kernel_security_appleimage4_string_section = gXPF.kernelStringSection;
-    }
-  }
-  if (!kernel_security_appleimage4_text_section ||
-      !kernel_security_appleimage4_dataconst_section ||
-      !kernel_security_appleimage4_string_section) {
-    x8A4_log_error("Failed to setup kernel sections!\n", "");
+  if (xpf_setup_img4_sections()) {
     return 0;
   }
+  PFSection *kernel_security_appleimage4_text_section = kpf_img4_sections_cached.text;
   if (kpf_nonce_domains_cached) {
     return pfsec_arm64_resolve_adrp_ldr_str_add_reference_auto(
         kernel_security_appleimage4_text_section, kpf_nonce_domains_cached + 4);
   }
-  PFStringMetric *krn_metric =
-      pfmetric_string_init(kAppleSystemVarGUID"krn.");
-  if (!krn_metric) {
-    x8A4_log_error("Failed to pfmetric_string_init for \""kAppleSystemVarGUID"krn.""\" string!\n", "");
+  if (xpf_scan_img4_targets()) {
     return 0;
   }
-  __block uint64_t krn_addr = 0;
-  pfmetric_run(kernel_security_appleimage4_string_section, krn_metric,
-               ^(uint64_t vmaddr, bool *stop) {
-                 krn_addr = vmaddr;
-                 *stop = true;
-               });
-  pfmetric_free(krn_metric);
-  if (!krn_addr) {
+  const struct kpf_scan_target *krn = &kpf_img4_targets_cached[KPF_IMG4_TARGET_KRN];
+  if (!krn->vmaddr) {
     x8A4_log_error("Failed to find \""kAppleSystemVarGUID"krn.""\" string!\n", "");
     return 0;
   }
-  PFXrefMetric *krn_xref_metric =
-      pfmetric_xref_init(krn_addr, XREF_TYPE_MASK_REFERENCE);
-  __block uint64_t krn_ref = 0;
-  pfmetric_run(kernel_security_appleimage4_text_section,
-               krn_xref_metric, ^(uint64_t vmaddr, bool *stop) {
-                 krn_ref = vmaddr;
-                 *stop = true;
-               });
-  pfmetric_free(krn_xref_metric);
-  if (!krn_ref) {
+  if (!krn->refs_count) {
     x8A4_log_error("Failed to find \""kAppleSystemVarGUID"krn.""\" string reference!\n", "");
     return 0;
   }
+  uint64_t krn_ref = krn->refs[0];
   uint32_t adrp_any_inst = 0, adrp_any_mask = 0;
   arm64_gen_adr_p(OPT_BOOL(true), OPT_UINT64_NONE, OPT_UINT64_NONE,
                   ARM64_REG_ANY, &adrp_any_inst, &adrp_any_mask);
@@ -151,77 +171,53 @@ uint64_t xpf_find_nonce_slots_array(void) {
   return nonce_domains;
 }
 
+/**
+ * @brief           Get the nonce slots array through the kpf cache
+ * @return          Address of nonce slots array
+ */
+uint64_t xpf_find_nonce_slots_array(void) {
+  kpf_lock();
+  uint64_t value = 0;
+  if (kpf_cache_get(KPF_CACHE_NONCE_SLOTS_ARRAY, &value) && !xpf_require_img4()) {
+    value = xpf_find_nonce_slots_array_scan();
+    if (value) {
+      kpf_cache_put(KPF_CACHE_NONCE_SLOTS_ARRAY, value);
+    }
+  }
+  kpf_unlock();
+  return value;
+}
+
 /**
  * @brief           XPF Kernel patchfind the nonce domains array
  * @return          Address of nonce domains array
  */
-uint64_t xpf_find_nonce_domains_array(void) {
+uint64_t xpf_find_nonce_domains_array_scan(void) {
   if(strcmp(gXPF.darwinVersion, "23.0.0") >= 0 && nonce_slot_format_cached == 1) {
     return xpf_find_nonce_slots_array();
   }
-  PFSection *kernel_security_appleimage4_text_section = NULL;
-  PFSection *kernel_security_appleimage4_dataconst_section = NULL;
-  PFSection *kernel_security_appleimage4_string_section = NULL;
-  if (gXPF.kernelIsFileset) {
-    if (xpf_setup_fileset_sections()) {
-      return 0;
-    }
-    kernel_security_appleimage4_text_section = apple_image4_fileset_sections[0];
-    kernel_security_appleimage4_dataconst_section = apple_image4_fileset_sections[1];
-    kernel_security_appleimage4_string_section = apple_image4_fileset_sections[2];
-  } else {
-    if (strcmp(gXPF.darwinVersion, "22.0.0") >= 0) {
-      kernel_security_appleimage4_text_section = gXPF.kernelPLKTextSection;
-      kernel_security_appleimage4_dataconst_section = gXPF.kernelPLKTextSection;
-      kernel_security_appleimage4_string_section =
-          gXPF.kernelPrelinkTextSection;
-    } else {
-      kernel_security_appleimage4_text_section = gXPF.kernelTextSection;
-      kernel_security_appleimage4_dataconst_section = gXPF.kernelTextSection;
-      kernel_security_appleimage4_string_section = gXPF.kernelStringSection;
-    }
-  }
-  if (!kernel_security_appleimage4_text_section ||
-      !kernel_security_appleimage4_dataconst_section ||
-      !kernel_security_appleimage4_string_section) {
-    x8A4_log_error("Failed to setup kernel sections!\n", "");
+  if (xpf_setup_img4_sections()) {
     return 0;
   }
+  PFSection *kernel_security_appleimage4_text_section = kpf_img4_sections_cached.text;
   if (kpf_nonce_domains_cached) {
     return kpf_nonce_domains_cached;
 //    return pfsec_arm64_resolve_adrp_ldr_str_add_reference_auto(
 //        kernel_security_appleimage4_text_section, kpf_nonce_domains_cached + 4);
   }
-  PFStringMetric *nonce_domain_metric =
-      pfmetric_string_init("invalid nonce domain: %llu");
-  if (!nonce_domain_metric) {
-    x8A4_log_error("Failed to pfmetric_string_init for nonce domain string!\n", "");
+  if (xpf_scan_img4_targets()) {
     return 0;
   }
-  __block uint64_t nonce_domain_addr = 0;
-  pfmetric_run(kernel_security_appleimage4_string_section, nonce_domain_metric,
-               ^(uint64_t vmaddr, bool *stop) {
-                 nonce_domain_addr = vmaddr;
-                 *stop = true;
-               });
-  pfmetric_free(nonce_domain_metric);
-  if (!nonce_domain_addr) {
+  const struct kpf_scan_target *nonce_domain = &kpf_img4_targets_cached[KPF_IMG4_TARGET_NONCE_DOMAIN];
+  if (!nonce_domain->vmaddr) {
     x8A4_log_debug_error("Failed to find nonce domain string!\n", "");
     return 0;
   }
-  PFXrefMetric *nonce_domain_xref_metric =
-      pfmetric_xref_init(nonce_domain_addr, XREF_TYPE_MASK_REFERENCE);
-  __block uint64_t nonce_domain_ref = 0;
-  pfmetric_run(kernel_security_appleimage4_text_section,
-               nonce_domain_xref_metric, ^(uint64_t vmaddr, bool *stop) {
-                 nonce_domain_ref = vmaddr;
-                 *stop = true;
-               });
-  pfmetric_free(nonce_domain_xref_metric);
-  if (!nonce_domain_ref) {
+  if (!nonce_domain->refs_count) {
     x8A4_log_error("Failed to find nonce domain string reference!\n", "");
     return 0;
   }
+  uint64_t nonce_domain_ref = nonce_domain->refs[0];
   uint32_t adrp_any_inst = 0, adrp_any_mask = 0;
   arm64_gen_adr_p(OPT_BOOL(true), OPT_UINT64_NONE, OPT_UINT64_NONE,
                   ARM64_REG_ANY, &adrp_any_inst, &adrp_any_mask);
@@ -243,50 +239,64 @@ uint64_t xpf_find_nonce_domains_array(void) {
 }
 
 /**
- * @brief           XPF Kernel patchfind the nonce slots array length
- * @return          Length of the nonce domains array
+ * @brief           Get the nonce domains array through the kpf cache
+ * @return          Address of nonce domains array
  */
-int xpf_find_nonce_slots_array_length(void) {
-  if(strcmp(gXPF.darwinVersion, "23.0.0") < 0 && !nonce_slot_format_cached) {
-    return 0;
+uint64_t xpf_find_nonce_domains_array(void) {
+  if(strcmp(gXPF.darwinVersion, "23.0.0") >= 0 && nonce_slot_format_cached == 1) {
+    return xpf_find_nonce_slots_array();
   }
-  PFSection *kernel_security_appleimage4_text_section = NULL;
-  PFSection *kernel_security_appleimage4_dataconst_section = NULL;
-  PFSection *kernel_security_appleimage4_string_section = NULL;
-  if (gXPF.kernelIsFileset) {
-    if (xpf_setup_fileset_sections()) {
-      return 0;
-    }
-    kernel_security_appleimage4_text_section = apple_image4_fileset_sections[0];
-    kernel_security_appleimage4_dataconst_section = apple_image4_fileset_sections[1];
-    kernel_security_appleimage4_string_section = apple_image4_fileset_sections[2];
-  } else {
-    if (strcmp(gXPF.darwinVersion, "22.0.0") >= 0) {
-      kernel_security_appleimage4_text_section = gXPF.kernelPLKTextSection;
-      kernel_security_appleimage4_dataconst_section = gXPF.kernelPLKTextSection;
-      kernel_security_appleimage4_string_section =
-          gXPF.kernelPrelinkTextSection;
-    } else {
-      kernel_security_appleimage4_text_section = gXPF.kernelTextSection;
-      kernel_security_appleimage4_dataconst_section = gXPF.kernelTextSection;
-      kernel_security_appleimage4_string_section = gXPF.kernelStringSection;
+  kpf_lock();
+  uint64_t value = 0;
+  if (kpf_cache_get(KPF_CACHE_NONCE_DOMAINS_ARRAY, &value) && !xpf_require_img4()) {
+    value = xpf_find_nonce_domains_array_scan();
+    if (value) {
+      kpf_cache_put(KPF_CACHE_NONCE_DOMAINS_ARRAY, value);
     }
   }
-  if (!kernel_security_appleimage4_text_section ||
-      !kernel_security_appleimage4_dataconst_section ||
-      !kernel_security_appleimage4_string_section) {
-    x8A4_log_error("Failed to setup kernel sections!\n", "");
+  kpf_unlock();
+  return value;
+}
+
+/**
+ * @brief           Find whether the kernel uses nonce slots, telling a kernel without a nonce domains array apart from a
+ *                  scan that could not run
+ * @return          One for nonce slots, zero for nonce domains, -1 if it could not be determined
+ */
+int xpf_find_nonce_slot_format(void) {
+  if (xpf_find_nonce_domains_array()) {
     return 0;
   }
+  kpf_lock();
+  int ret = -1;
+  if (!xpf_require_img4() && !xpf_scan_img4_targets() && !kpf_img4_targets_cached[KPF_IMG4_TARGET_NONCE_DOMAIN].vmaddr) {
+    ret = 1;
+  }
+  kpf_unlock();
+  return ret;
+}
+
+/**
+ * @brief           XPF Kernel patchfind the nonce slots array length
+ * @return          Length of the nonce slots array, -1 on failure
+ */
+int xpf_find_nonce_slots_array_length_scan(void) {
+  if(strcmp(gXPF.darwinVersion, "23.0.0") < 0 && !nonce_slot_format_cached) {
+    return -1;
+  }
+  if (xpf_setup_img4_sections()) {
+    return -1;
+  }
+  PFSection *kernel_security_appleimage4_text_section = kpf_img4_sections_cached.text;
   if(kpf_nonce_domains_length_cached > 0) {
     return kpf_nonce_domains_length_cached;
   }
   if(!kpf_nonce_domains_cached) {
-    xpf_find_nonce_domains_array();
+    xpf_find_nonce_slots_array_scan();
   }
   if(!kpf_nonce_domains_cached) {
     x8A4_log_error("Failed to get darwin_el2_init nonce_domains_array adrp!\n", "");
-    return 0;
+    return -1;
   }
   uint32_t mov_any_insn = 0;
   uint32_t mov_any_mask= 0;
@@ -294,7 +304,7 @@ int xpf_find_nonce_slots_array_length(void) {
   uint64_t mov_addr = pfsec_find_next_inst(kernel_security_appleimage4_text_section, kpf_nonce_domains_cached,0x10, mov_any_insn, mov_any_mask);
   if(!mov_addr) {
     x8A4_log_error("Failed to get darwin_el2_init mov addr!\n", "");
-    return 0;
+    return -1;
   }
   uint64_t imm = 0;
   arm64_dec_mov_imm(pfsec_read32(kernel_security_appleimage4_text_section, mov_addr), NULL, &imm, NULL, NULL);
@@ -302,65 +312,56 @@ int xpf_find_nonce_slots_array_length(void) {
   return (int)imm;
 }
 
+/**
+ * @brief           Get the nonce slots array length through the kpf cache
+ * @return          Length of the nonce slots array
+ */
+int xpf_find_nonce_slots_array_length(void) {
+  kpf_lock();
+  uint64_t value = 0;
+  if (kpf_cache_get(KPF_CACHE_NONCE_SLOTS_ARRAY_LENGTH, &value) && !xpf_require_img4()) {
+    int length = xpf_find_nonce_slots_array_length_scan();
+    if (length >= 0) {
+      value = (uint64_t)length;
+      kpf_cache_put(KPF_CACHE_NONCE_SLOTS_ARRAY_LENGTH, value);
+    }
+  }
+  kpf_unlock();
+  return (int)value;
+}
+
 /**
  * @brief           XPF Kernel patchfind the nonce domains array length
  * @param[in]       nonce_domains_array_addr
- * @return          Length of the nonce domains array
+ * @return          Length of the nonce domains array, -1 on failure
  */
-int xpf_find_nonce_domains_array_length(uint64_t nonce_domains_array_addr) {
+int xpf_find_nonce_domains_array_length_scan(uint64_t nonce_domains_array_addr) {
   if(strcmp(gXPF.darwinVersion, "23.0.0") >= 0 && nonce_slot_format_cached == 1) {
     return xpf_find_nonce_slots_array_length();
   }
   if(kpf_nonce_domains_length_cached > 0) {
     return kpf_nonce_domains_length_cached;
   }
-  PFSection *kernel_security_appleimage4_text_section = NULL;
-  PFSection *kernel_security_appleimage4_dataconst_section = NULL;
-  PFSection *kernel_security_appleimage4_string_section = NULL;
-  if (gXPF.kernelIsFileset) {
-    if (xpf_setup_fileset_sections()) {
-      return 0;
-    }
-    kernel_security_appleimage4_text_section = apple_image4_fileset_sections[0];
-    kernel_security_appleimage4_dataconst_section = apple_image4_fileset_sections[1];
-    kernel_security_appleimage4_string_section = apple_image4_fileset_sections[2];
-  } else {
-    if (strcmp(gXPF.darwinVersion, "22.0.0") >= 0) {
-      kernel_security_appleimage4_text_section = gXPF.kernelPLKTextSection;
-      kernel_security_appleimage4_dataconst_section = gXPF.kernelPLKTextSection;
-      kernel_security_appleimage4_string_section =
-          gXPF.kernelPrelinkTextSection;
-    } else {
-      kernel_security_appleimage4_text_section = gXPF.kernelTextSection;
-      kernel_security_appleimage4_dataconst_section = gXPF.kernelTextSection;
-      kernel_security_appleimage4_string_section = gXPF.kernelStringSection;
-    }
+  if (xpf_setup_img4_sections()) {
+    return -1;
   }
-  if (!kernel_security_appleimage4_text_section ||
-      !kernel_security_appleimage4_dataconst_section ||
-      !kernel_security_appleimage4_string_section) {
-    x8A4_log_error("Failed to setup kernel sections!\n", "");
-    return 0;
-  }
-  PFXrefMetric *nonce_domains_array_xref_metric =
-      pfmetric_xref_init(nonce_domains_array_addr, XREF_TYPE_MASK_REFERENCE);
-  __block uint64_t nonce_domains_array_ref = 0;
+  PFSection *kernel_security_appleimage4_text_section = kpf_img4_sections_cached.text;
+  struct kpf_scan_target nonce_domains_array = {NULL, nonce_domains_array_addr, {0}, KPF_SCAN_REFS_MAX, 0};
+  kpf_xref_index_scan(kernel_security_appleimage4_text_section, &nonce_domains_array, 1);
+  uint64_t nonce_domains_array_ref = 0;
   uint32_t b_cond_any_inst = 0, b_cond_any_mask = 0;
   arm64_gen_b_c_cond(OPT_BOOL(false), OPT_UINT64_NONE, OPT_UINT64_NONE,
                      ARM64_COND_ANY, &b_cond_any_inst, &b_cond_any_mask);
-  pfmetric_run(kernel_security_appleimage4_text_section,
-               nonce_domains_array_xref_metric, ^(uint64_t vmaddr, bool *stop) {
-                 if (!pfsec_find_next_inst(
-                         kernel_security_appleimage4_text_section, vmaddr - 12,
-                         4, b_cond_any_inst, b_cond_any_mask)) {
-                   nonce_domains_array_ref = vmaddr;
-                   *stop = true;
-                 }
-               });
-  pfmetric_free(nonce_domains_array_xref_metric);
+  for (int i = 0; i < nonce_domains_array.refs_count && !nonce_domains_array_ref; i++) {
+    if (!pfsec_find_next_inst(kernel_security_appleimage4_text_section,
+                              nonce_domains_array.refs[i] - 12, 4,
+                              b_cond_any_inst, b_cond_any_mask)) {
+      nonce_domains_array_ref = nonce_domains_array.refs[i];
+    }
+  }
   if (!nonce_domains_array_ref) {
     x8A4_log_error("Failed to find nonce domains array reference!\n", "");
-    return 0;
+    return -1;
   }
   uint32_t subs_any_inst = 0, subs_any_mask = 0;
   arm64_gen_sub_imm(ARM64_REG_ANY, ARM64_REG_ANY, OPT_UINT64_NONE,
@@ -370,7 +371,7 @@ int xpf_find_nonce_domains_array_length(uint64_t nonce_domains_array_addr) {
                                       subs_any_mask);
   if (!cmp) {
     x8A4_log_error("Failed to find nonce domains array reference!\n", "");
-    return 0;
+    return -1;
   }
   uint16_t imm = 0;
   bool s = false;
@@ -379,12 +380,111 @@ int xpf_find_nonce_domains_array_length(uint64_t nonce_domains_array_addr) {
       &imm, &s);
   if (ret < 0 || !s) {
     x8A4_log_error("Failed to decode CMP instruction!\n", "");
-    return 0;
+    return -1;
   }
   kpf_nonce_domains_length_cached = (int)imm;
   return (int)imm;
 }
 
+/**
+ * @brief           Get the nonce domains array length through the kpf cache
+ * @param[in]       nonce_domains_array_addr
+ * @return          Length of the nonce domains array
+ */
+int xpf_find_nonce_domains_array_length(uint64_t nonce_domains_array_addr) {
+  if(strcmp(gXPF.darwinVersion, "23.0.0") >= 0 && nonce_slot_format_cached == 1) {
+    return xpf_find_nonce_slots_array_length();
+  }
+  kpf_lock();
+  uint64_t value = 0;
+  if (kpf_cache_get(KPF_CACHE_NONCE_DOMAINS_ARRAY_LENGTH, &value) && !xpf_require_img4()) {
+    int length = xpf_find_nonce_domains_array_length_scan(nonce_domains_array_addr);
+    if (length >= 0) {
+      value = (uint64_t)length;
+      kpf_cache_put(KPF_CACHE_NONCE_DOMAINS_ARRAY_LENGTH, value);
+    }
+  }
+  kpf_unlock();
+  return (int)value;
+}
+
+/**
+ * @brief           XPF Kernel patchfind candidates for gRegistryRoot, the globals loaded just before IORegistryEntry::initialize sets kIORegistryPlanesKey on the root
+ * @return          Number of candidates found
+ */
+int xpf_find_registry_root_candidates_scan(void) {
+  PFSection *kernel_text_section = gXPF.kernelTextSection;
+  PFSection *kernel_string_section = gXPF.kernelStringSection;
+  if (!kernel_text_section || !kernel_string_section) {
+    x8A4_log_error("Failed to setup kernel sections!\n", "");
+    return 0;
+  }
+  struct kpf_scan_target planes = {"IORegistryPlanes", 0, {0}, KPF_REGISTRY_ROOT_REFS_MAX, 0};
+  if (kpf_scan_strings(kernel_string_section, &planes, 1)) {
+    x8A4_log_error("Failed to find \"IORegistryPlanes\" string!\n", "");
+    return 0;
+  }
+  if (kpf_scan_xrefs(kernel_text_section, &planes, 1)) {
+    x8A4_log_error("Failed to find \"IORegistryPlanes\" string reference!\n", "");
+    return 0;
+  }
+  uint32_t adrp_any_inst = 0, adrp_any_mask = 0;
+  arm64_gen_adr_p(OPT_BOOL(true), OPT_UINT64_NONE, OPT_UINT64_NONE,
+                  ARM64_REG_ANY, &adrp_any_inst, &adrp_any_mask);
+  for (int i = 0; i < planes.refs_count; i++) {
+    uint64_t cursor = planes.refs[i] - 8;
+    for (int j = 0; j < KPF_REGISTRY_ROOT_ADRP_MAX && kpf_registry_root_candidates_count_cached < KPF_REGISTRY_ROOT_CANDIDATES_MAX; j++) {
+      uint64_t prev_adrp_addr = pfsec_find_prev_inst(kernel_text_section, cursor, 20, adrp_any_inst, adrp_any_mask);
+      if (!prev_adrp_addr) {
+        break;
+      }
+      uint64_t global = pfsec_arm64_resolve_adrp_ldr_str_add_reference_auto(kernel_text_section, prev_adrp_addr + 4);
+      if (global) {
+        kpf_registry_root_candidates_cached[kpf_registry_root_candidates_count_cached++] = global;
+      }
+      cursor = prev_adrp_addr - 4;
+    }
+  }
+  return kpf_registry_root_candidates_count_cached;
+}
+
+/**
+ * @brief           Get the gRegistryRoot candidates through the kpf cache
+ * @param[out]      candidates
+ * @param[in]       max
+ * @return          Number of candidates found
+ */
+int xpf_find_registry_root_candidates(uint64_t *candidates, int max) {
+  if (!candidates || max <= 0) {
+    return 0;
+  }
+  kpf_lock();
+  uint64_t cached_count = 0;
+  if (!kpf_registry_root_candidates_count_cached && !kpf_cache_get(KPF_CACHE_REGISTRY_ROOT_CANDIDATES, &cached_count) && cached_count <= KPF_REGISTRY_ROOT_CANDIDATES_MAX) {
+    char name[0x40] = {0};
+    for (uint64_t i = 0; i < cached_count; i++) {
+      snprintf(name, sizeof(name), KPF_CACHE_REGISTRY_ROOT_CANDIDATES ".%llu", i);
+      if (kpf_cache_get(name, &kpf_registry_root_candidates_cached[kpf_registry_root_candidates_count_cached])) {
+        kpf_registry_root_candidates_count_cached = 0;
+        break;
+      }
+      kpf_registry_root_candidates_count_cached++;
+    }
+  }
+  if (!kpf_registry_root_candidates_count_cached && !xpf_require() && xpf_find_registry_root_candidates_scan()) {
+    char name[0x40] = {0};
+    for (int i = 0; i < kpf_registry_root_candidates_count_cached; i++) {
+      snprintf(name, sizeof(name), KPF_CACHE_REGISTRY_ROOT_CANDIDATES ".%d", i);
+      kpf_cache_put(name, kpf_registry_root_candidates_cached[i]);
+    }
+    kpf_cache_put(KPF_CACHE_REGISTRY_ROOT_CANDIDATES, (uint64_t)kpf_registry_root_candidates_count_cached);
+  }
+  int count = kpf_registry_root_candidates_count_cached < max ? kpf_registry_root_candidates_count_cached : max;
+  memcpy(candidates, kpf_registry_root_candidates_cached, count * sizeof(uint64_t));
+  kpf_unlock();
+  return count;
+}
+
 #if 0
 //    PFSection *list[] = {
 //            gXPF.kernelTextSection,
@@ -407,55 +507,37 @@ int xpf_find_nonce_domains_array_length(uint64_t nonce_domains_array_addr) {
  * @brief           Iterate each nonce domains array entry until cryptex boot is found
  * @param[in]       nonce_domains_array_addr
  * @param[in]       nonce_domains_array_length
- * @return          Index of cryptex boot entry
+ * @return          Index of cryptex boot entry, KPF_SCAN_NOT_FOUND if every entry was read without a match, KPF_SCAN_FAILED
+ *                  otherwise
  */
-int xpf_find_cryptex_boot_domain_index(uint64_t nonce_domains_array_addr,
-                                      int nonce_domains_array_length) {
+int xpf_find_cryptex_boot_domain_index_scan(uint64_t nonce_domains_array_addr,
+                                           int nonce_domains_array_length) {
   if (!nonce_domains_array_addr) {
     x8A4_log_error("Failure: nonce_domains_array_addr is zero!\n", "");
-    return 0;
+    return KPF_SCAN_FAILED;
   }
   if (!nonce_domains_array_length) {
     x8A4_log_error("Failure: nonce_domains_array_length is zero!\n", "");
-    return 0;
+    return KPF_SCAN_FAILED;
   }
-  PFSection *kernel_security_appleimage4_text_section = NULL;
-  PFSection *kernel_security_appleimage4_dataconst_section = NULL;
-  PFSection *kernel_security_appleimage4_string_section = NULL;
-  if (gXPF.kernelIsFileset) {
-    if (xpf_setup_fileset_sections()) {
-      return 0;
-    }
-    kernel_security_appleimage4_text_section = apple_image4_fileset_sections[0];
-    kernel_security_appleimage4_dataconst_section = apple_image4_fileset_sections[1];
-    kernel_security_appleimage4_string_section = apple_image4_fileset_sections[2];
-  } else {
-    if (strcmp(gXPF.darwinVersion, "22.0.0") >= 0) {
-      kernel_security_appleimage4_text_section = gXPF.kernelPLKTextSection;
-      kernel_security_appleimage4_dataconst_section =
-          gXPF.kernelPLKDataConstSection;
-      kernel_security_appleimage4_string_section =
-          gXPF.kernelPrelinkTextSection;
-    } else {
-      kernel_security_appleimage4_text_section = gXPF.kernelTextSection;
-      kernel_security_appleimage4_dataconst_section =
-          gXPF.kernelDataConstSection;
-      kernel_security_appleimage4_string_section = gXPF.kernelStringSection;
-    }
+  if (xpf_setup_img4_sections()) {
+    return KPF_SCAN_FAILED;
   }
-  if (!kernel_security_appleimage4_text_section ||
-      !kernel_security_appleimage4_dataconst_section ||
-      !kernel_security_appleimage4_string_section) {
+  PFSection *kernel_security_appleimage4_dataconst_section = kpf_img4_sections_cached.data_const;
+  PFSection *kernel_security_appleimage4_string_section = kpf_img4_sections_cached.cstring;
+  if (!kernel_security_appleimage4_dataconst_section) {
     x8A4_log_error("Failed to setup kernel sections!\n", "");
-    return 0;
+    return KPF_SCAN_FAILED;
   }
-  int cryptex_index = -1;
+  int cryptex_index = KPF_SCAN_NOT_FOUND;
+  int unread = 0;
   for (int i = 0; i < nonce_domains_array_length; i++) {
     uint64_t vmaddr = nonce_domains_array_addr + (i * sizeof(uint64_t));
     uint64_t ptr =
         pfsec_read64(kernel_security_appleimage4_dataconst_section, vmaddr);
     if (!ptr) {
       x8A4_log_error("i: %d: Failed read domain pointer from 0x%016llX!\n", i, vmaddr);
+      unread++;
       continue;
     }
     if ((ptr & 0x8000000000000) != 0x8000000000000) {
@@ -467,6 +549,7 @@ int xpf_find_cryptex_boot_domain_index(uint64_t nonce_domains_array_addr,
                        vmaddr + sizeof(uint64_t));
     if (!ptr) {
       x8A4_log_error("i: %d: Failed read domain pointer 2 from 0x%016llX!\n", i, vmaddr);
+      unread++;
       continue;
     }
     if ((ptr & 0x8000000000000) != 0x8000000000000) {
@@ -478,6 +561,7 @@ int xpf_find_cryptex_boot_domain_index(uint64_t nonce_domains_array_addr,
                                 &domain);
     if (ret != 0 || !domain) {
       x8A4_log_error("Failed read domain string from 0x%llX ret: %d pointer: 0x%016llX!\n", nonce_domains_array_addr + (i * sizeof(uint64_t)), ret, (uint64_t)domain);
+      unread++;
       continue;
     }
     if (strcmp("com.apple.private.img4.nonce.cryptex1.boot", domain) == 0) {
@@ -487,6 +571,31 @@ int xpf_find_cryptex_boot_domain_index(uint64_t nonce_domains_array_addr,
   }
   if (cryptex_index < 0) {
     x8A4_log_error("Failed find cryptex domain index!\n", "");
+    if (unread) {
+      cryptex_index = KPF_SCAN_FAILED;
+    }
   }
   return cryptex_index;
 }
+
+/**
+ * @brief           Get the cryptex boot nonce domain index through the kpf cache, a missing entry is cached as well
+ * @param[in]       nonce_domains_array_addr
+ * @param[in]       nonce_domains_array_length
+ * @return          Index of cryptex boot entry, -1 if there is none
+ */
+int xpf_find_cryptex_boot_domain_index(uint64_t nonce_domains_array_addr,
+                                      int nonce_domains_array_length) {
+  kpf_lock();
+  uint64_t value = KPF_CACHE_NOT_FOUND;
+  if (kpf_cache_get(KPF_CACHE_CRYPTEX_BOOT_DOMAIN_INDEX, &value) && !xpf_require_img4()) {
+    int index = xpf_find_cryptex_boot_domain_index_scan(nonce_domains_array_addr, nonce_domains_array_length);
+    value = index >= 0 ? (uint64_t)index : KPF_CACHE_NOT_FOUND;
+    if (index != KPF_SCAN_FAILED) {
+      kpf_cache_put(KPF_CACHE_CRYPTEX_BOOT_DOMAIN_INDEX, value);
+    }
+  }
+  int ret = value == KPF_CACHE_NOT_FOUND ? -1 : (int)value;
+  kpf_unlock();
+  return ret;
+}
@@ -0,0 +1,327 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kpf_cache.c
+ * @author Cryptiiiic
+ * @brief This file is for persisting patchfinder results across runs on the same kernel.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include <XPF/xpf.h>
+#include <x8A4/Kernel/kernel.h>
+#include <x8A4/Kernel/kpf_cache.h>
+#include <x8A4/Logger/logger.h>
+#include <x8A4/x8A4.h>
+
+/* Cached Variables */
+const char *kpf_cache_path_cached = NULL;
+struct kpf_cache_entry kpf_cache_entries_cached[KPF_CACHE_ENTRIES_MAX] = {0};
+size_t kpf_cache_entries_count_cached = 0;
+int kpf_cache_dirty_cached = 0;
+int kpf_cache_warm_cached = 0;
+pthread_mutex_t kpf_lock_cached;
+pthread_once_t kpf_lock_once_cached = PTHREAD_ONCE_INIT;
+
+/* Functions */
+/**
+ * @brief           Create the recursive kpf lock
+ */
+void kpf_lock_init(void) {
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&kpf_lock_cached, &attr);
+  pthread_mutexattr_destroy(&attr);
+}
+
+/**
+ * @brief           Serialize XPF and kpf cache users across init threads, XPF is not thread safe
+ */
+void kpf_lock(void) {
+  pthread_once(&kpf_lock_once_cached, kpf_lock_init);
+  pthread_mutex_lock(&kpf_lock_cached);
+}
+
+/**
+ * @brief           Release the kpf lock
+ */
+void kpf_unlock(void) {
+  pthread_mutex_unlock(&kpf_lock_cached);
+}
+
+/**
+ * @brief           Set the patchfinder cache file path, an empty path disables the cache
+ * @param[in]       path
+ */
+void kpf_cache_set_path(const char *path) {
+  kpf_cache_path_cached = path;
+}
+
+/**
+ * @brief           Get the patchfinder cache file path from its setter, its environment variable or the default
+ * @return          Path, NULL if disabled
+ */
+const char *kpf_cache_path(void) {
+  const char *path = kpf_cache_path_cached;
+  if (!path) {
+    path = getenv(KPF_CACHE_ENV);
+  }
+  if (!path) {
+    path = KPF_CACHE_PATH;
+  }
+  return path[0] ? path : NULL;
+}
+
+/**
+ * @brief           Check that a cached darwin version and xnu build match the running kernel
+ * @param[in]       darwin_version
+ * @param[in]       xnu_build
+ * @return          Non zero on match
+ */
+int kpf_cache_kernel_matches(const char *darwin_version, const char *xnu_build) {
+  struct utsname name = {0};
+  if (uname(&name)) {
+    return 0;
+  }
+  char xnu_tag[0x60] = {0};
+  snprintf(xnu_tag, sizeof(xnu_tag), "xnu-%s~", xnu_build);
+  return !strcmp(name.release, darwin_version) && strstr(name.version, xnu_tag);
+}
+
+/**
+ * @brief           Drop the XPF kernel info restored by a warm start so XPF can fill it
+ */
+void kpf_cache_release_info(void) {
+  if (!kpf_cache_warm_cached) {
+    return;
+  }
+  free(gXPF.darwinVersion);
+  free(gXPF.xnuBuild);
+  gXPF.darwinVersion = NULL;
+  gXPF.xnuBuild = NULL;
+  gXPF.kernelBase = 0;
+  gXPF.kernelIsArm64e = false;
+  gXPF.kernelIsFileset = false;
+  kpf_cache_warm_cached = 0;
+}
+
+/**
+ * @brief           Load the patchfinder cache for the booted kernel and restore the XPF kernel info from it
+ * @return          Zero on a warm start
+ */
+int kpf_cache_load(void) {
+  const char *path = kpf_cache_path();
+  const char *kernel_path = get_kernel_path();
+  if (!path || !kernel_path) {
+    return -1;
+  }
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    x8A4_log_debug("No kpf cache at %s\n", path);
+    return -1;
+  }
+  char line[KPF_CACHE_LINE_MAX] = {0};
+  char darwin_version[0x40] = {0};
+  char xnu_build[0x40] = {0};
+  char cached_kernel_path[KPF_CACHE_LINE_MAX] = {0};
+  unsigned long long kernel_base = 0;
+  int arm64e = -1;
+  int fileset = -1;
+  int version = 0;
+  kpf_cache_entries_count_cached = 0;
+  if (!fgets(line, sizeof(line), file) || sscanf(line, KPF_CACHE_MAGIC " %d", &version) != 1 || version != KPF_CACHE_VERSION) {
+    x8A4_log_debug("Ignoring kpf cache %s with unknown format\n", path);
+    fclose(file);
+    return -1;
+  }
+  while (fgets(line, sizeof(line), file)) {
+    char name[sizeof(kpf_cache_entries_cached[0].name)] = {0};
+    char value[KPF_CACHE_LINE_MAX] = {0};
+    if (sscanf(line, "%63s %511s", name, value) != 2) {
+      continue;
+    }
+    if (!strcmp(name, "kernel")) {
+      snprintf(cached_kernel_path, sizeof(cached_kernel_path), "%s", value);
+    } else if (!strcmp(name, "darwin")) {
+      snprintf(darwin_version, sizeof(darwin_version), "%s", value);
+    } else if (!strcmp(name, "xnu")) {
+      snprintf(xnu_build, sizeof(xnu_build), "%s", value);
+    } else if (!strcmp(name, "base")) {
+      kernel_base = strtoull(value, NULL, 16);
+    } else if (!strcmp(name, "arm64e")) {
+      arm64e = atoi(value);
+    } else if (!strcmp(name, "fileset")) {
+      fileset = atoi(value);
+    } else if (kpf_cache_entries_count_cached < KPF_CACHE_ENTRIES_MAX) {
+      struct kpf_cache_entry *entry = &kpf_cache_entries_cached[kpf_cache_entries_count_cached++];
+      memcpy(entry->name, name, sizeof(entry->name));
+      entry->value = strtoull(value, NULL, 16);
+    }
+  }
+  fclose(file);
+  if (strcmp(cached_kernel_path, kernel_path) || !darwin_version[0] || !xnu_build[0] || !kernel_base || arm64e < 0 || fileset < 0 ||
+      !kpf_cache_kernel_matches(darwin_version, xnu_build)) {
+    x8A4_log_debug("Ignoring stale kpf cache %s\n", path);
+    kpf_cache_entries_count_cached = 0;
+    return -1;
+  }
+  gXPF.darwinVersion = strdup(darwin_version);
+  gXPF.xnuBuild = strdup(xnu_build);
+  if (!gXPF.darwinVersion || !gXPF.xnuBuild) {
+    x8A4_log_error("Failed to strdup kpf cache kernel info!\n", "");
+    kpf_cache_warm_cached = 1;
+    kpf_cache_release_info();
+    kpf_cache_entries_count_cached = 0;
+    return -1;
+  }
+  gXPF.kernelBase = kernel_base;
+  gXPF.kernelIsArm64e = arm64e != 0;
+  gXPF.kernelIsFileset = fileset != 0;
+  kpf_cache_warm_cached = 1;
+  kpf_cache_dirty_cached = 0;
+  uint64_t nonce_slot_format = 0;
+  if (!kpf_cache_get(KPF_CACHE_NONCE_SLOT_FORMAT, &nonce_slot_format)) {
+    nonce_slot_format_cached = (int)nonce_slot_format;
+  }
+  x8A4_log_debug("Loaded %zu kpf cache entries for xnu-%s from %s\n", kpf_cache_entries_count_cached, xnu_build, path);
+  return 0;
+}
+
+/**
+ * @brief           Write the patchfinder cache if it gained entries this run
+ * @return          Zero on success
+ */
+int kpf_cache_save(void) {
+  kpf_lock();
+  int ret = kpf_cache_save_locked();
+  kpf_unlock();
+  return ret;
+}
+
+/**
+ * @brief           Write the patchfinder cache, the kpf lock must be held
+ * @return          Zero on success
+ */
+int kpf_cache_save_locked(void) {
+  const char *path = kpf_cache_path();
+  const char *kernel_path = get_kernel_path();
+  if (!kpf_cache_dirty_cached || !path || !kernel_path || !gXPF.darwinVersion || !gXPF.xnuBuild) {
+    return 0;
+  }
+  char tmp_path[KPF_CACHE_LINE_MAX] = {0};
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+  FILE *file = fopen(tmp_path, "w");
+  if (!file) {
+    x8A4_log_debug("Failed to open kpf cache %s (%d:%s)\n", tmp_path, errno, strerror(errno));
+    return -1;
+  }
+  fprintf(file, KPF_CACHE_MAGIC " %d\n", KPF_CACHE_VERSION);
+  fprintf(file, "kernel %s\n", kernel_path);
+  fprintf(file, "darwin %s\n", gXPF.darwinVersion);
+  fprintf(file, "xnu %s\n", gXPF.xnuBuild);
+  fprintf(file, "base 0x%llx\n", gXPF.kernelBase);
+  fprintf(file, "arm64e %d\n", gXPF.kernelIsArm64e ? 1 : 0);
+  fprintf(file, "fileset %d\n", gXPF.kernelIsFileset ? 1 : 0);
+  for (size_t i = 0; i < kpf_cache_entries_count_cached; i++) {
+    fprintf(file, "%s 0x%llx\n", kpf_cache_entries_cached[i].name, kpf_cache_entries_cached[i].value);
+  }
+  if (fclose(file) || rename(tmp_path, path)) {
+    x8A4_log_debug("Failed to write kpf cache %s (%d:%s)\n", path, errno, strerror(errno));
+    remove(tmp_path);
+    return -1;
+  }
+  kpf_cache_dirty_cached = 0;
+  return 0;
+}
+
+/**
+ * @brief           Get a cached patchfinder result
+ * @param[in]       name
+ * @param[out]      value
+ * @return          Zero on hit, ENOENT on miss
+ */
+int kpf_cache_get(const char *name, uint64_t *value) {
+  if (!name || !value) {
+    return EINVAL;
+  }
+  int ret = ENOENT;
+  kpf_lock();
+  for (size_t i = 0; i < kpf_cache_entries_count_cached; i++) {
+    if (!strcmp(kpf_cache_entries_cached[i].name, name)) {
+      *value = kpf_cache_entries_cached[i].value;
+      ret = 0;
+      break;
+    }
+  }
+  kpf_unlock();
+  return ret;
+}
+
+/**
+ * @brief           Store a patchfinder result to be written with the cache
+ * @param[in]       name
+ * @param[in]       value
+ */
+void kpf_cache_put(const char *name, uint64_t value) {
+  if (!name || strlen(name) >= sizeof(kpf_cache_entries_cached[0].name)) {
+    return;
+  }
+  kpf_lock();
+  struct kpf_cache_entry *entry = NULL;
+  for (size_t i = 0; i < kpf_cache_entries_count_cached && !entry; i++) {
+    if (!strcmp(kpf_cache_entries_cached[i].name, name)) {
+      entry = &kpf_cache_entries_cached[i];
+    }
+  }
+  if (!entry && kpf_cache_entries_count_cached < KPF_CACHE_ENTRIES_MAX) {
+    entry = &kpf_cache_entries_cached[kpf_cache_entries_count_cached++];
+    snprintf(entry->name, sizeof(entry->name), "%s", name);
+    kpf_cache_dirty_cached = 1;
+  }
+  if (entry) {
+    kpf_cache_dirty_cached |= entry->value != value;
+    entry->value = value;
+  }
+  kpf_unlock();
+}
+
+/**
+ * @brief           Resolve an XPF item through the patchfinder cache, starting XPF on a miss
+ * @param[in]       name
+ * @return          Item value, zero on failure
+ */
+uint64_t kpf_cache_item_resolve(const char *name) {
+  kpf_lock();
+  uint64_t value = 0;
+  if (kpf_cache_get(name, &value) && !xpf_require()) {
+    value = xpf_item_resolve(name);
+    if (value) {
+      kpf_cache_put(name, value);
+    }
+  }
+  kpf_unlock();
+  return value;
+}
+
+/**
+ * @brief           Save and drop the patchfinder cache
+ */
+void kpf_cache_free(void) {
+  kpf_cache_save();
+  kpf_cache_release_info();
+  memset(kpf_cache_entries_cached, 0, sizeof(kpf_cache_entries_cached));
+  kpf_cache_entries_count_cached = 0;
+  kpf_cache_dirty_cached = 0;
+}
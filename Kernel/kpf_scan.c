@@ -0,0 +1,245 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kpf_scan.c
+ * @author Cryptiiiic
+ * @brief This file is for finding several patchfinder strings and xref targets in one pass over a section.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <choma/MachO.h>
+#include <choma/MemoryStream.h>
+#include <x8A4/Kernel/kpf_scan.h>
+#include <x8A4/Logger/logger.h>
+
+/* Functions */
+/**
+ * @brief           Find every pending target string in one walk over a cstring section, like a string metric
+ *                  a match is the first place the string is followed by a NUL, so it may be the tail of a longer string
+ * @param[in]       section
+ * @param[in,out]   targets
+ * @param[in]       count
+ * @return          Number of target strings not found
+ */
+int kpf_scan_strings(PFSection *section, struct kpf_scan_target *targets, size_t count) {
+  if (!targets || count > KPF_SCAN_TARGETS_MAX) {
+    return (int)count;
+  }
+  size_t lens[KPF_SCAN_TARGETS_MAX] = {0};
+  int pending = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (targets[i].string && !targets[i].vmaddr) {
+      lens[i] = strlen(targets[i].string);
+      pending++;
+    }
+  }
+  if (!pending || !section) {
+    return pending;
+  }
+  uint8_t *buf = section->cache;
+  if (!buf) {
+    buf = (uint8_t *)malloc(section->size);
+    if (!buf || pfsec_read_reloff(section, 0, section->size, buf)) {
+      x8A4_log_error("Failed to read %.16s,%.16s for string scan!\n", section->segname, section->sectname);
+      free(buf);
+      return pending;
+    }
+  }
+  for (uint64_t off = 0; off < section->size && pending;) {
+    const char *str = (const char *)&buf[off];
+    size_t len = strnlen(str, section->size - off);
+    if (off + len >= section->size) {
+      break;
+    }
+    for (size_t i = 0; i < count; i++) {
+      if (!targets[i].string || targets[i].vmaddr || !lens[i] || lens[i] > len) {
+        continue;
+      }
+      if (!memcmp(str + len - lens[i], targets[i].string, lens[i])) {
+        targets[i].vmaddr = section->vmaddr + off + len - lens[i];
+        pending--;
+      }
+    }
+    off += len + 1;
+  }
+  if (buf != section->cache) {
+    free(buf);
+  }
+  return pending;
+}
+
+/**
+ * @brief           Count the targets of a scan that still want references
+ * @param[in]       targets
+ * @param[in]       count
+ * @param[in]       found
+ * @return          Number of targets still wanting references
+ */
+size_t kpf_scan_xrefs_pending(const struct kpf_scan_target *targets, size_t count, const int *found) {
+  size_t pending = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (targets[i].vmaddr && targets[i].refs_count + found[i] < targets[i].refs_max) {
+      pending++;
+    }
+  }
+  return pending;
+}
+
+/**
+ * @brief           Pick how many chunks to split a text section into, one per core for large cached sections. A section
+ *                  whose stream has no raw pointer is paged and is never pulled into memory whole
+ * @param[in]       section
+ * @return          Number of chunks
+ */
+size_t kpf_scan_chunks_count(PFSection *section) {
+  if (section->size < KPF_SCAN_PARALLEL_MIN) {
+    return 1;
+  }
+  MemoryStream *stream = section->macho ? macho_get_stream(section->macho) : NULL;
+  if (!section->cache && (!stream || !memory_stream_get_raw_pointer(stream))) {
+    return 1;
+  }
+  if (!section->cache && (pfsec_set_cached(section, true) || !section->cache)) {
+    return 1;
+  }
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  if (cpus < 1) {
+    return 1;
+  }
+  return cpus > KPF_SCAN_THREADS_MAX ? KPF_SCAN_THREADS_MAX : (size_t)cpus;
+}
+
+/**
+ * @brief           Collect the references to the pending targets whose source lies in one chunk
+ * @param[in]       arg
+ * @return          NULL
+ */
+void *kpf_scan_xrefs_worker(void *arg) {
+  struct kpf_scan_chunk *chunk = (struct kpf_scan_chunk *)arg;
+  __block size_t pending = kpf_scan_xrefs_pending(chunk->targets, chunk->count, chunk->refs_count);
+  if (!pending) {
+    return NULL;
+  }
+  pfsec_arm64_enumerate_xrefs(&chunk->section, ARM64_XREF_TYPE_MASK_REFERENCE,
+                              ^(Arm64XrefType type, uint64_t source, uint64_t target, bool *stop) {
+                                if (source < chunk->start || source >= chunk->end) {
+                                  return;
+                                }
+                                for (size_t i = 0; i < chunk->count; i++) {
+                                  const struct kpf_scan_target *entry = &chunk->targets[i];
+                                  int wanted = entry->refs_max - entry->refs_count;
+                                  if (entry->vmaddr != target || chunk->refs_count[i] >= wanted) {
+                                    continue;
+                                  }
+                                  chunk->refs[i][chunk->refs_count[i]++] = source;
+                                  if (chunk->refs_count[i] == wanted && !--pending) {
+                                    *stop = true;
+                                  }
+                                }
+                              });
+  return NULL;
+}
+
+/**
+ * @brief           Collect the code references to every pending target in one walk over a text section. Large
+ *                  sections are split into instruction aligned chunks scanned on their own threads, each chunk
+ *                  overlaps its neighbours so adrp pairs across a boundary resolve, and only keeps sources inside
+ *                  itself. Chunks are merged in address order so a target gets the same first refs as a serial scan
+ * @param[in]       section
+ * @param[in,out]   targets
+ * @param[in]       count
+ * @return          Number of targets left without a reference
+ */
+int kpf_scan_xrefs(PFSection *section, struct kpf_scan_target *targets, size_t count) {
+  if (!targets || count > KPF_SCAN_TARGETS_MAX) {
+    return (int)count;
+  }
+  int none[KPF_SCAN_TARGETS_MAX] = {0};
+  for (size_t i = 0; i < count; i++) {
+    if (targets[i].refs_max > KPF_SCAN_REFS_MAX) {
+      targets[i].refs_max = KPF_SCAN_REFS_MAX;
+    }
+  }
+  size_t chunks_count = 0;
+  struct kpf_scan_chunk *chunks = NULL;
+  if (section && kpf_scan_xrefs_pending(targets, count, none)) {
+    chunks_count = kpf_scan_chunks_count(section);
+    chunks = (struct kpf_scan_chunk *)calloc(chunks_count, sizeof(struct kpf_scan_chunk));
+    if (!chunks) {
+      x8A4_log_error("Failed to calloc memory for xref scan chunks!\n", "");
+      chunks_count = 0;
+    }
+  }
+  uint64_t chunk_size = chunks_count ? ((section->size / chunks_count) + 3) & ~3ULL : 0;
+  for (size_t c = 0; c < chunks_count; c++) {
+    struct kpf_scan_chunk *chunk = &chunks[c];
+    uint64_t start = c * chunk_size;
+    uint64_t end = (c == chunks_count - 1 || start + chunk_size > section->size) ? section->size : start + chunk_size;
+    if (start >= end) {
+      break;
+    }
+    uint64_t scan_start = start > KPF_SCAN_CHUNK_OVERLAP ? start - KPF_SCAN_CHUNK_OVERLAP : 0;
+    uint64_t scan_end = end + KPF_SCAN_CHUNK_OVERLAP < section->size ? end + KPF_SCAN_CHUNK_OVERLAP : section->size;
+    chunk->section = *section;
+    if (chunks_count > 1) {
+      chunk->section.fileoff += scan_start;
+      chunk->section.vmaddr += scan_start;
+      chunk->section.size = scan_end - scan_start;
+      chunk->section.cache += scan_start;
+    }
+    chunk->start = section->vmaddr + start;
+    chunk->end = section->vmaddr + end;
+    chunk->targets = targets;
+    chunk->count = count;
+    if (chunks_count > 1 && !pthread_create(&chunk->thread, NULL, kpf_scan_xrefs_worker, chunk)) {
+      chunk->threaded = 1;
+    } else {
+      kpf_scan_xrefs_worker(chunk);
+    }
+  }
+  for (size_t c = 0; c < chunks_count; c++) {
+    if (chunks[c].threaded) {
+      pthread_join(chunks[c].thread, NULL);
+    }
+  }
+  for (size_t c = 0; c < chunks_count; c++) {
+    for (size_t i = 0; i < count; i++) {
+      for (int k = 0; k < chunks[c].refs_count[i] && targets[i].refs_count < targets[i].refs_max; k++) {
+        targets[i].refs[targets[i].refs_count++] = chunks[c].refs[i][k];
+      }
+    }
+  }
+  free(chunks);
+  int missing = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (targets[i].refs_max && !targets[i].refs_count) {
+      missing++;
+    }
+  }
+  return missing;
+}
+
+/**
+ * @brief           Forget the results of earlier scans, keeping the target strings
+ * @param[in,out]   targets
+ * @param[in]       count
+ */
+void kpf_scan_reset(struct kpf_scan_target *targets, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    if (targets[i].string) {
+      targets[i].vmaddr = 0;
+    }
+    memset(targets[i].refs, 0, sizeof(targets[i].refs));
+    targets[i].refs_count = 0;
+  }
+}
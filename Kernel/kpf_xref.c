@@ -0,0 +1,333 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kpf_xref.c
+ * @author Cryptiiiic
+ * @brief This file is for the persisted target to referencing instructions index of the AppleImage4 kext.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <x8A4/Kernel/kpager.h>
+#include <x8A4/Kernel/kpf_cache.h>
+#include <x8A4/Kernel/kpf_xref.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+const char *kpf_xref_index_path_cached = NULL;
+struct kpf_xref_entry *kpf_xref_index_cached = NULL;
+size_t kpf_xref_index_count_cached = 0;
+PFSection *kpf_xref_index_section_cached = NULL;
+
+/* Functions */
+/**
+ * @brief           Set the xref index file path, an empty path disables persisting the index
+ * @param[in]       path
+ */
+void kpf_xref_index_set_path(const char *path) {
+  kpf_xref_index_path_cached = path;
+}
+
+/**
+ * @brief           Get the xref index file path from its setter, its environment variable or the default cache path
+ * @param[out]      path
+ * @param[in]       len
+ * @return          Zero on success, -1 if disabled
+ */
+int kpf_xref_index_path(char *path, size_t len) {
+  const char *custom = kpf_xref_index_path_cached;
+  if (!custom) {
+    custom = getenv(KPF_XREF_INDEX_ENV);
+  }
+  if (!custom) {
+    custom = KPF_XREF_INDEX_PATH;
+  }
+  return custom[0] && snprintf(path, len, "%s", custom) < (int)len ? 0 : -1;
+}
+
+/**
+ * @brief           Get the LC_UUID of the kernel XPF parsed, or of the paged kernelcache when XPF is not running
+ * @param[out]      uuid
+ * @return          Zero on success
+ */
+int kpf_xref_kernel_uuid(uint8_t *uuid) {
+  MachO *kernel = gXPF.kernel ? gXPF.kernel : kpager_fileset_macho_cached;
+  if (!kernel || !uuid) {
+    return -1;
+  }
+  __block int found = 0;
+  macho_enumerate_load_commands(kernel, ^(struct load_command loadCommand, uint64_t offset, void *cmd, bool *stop) {
+    if (loadCommand.cmd == LC_UUID) {
+      memcpy(uuid, ((struct uuid_command *)cmd)->uuid, sizeof(((struct uuid_command *)cmd)->uuid));
+      found = 1;
+      *stop = true;
+    }
+  });
+  return found ? 0 : -1;
+}
+
+/**
+ * @brief           Order xref index entries by target, then by source
+ * @param[in]       a
+ * @param[in]       b
+ * @return          Negative, zero or positive like strcmp
+ */
+int kpf_xref_entry_compare(const void *a, const void *b) {
+  const struct kpf_xref_entry *left = (const struct kpf_xref_entry *)a;
+  const struct kpf_xref_entry *right = (const struct kpf_xref_entry *)b;
+  if (left->target != right->target) {
+    return left->target < right->target ? -1 : 1;
+  }
+  if (left->source != right->source) {
+    return left->source < right->source ? -1 : 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief           Check that a loaded xref index entry is one a sweep of the section could have produced
+ * @param[in]       section
+ * @param[in]       entry
+ * @return          Non zero if valid
+ */
+int kpf_xref_entry_valid(PFSection *section, const struct kpf_xref_entry *entry) {
+  return entry->type <= ARM64_XREF_TYPE_POINTER && entry->target && entry->source >= section->vmaddr &&
+         entry->source - section->vmaddr < section->size;
+}
+
+/**
+ * @brief           Load the xref index saved for this kernel and section
+ * @param[in]       section
+ * @param[in]       uuid
+ * @return          Zero on success
+ */
+int kpf_xref_index_load(PFSection *section, const uint8_t *uuid) {
+  char path[KPF_XREF_INDEX_PATH_MAX] = {0};
+  if (kpf_xref_index_path(path, sizeof(path))) {
+    return -1;
+  }
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    x8A4_log_debug("No xref index at %s\n", path);
+    return -1;
+  }
+  struct kpf_xref_index_header header = {0};
+  struct kpf_xref_entry *entries = NULL;
+  int ret = -1;
+  if (fread(&header, sizeof(header), 1, file) == 1 && !strncmp(header.magic, KPF_XREF_INDEX_MAGIC, sizeof(header.magic)) &&
+      header.version == KPF_XREF_INDEX_VERSION && header.entry_size == sizeof(struct kpf_xref_entry) &&
+      !memcmp(header.uuid, uuid, sizeof(header.uuid)) && header.vmaddr == section->vmaddr && header.size == section->size &&
+      header.count && header.count <= section->size) {
+    entries = (struct kpf_xref_entry *)calloc(header.count, sizeof(struct kpf_xref_entry));
+    if (entries && fread(entries, sizeof(struct kpf_xref_entry), header.count, file) == header.count) {
+      ret = 0;
+    }
+    for (uint64_t i = 0; i < header.count && !ret; i++) {
+      if (!kpf_xref_entry_valid(section, &entries[i]) || (i && kpf_xref_entry_compare(&entries[i - 1], &entries[i]) > 0)) {
+        ret = -1;
+      }
+    }
+  }
+  fclose(file);
+  if (ret) {
+    x8A4_log_debug("Ignoring stale xref index %s\n", path);
+    free(entries);
+    return -1;
+  }
+  kpf_xref_index_cached = entries;
+  kpf_xref_index_count_cached = header.count;
+  kpf_xref_index_section_cached = section;
+  x8A4_log_debug("Loaded %llu xrefs for %.16s,%.16s from %s\n", header.count, section->segname, section->sectname, path);
+  return 0;
+}
+
+/**
+ * @brief           Index every xref of a section by target in one sweep
+ * @param[in]       section
+ * @return          Zero on success
+ */
+int kpf_xref_index_build(PFSection *section) {
+  __block struct kpf_xref_entry *entries = NULL;
+  __block size_t count = 0;
+  __block size_t capacity = 0;
+  __block int failed = 0;
+  pfsec_arm64_enumerate_xrefs(section, ARM64_XREF_TYPE_ALL, ^(Arm64XrefType type, uint64_t source, uint64_t target, bool *stop) {
+    if (count == capacity) {
+      size_t new_capacity = capacity ? capacity * 2 : 0x400;
+      struct kpf_xref_entry *grown = (struct kpf_xref_entry *)realloc(entries, new_capacity * sizeof(struct kpf_xref_entry));
+      if (!grown) {
+        failed = 1;
+        *stop = true;
+        return;
+      }
+      entries = grown;
+      capacity = new_capacity;
+    }
+    entries[count++] = (struct kpf_xref_entry){target, source, (uint32_t)type, 0};
+  });
+  if (failed || !count) {
+    x8A4_log_error("Failed to index xrefs of %.16s,%.16s!\n", section->segname, section->sectname);
+    free(entries);
+    return -1;
+  }
+  qsort(entries, count, sizeof(struct kpf_xref_entry), kpf_xref_entry_compare);
+  kpf_xref_index_cached = entries;
+  kpf_xref_index_count_cached = count;
+  kpf_xref_index_section_cached = section;
+  x8A4_log_debug("Indexed %zu xrefs of %.16s,%.16s\n", count, section->segname, section->sectname);
+  return 0;
+}
+
+/**
+ * @brief           Write the xref index keyed by the kernel UUID
+ * @param[in]       uuid
+ * @return          Zero on success
+ */
+int kpf_xref_index_save(const uint8_t *uuid) {
+  char path[KPF_XREF_INDEX_PATH_MAX] = {0};
+  if (!kpf_xref_index_cached || kpf_xref_index_path(path, sizeof(path))) {
+    return -1;
+  }
+  char tmp_path[KPF_XREF_INDEX_PATH_MAX + 4] = {0};
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+  FILE *file = fopen(tmp_path, "wb");
+  if (!file) {
+    x8A4_log_debug("Failed to open xref index %s (%d:%s)\n", tmp_path, errno, strerror(errno));
+    return -1;
+  }
+  struct kpf_xref_index_header header = {0};
+  strncpy(header.magic, KPF_XREF_INDEX_MAGIC, sizeof(header.magic));
+  header.version = KPF_XREF_INDEX_VERSION;
+  header.entry_size = sizeof(struct kpf_xref_entry);
+  memcpy(header.uuid, uuid, sizeof(header.uuid));
+  header.vmaddr = kpf_xref_index_section_cached->vmaddr;
+  header.size = kpf_xref_index_section_cached->size;
+  header.count = kpf_xref_index_count_cached;
+  int ret = fwrite(&header, sizeof(header), 1, file) != 1 ||
+            fwrite(kpf_xref_index_cached, sizeof(struct kpf_xref_entry), kpf_xref_index_count_cached, file) != kpf_xref_index_count_cached;
+  if (fclose(file) || ret || rename(tmp_path, path)) {
+    x8A4_log_debug("Failed to write xref index %s (%d:%s)\n", path, errno, strerror(errno));
+    remove(tmp_path);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief           Load or build the xref index for a section, small sections only since every xref is kept
+ * @param[in]       section
+ * @return          Zero when the index covers the section
+ */
+int kpf_xref_index_init(PFSection *section) {
+  if (!section) {
+    return -1;
+  }
+  kpf_lock();
+  int ret = 0;
+  if (kpf_xref_index_section_cached != section) {
+    kpf_xref_index_free();
+    ret = -1;
+    uint8_t uuid[0x10] = {0};
+    int has_uuid = !kpf_xref_kernel_uuid(uuid);
+    if (section->size <= KPF_XREF_INDEX_SECTION_MAX) {
+      if (has_uuid && !kpf_xref_index_load(section, uuid)) {
+        ret = 0;
+      } else if (!kpf_xref_index_build(section)) {
+        ret = 0;
+        if (has_uuid) {
+          kpf_xref_index_save(uuid);
+        }
+      }
+    }
+  }
+  kpf_unlock();
+  return ret;
+}
+
+/**
+ * @brief           Look up the sources referencing a target, in address order
+ * @param[in]       target
+ * @param[in]       types
+ * @param[out]      refs
+ * @param[in]       max
+ * @return          Number of sources found
+ */
+int kpf_xref_index_refs(uint64_t target, uint32_t types, uint64_t *refs, int max) {
+  size_t lo = 0;
+  size_t hi = kpf_xref_index_count_cached;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (kpf_xref_index_cached[mid].target < target) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  int found = 0;
+  for (size_t i = lo; i < kpf_xref_index_count_cached && kpf_xref_index_cached[i].target == target && found < max; i++) {
+    if (types & (1U << kpf_xref_index_cached[i].type)) {
+      refs[found++] = kpf_xref_index_cached[i].source;
+    }
+  }
+  return found;
+}
+
+/**
+ * @brief           Fill the references of scan targets from the xref index, scanning the section when it has none
+ * @param[in]       section
+ * @param[in,out]   targets
+ * @param[in]       count
+ * @return          Number of targets left without a reference
+ */
+int kpf_xref_index_scan(PFSection *section, struct kpf_scan_target *targets, size_t count) {
+  if (!targets || kpf_xref_index_init(section)) {
+    return kpf_scan_xrefs(section, targets, count);
+  }
+  int missing = 0;
+  kpf_lock();
+  for (size_t i = 0; i < count; i++) {
+    struct kpf_scan_target *entry = &targets[i];
+    if (entry->refs_max > KPF_SCAN_REFS_MAX) {
+      entry->refs_max = KPF_SCAN_REFS_MAX;
+    }
+    if (entry->vmaddr && entry->refs_count < entry->refs_max) {
+      uint64_t refs[KPF_SCAN_REFS_MAX * 2] = {0};
+      int found = kpf_xref_index_refs(entry->vmaddr, ARM64_XREF_TYPE_MASK_REFERENCE, refs, entry->refs_count + entry->refs_max);
+      for (int j = 0; j < found && entry->refs_count < entry->refs_max; j++) {
+        int seen = 0;
+        for (int k = 0; k < entry->refs_count && !seen; k++) {
+          seen = entry->refs[k] == refs[j];
+        }
+        if (!seen) {
+          entry->refs[entry->refs_count++] = refs[j];
+        }
+      }
+    }
+    if (entry->refs_max && !entry->refs_count) {
+      missing++;
+    }
+  }
+  kpf_unlock();
+  return missing;
+}
+
+/**
+ * @brief           Drop the xref index
+ */
+void kpf_xref_index_free(void) {
+  kpf_lock();
+  free(kpf_xref_index_cached);
+  kpf_xref_index_cached = NULL;
+  kpf_xref_index_count_cached = 0;
+  kpf_xref_index_section_cached = NULL;
+  kpf_unlock();
+}
@@ -0,0 +1,319 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kregistry.c
+ * @author Cryptiiiic
+ * @brief This file is for finding service objects by walking the kernel IORegistry from its root.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <x8A4/Kernel/kernel.h>
+#include <x8A4/Kernel/kmem.h>
+#include <x8A4/Kernel/kpf.h>
+#include <x8A4/Kernel/kregistry.h>
+#include <x8A4/Kernel/offsets.h>
+#include <x8A4/Kernel/osobject.h>
+#include <x8A4/Kernel/slide.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+bool kregistry_preferred_cached = false;
+uint64_t kregistry_root_cached = 0;
+uint64_t kregistry_root_id_cached = 0;
+struct kregistry_cache_entry kregistry_cache_cached[KREGISTRY_CACHE_MAX] = {0};
+size_t kregistry_cache_count_cached = 0;
+
+/* Functions */
+/**
+ * @brief           Prefer the registry route over our ipc space when resolving service kobjects
+ * @param[in]       preferred
+ */
+void kregistry_set_preferred(bool preferred) {
+  kregistry_preferred_cached = preferred;
+}
+
+/**
+ * @brief           Find a registry entry address by its registry entry ID
+ * @param[in]       id
+ * @return          Address of the registry entry, zero if not cached
+ */
+uint64_t kregistry_cache_find(uint64_t id) {
+  for (size_t i = 0; i < kregistry_cache_count_cached; i++) {
+    if (kregistry_cache_cached[i].id == id) {
+      return kregistry_cache_cached[i].entry;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief           Remember a registry entry address for the session
+ * @param[in]       id
+ * @param[in]       entry
+ */
+void kregistry_cache_store(uint64_t id, uint64_t entry) {
+  if (kregistry_cache_find(id) || kregistry_cache_count_cached == KREGISTRY_CACHE_MAX) {
+    return;
+  }
+  kregistry_cache_cached[kregistry_cache_count_cached++] = (struct kregistry_cache_entry){id, entry};
+}
+
+/**
+ * @brief           Read the registry entry IDs of several registry entries
+ * @param[in]       entries
+ * @param[in]       count
+ * @param[out]      ids
+ * @return          Number of entries whose ID could not be read
+ */
+int kregistry_entry_ids(const uint64_t *entries, size_t count, uint64_t *ids) {
+  if (!entries || !ids || !count) {
+    return (int)count;
+  }
+  uint64_t *reserved = (uint64_t *)calloc(count, sizeof(uint64_t));
+  struct kmem_read_req *reqs = (struct kmem_read_req *)calloc(count, sizeof(struct kmem_read_req));
+  if (!reserved || !reqs) {
+    x8A4_log_error("Failed to calloc memory for registry entry IDs!\n", "");
+    free(reserved);
+    free(reqs);
+    return (int)count;
+  }
+  size_t reqs_count = 0;
+  for (size_t i = 0; i < count; i++) {
+    ids[i] = 0;
+    if (entries[i]) {
+      reqs[reqs_count++] = (struct kmem_read_req){entries[i] + koffsets_cached->io_registry_reserved, &reserved[i], sizeof(uint64_t), 0, NULL};
+    }
+  }
+  kmem_read_batch(reqs, reqs_count);
+  for (size_t i = 0, j = 0; i < count; i++) {
+    if (entries[i] && reqs[j++].ret) {
+      reserved[i] = 0;
+    }
+    unsign_ptr(&reserved[i]);
+  }
+  reqs_count = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (reserved[i]) {
+      reqs[reqs_count++] = (struct kmem_read_req){reserved[i] + koffsets_cached->io_registry_reserved_id, &ids[i], sizeof(uint64_t), 0, NULL};
+    }
+  }
+  kmem_read_batch(reqs, reqs_count);
+  int failed = 0;
+  for (size_t i = 0, j = 0; i < count; i++) {
+    if (reserved[i] && reqs[j++].ret) {
+      ids[i] = 0;
+    }
+    failed += ids[i] ? 0 : 1;
+  }
+  free(reserved);
+  free(reqs);
+  return failed;
+}
+
+/**
+ * @brief           Read the registry entry ID of a registry entry
+ * @param[in]       entry
+ * @return          Registry entry ID, zero on failure
+ */
+uint64_t kregistry_entry_id(uint64_t entry) {
+  uint64_t id = 0;
+  kregistry_entry_ids(&entry, 1, &id);
+  return id;
+}
+
+/**
+ * @brief           Read the children of a registry entry in a plane
+ * @param[in]       entry
+ * @param[in]       plane
+ * @param[out]      out
+ * @return          Number of children, *out must be freed by the caller
+ */
+size_t kregistry_children(uint64_t entry, const char *plane, uint64_t **out) {
+  if (!entry || !plane || !out) {
+    return 0;
+  }
+  *out = NULL;
+  uint64_t table = 0;
+  int ret = kmem_read(entry + koffsets_cached->io_registry_table, &table, sizeof(uint64_t));
+  if (ret || !table) {
+    x8A4_log_debug_error("Failed to read registry table of 0x%016llX! (%d)\n", entry, ret);
+    return 0;
+  }
+  unsign_ptr(&table);
+  char key[0x80] = {0};
+  snprintf(key, sizeof(key), "%sChildLinks", plane);
+  uint64_t links = get_value_from_os_dict(table, key);
+  if (!links) {
+    return 0;
+  }
+  uint32_t count = 0;
+  uint64_t array = 0;
+  struct kmem_read_req reqs[2] = {
+    {links + koffsets_cached->os_array_size, &count, sizeof(uint32_t), 0, NULL},
+    {links + koffsets_cached->os_array, &array, sizeof(uint64_t), 0, NULL},
+  };
+  kmem_read_batch(reqs, 2);
+  if (reqs[0].ret || reqs[1].ret || !count || !array || count > KREGISTRY_CHILDREN_MAX) {
+    x8A4_log_debug_error("Failed to read %s of 0x%016llX! (%u:0x%016llX)\n", key, entry, count, array);
+    return 0;
+  }
+  unsign_ptr(&array);
+  uint64_t *children = (uint64_t *)calloc(count, sizeof(uint64_t));
+  if (!children) {
+    x8A4_log_error("Failed to calloc memory for registry children!\n", "");
+    return 0;
+  }
+  ret = kmem_read(array, children, count * sizeof(uint64_t));
+  if (ret) {
+    x8A4_log_debug_error("Failed to read %s array 0x%016llX! (%d)\n", key, array, ret);
+    free(children);
+    return 0;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    unsign_ptr(&children[i]);
+  }
+  *out = children;
+  return count;
+}
+
+/**
+ * @brief           Find the kernel's registry root, checking each patchfound gRegistryRoot candidate against the root's registry entry ID
+ * @return          Address of the registry root entry
+ */
+uint64_t kregistry_root(void) {
+  if (kregistry_root_cached) {
+    return kregistry_root_cached;
+  }
+  io_registry_entry_t root = IORegistryGetRootEntry(kIOMasterPortDefault);
+  if (root == IO_OBJECT_NULL) {
+    x8A4_log_error("Failed to get registry root entry!\n", "");
+    return 0;
+  }
+  uint64_t root_id = 0;
+  kern_return_t kr = IORegistryEntryGetRegistryEntryID(root, &root_id);
+  IOObjectRelease(root);
+  if (kr != KERN_SUCCESS || !root_id) {
+    x8A4_log_error("Failed to get registry root entry ID!\n", "");
+    return 0;
+  }
+  uint64_t candidates[KPF_REGISTRY_ROOT_CANDIDATES_MAX] = {0};
+  int candidates_count = xpf_find_registry_root_candidates(candidates, KPF_REGISTRY_ROOT_CANDIDATES_MAX);
+  for (int i = 0; i < candidates_count; i++) {
+    uint64_t entry = 0;
+    if (kmem_read(candidates[i] + get_slide(), &entry, sizeof(uint64_t)) || !entry) {
+      continue;
+    }
+    unsign_ptr(&entry);
+    if (kregistry_entry_id(entry) == root_id) {
+      x8A4_log_debug("gRegistryRoot: 0x%016llX -> 0x%016llX\n", candidates[i], entry);
+      kregistry_root_cached = entry;
+      kregistry_root_id_cached = root_id;
+      kregistry_cache_store(root_id, entry);
+      return entry;
+    }
+  }
+  x8A4_log_error("Failed to find kernel registry root!\n", "");
+  return 0;
+}
+
+/**
+ * @brief           Get the registry entry IDs from an entry up to the registry root in a plane
+ * @param[in]       entry
+ * @param[in]       plane
+ * @param[out]      ids
+ * @param[in]       max
+ * @return          Number of IDs, the entry's own ID first
+ */
+size_t kregistry_id_chain(io_registry_entry_t entry, const char *plane, uint64_t *ids, size_t max) {
+  size_t count = 0;
+  io_registry_entry_t current = entry;
+  while (current != IO_OBJECT_NULL && count < max) {
+    if (IORegistryEntryGetRegistryEntryID(current, &ids[count]) != KERN_SUCCESS) {
+      break;
+    }
+    count++;
+    io_registry_entry_t parent = IO_OBJECT_NULL;
+    kern_return_t kr = IORegistryEntryGetParentEntry(current, plane, &parent);
+    if (current != entry) {
+      IOObjectRelease(current);
+    }
+    current = kr == KERN_SUCCESS ? parent : IO_OBJECT_NULL;
+  }
+  if (current != IO_OBJECT_NULL && current != entry) {
+    IOObjectRelease(current);
+  }
+  return count;
+}
+
+/**
+ * @brief           Find a service's kernel object by walking down from the registry root along the service's ancestry
+ * @param[in]       service
+ * @return          Address of the service object
+ */
+uint64_t kregistry_find_service(io_registry_entry_t service) {
+  if (!kregistry_root()) {
+    return 0;
+  }
+  const char *planes[] = {kIOServicePlane, kIODeviceTreePlane};
+  for (size_t p = 0; p < sizeof(planes) / sizeof(planes[0]); p++) {
+    uint64_t ids[KREGISTRY_DEPTH_MAX] = {0};
+    size_t depth = kregistry_id_chain(service, planes[p], ids, KREGISTRY_DEPTH_MAX);
+    if (!depth || ids[depth - 1] != kregistry_root_id_cached) {
+      continue;
+    }
+    long level = (long)depth - 1;
+    uint64_t entry = kregistry_root_cached;
+    for (size_t k = 0; k < depth; k++) {
+      uint64_t cached = kregistry_cache_find(ids[k]);
+      if (cached) {
+        level = (long)k;
+        entry = cached;
+        break;
+      }
+    }
+    while (entry && level > 0) {
+      level--;
+      uint64_t *children = NULL;
+      size_t children_count = kregistry_children(entry, planes[p], &children);
+      uint64_t *children_ids = children_count ? (uint64_t *)calloc(children_count, sizeof(uint64_t)) : NULL;
+      entry = 0;
+      if (children_ids) {
+        kregistry_entry_ids(children, children_count, children_ids);
+        for (size_t i = 0; i < children_count; i++) {
+          if (children_ids[i] == ids[level]) {
+            entry = children[i];
+            kregistry_cache_store(ids[level], entry);
+            break;
+          }
+        }
+      }
+      free(children);
+      free(children_ids);
+    }
+    if (entry) {
+      x8A4_log_debug("Found service 0x%X in the %s plane: 0x%016llX\n", service, planes[p], entry);
+      return entry;
+    }
+  }
+  x8A4_log_debug_error("Failed to find service 0x%X in the kernel registry!\n", service);
+  return 0;
+}
+
+/**
+ * @brief           Drop the cached registry root and entries
+ */
+void kregistry_cache_flush(void) {
+  memset(kregistry_cache_cached, 0, sizeof(kregistry_cache_cached));
+  kregistry_cache_count_cached = 0;
+  kregistry_root_cached = 0;
+  kregistry_root_id_cached = 0;
+}
@@ -0,0 +1,309 @@
+//
+// Created by cryptic on 10/16/26.
+//
+
+/**
+ * @file kwalk.c
+ * @author Cryptiiiic
+ * @brief This file is for walking kernel object graphs declared against the kernel offsets.
+ * @version 1.0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+/* Include headers */
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <x8A4/Kernel/kernel.h>
+#include <x8A4/Kernel/kmem.h>
+#include <x8A4/Kernel/kwalk.h>
+#include <x8A4/Logger/logger.h>
+
+/* Cached Variables */
+struct kwalk_cache_entry kwalk_cache_cached[KWALK_CACHE_MAX] = {0};
+size_t kwalk_cache_count_cached = 0;
+size_t kwalk_cache_next_cached = 0;
+
+/* Functions */
+/**
+ * @brief           Get a kernel offset by its byte offset in struct kernel_offsets
+ * @param[in]       field
+ * @return          Value of the kernel offset, zero for KWALK_NONE
+ */
+uint64_t kwalk_offset(uint16_t field) {
+  if (field == KWALK_NONE) {
+    return 0;
+  }
+  return *(const uint64_t *)((const uint8_t *)koffsets_cached + field);
+}
+
+/**
+ * @brief           Check if a path or one of its prefixes depends on the per item parameter
+ * @param[in]       path
+ * @return          Non zero if indexed
+ */
+int kwalk_path_indexed(const struct kwalk_path *path) {
+  for (; path; path = path->parent) {
+    for (uint32_t i = 0; i < path->count; i++) {
+      if (path->steps[i].op == KWALK_INDEX) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief           Find a resolved path in the prefix cache
+ * @param[in]       path
+ * @param[in]       root
+ * @param[in]       param
+ * @return          Pointer to the cache entry, NULL on miss
+ */
+struct kwalk_cache_entry *kwalk_cache_find(const struct kwalk_path *path, uint64_t root, uint64_t param) {
+  for (size_t i = 0; i < kwalk_cache_count_cached; i++) {
+    struct kwalk_cache_entry *entry = &kwalk_cache_cached[i];
+    if (entry->path == path && entry->root == root && entry->param == param) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief           Store a resolved path in the prefix cache, replacing the oldest entry when full
+ * @param[in]       path
+ * @param[in]       root
+ * @param[in]       param
+ * @param[in]       value
+ */
+void kwalk_cache_store(const struct kwalk_path *path, uint64_t root, uint64_t param, uint64_t value) {
+  struct kwalk_cache_entry *entry = NULL;
+  if (kwalk_cache_count_cached < KWALK_CACHE_MAX) {
+    entry = &kwalk_cache_cached[kwalk_cache_count_cached++];
+  } else {
+    entry = &kwalk_cache_cached[kwalk_cache_next_cached];
+    kwalk_cache_next_cached = (kwalk_cache_next_cached + 1) % KWALK_CACHE_MAX;
+  }
+  *entry = (struct kwalk_cache_entry){path, root, param, value};
+}
+
+/**
+ * @brief           Check that a value is an unsigned kernel pointer
+ * @param[in]       value
+ * @return          Non zero if valid
+ */
+int kwalk_is_kptr(uint64_t value) {
+  uint64_t mask = ~((1ULL << (64U - koffsets_cached->t1sz_boot)) - 1U);
+  return value && (value & mask) == mask;
+}
+
+/**
+ * @brief           Run one step of a path over every live item, batching the loads of sibling items
+ * @param[in]       path
+ * @param[in]       index
+ * @param[in,out]   addrs
+ * @param[in]       params
+ * @param[in]       count
+ * @param[in]       reqs
+ */
+void kwalk_step(const struct kwalk_path *path, uint32_t index, uint64_t *addrs, const uint64_t *params, size_t count, struct kmem_read_req *reqs) {
+  const struct kwalk_step *step = &path->steps[index];
+  if (step->cond != KWALK_NONE && !kwalk_offset(step->cond)) {
+    return;
+  }
+  uint64_t offset = kwalk_offset(step->field);
+  size_t reqs_count = 0;
+  for (size_t k = 0; k < count; k++) {
+    if (!addrs[k]) {
+      continue;
+    }
+    switch (step->op) {
+      case KWALK_LOAD:
+        reqs[reqs_count++] = (struct kmem_read_req){addrs[k] + offset, &addrs[k], sizeof(uint64_t), 0, NULL};
+        break;
+      case KWALK_ADD:
+        addrs[k] += offset;
+        break;
+      case KWALK_INDEX:
+        addrs[k] += params[k] * offset;
+        break;
+      case KWALK_UNSIGN:
+        unsign_ptr(&addrs[k]);
+        break;
+      case KWALK_SMR:
+        decode_smr_ptr(&addrs[k]);
+        break;
+      default:
+        addrs[k] = 0;
+        break;
+    }
+  }
+  if (reqs_count) {
+    kmem_read_batch(reqs, reqs_count);
+    for (size_t k = 0, j = 0; k < count && j < reqs_count; k++) {
+      if (reqs[j].buf != &addrs[k]) {
+        continue;
+      }
+      if (reqs[j].ret || !addrs[k]) {
+        x8A4_log_debug_error("kwalk %s step %u: failed to read 0x%016llX for item %zu\n", path->name, index, reqs[j].addr, k);
+        addrs[k] = 0;
+      }
+      j++;
+    }
+  }
+  for (size_t k = 0; k < count; k++) {
+    if (addrs[k] && (step->flags & KWALK_STEP_VALIDATE_KPTR) && !kwalk_is_kptr(addrs[k])) {
+      x8A4_log_debug_error("kwalk %s step %u: 0x%016llX is not a kernel pointer\n", path->name, index, addrs[k]);
+      addrs[k] = 0;
+    }
+  }
+}
+
+/**
+ * @brief           Resolve a path for several items sharing a root, reusing cached prefixes
+ * @param[in]       path
+ * @param[in]       root
+ * @param[in]       params
+ * @param[in]       count
+ * @param[out]      out
+ * @return          Number of items that failed to resolve
+ */
+int kwalk_resolve_batch(const struct kwalk_path *path, uint64_t root, const uint64_t *params, size_t count, uint64_t *out) {
+  if (!path || !out || !count) {
+    return (int)count;
+  }
+  int indexed = kwalk_path_indexed(path);
+  size_t *pending = (size_t *)calloc(count, sizeof(size_t));
+  uint64_t *pending_params = (uint64_t *)calloc(count, sizeof(uint64_t));
+  uint64_t *addrs = (uint64_t *)calloc(count, sizeof(uint64_t));
+  struct kmem_read_req *reqs = (struct kmem_read_req *)calloc(count, sizeof(struct kmem_read_req));
+  if (!pending || !pending_params || !addrs || !reqs) {
+    x8A4_log_error("Failed to calloc memory for kwalk %s!\n", path->name);
+    free(pending);
+    free(pending_params);
+    free(addrs);
+    free(reqs);
+    return (int)count;
+  }
+  size_t pending_count = 0;
+  for (size_t i = 0; i < count; i++) {
+    uint64_t param = (indexed && params) ? params[i] : 0;
+    struct kwalk_cache_entry *entry = (path->flags & KWALK_PATH_CACHED) ? kwalk_cache_find(path, root, param) : NULL;
+    out[i] = entry ? entry->value : 0;
+    if (!entry) {
+      pending[pending_count] = i;
+      pending_params[pending_count++] = param;
+    }
+  }
+  if (path->parent && kwalk_path_indexed(path->parent)) {
+    kwalk_resolve_batch(path->parent, root, pending_params, pending_count, addrs);
+  } else if (pending_count) {
+    uint64_t base = root;
+    if (path->parent && kwalk_resolve(path->parent, root, 0, &base)) {
+      base = 0;
+    }
+    for (size_t k = 0; k < pending_count; k++) {
+      addrs[k] = base;
+    }
+  }
+  for (uint32_t s = 0; s < path->count && pending_count; s++) {
+    kwalk_step(path, s, addrs, pending_params, pending_count, reqs);
+  }
+  int failed = 0;
+  for (size_t k = 0; k < pending_count; k++) {
+    out[pending[k]] = addrs[k];
+    if (!addrs[k]) {
+      failed++;
+    } else if (path->flags & KWALK_PATH_CACHED) {
+      kwalk_cache_store(path, root, pending_params[k], addrs[k]);
+    }
+  }
+  free(pending);
+  free(pending_params);
+  free(addrs);
+  free(reqs);
+  return failed;
+}
+
+/**
+ * @brief           Resolve a root level path for several items that each have their own root
+ * @param[in]       path
+ * @param[in]       roots
+ * @param[in]       count
+ * @param[out]      out
+ * @return          Number of items that failed to resolve
+ */
+int kwalk_resolve_roots(const struct kwalk_path *path, const uint64_t *roots, size_t count, uint64_t *out) {
+  if (!path || path->parent || !roots || !out || !count) {
+    return (int)count;
+  }
+  size_t *pending = (size_t *)calloc(count, sizeof(size_t));
+  uint64_t *params = (uint64_t *)calloc(count, sizeof(uint64_t));
+  uint64_t *addrs = (uint64_t *)calloc(count, sizeof(uint64_t));
+  struct kmem_read_req *reqs = (struct kmem_read_req *)calloc(count, sizeof(struct kmem_read_req));
+  if (!pending || !params || !addrs || !reqs) {
+    x8A4_log_error("Failed to calloc memory for kwalk %s!\n", path->name);
+    free(pending);
+    free(params);
+    free(addrs);
+    free(reqs);
+    return (int)count;
+  }
+  size_t pending_count = 0;
+  for (size_t i = 0; i < count; i++) {
+    struct kwalk_cache_entry *entry = (path->flags & KWALK_PATH_CACHED) ? kwalk_cache_find(path, roots[i], 0) : NULL;
+    out[i] = entry ? entry->value : 0;
+    if (!entry) {
+      pending[pending_count] = i;
+      addrs[pending_count++] = roots[i];
+    }
+  }
+  for (uint32_t s = 0; s < path->count && pending_count; s++) {
+    kwalk_step(path, s, addrs, params, pending_count, reqs);
+  }
+  int failed = 0;
+  for (size_t k = 0; k < pending_count; k++) {
+    out[pending[k]] = addrs[k];
+    if (!addrs[k]) {
+      failed++;
+    } else if (path->flags & KWALK_PATH_CACHED) {
+      kwalk_cache_store(path, roots[pending[k]], 0, addrs[k]);
+    }
+  }
+  free(pending);
+  free(params);
+  free(addrs);
+  free(reqs);
+  return failed;
+}
+
+/**
+ * @brief           Resolve a path from a root, reusing cached prefixes
+ * @param[in]       path
+ * @param[in]       root
+ * @param[in]       param
+ * @param[out]      out
+ * @return          Zero on success
+ */
+int kwalk_resolve(const struct kwalk_path *path, uint64_t root, uint64_t param, uint64_t *out) {
+  if (!out) {
+    return EINVAL;
+  }
+  if (kwalk_resolve_batch(path, root, &param, 1, out)) {
+    x8A4_log_debug_error("Failed to resolve kwalk %s from 0x%016llX (0x%llX)\n", path ? path->name : "(null)", root, param);
+    return EFAULT;
+  }
+  return 0;
+}
+
+/**
+ * @brief           Drop every cached path
+ */
+void kwalk_cache_flush(void) {
+  memset(kwalk_cache_cached, 0, sizeof(kwalk_cache_cached));
+  kwalk_cache_count_cached = 0;
+  kwalk_cache_next_cached = 0;
+}
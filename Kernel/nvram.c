@@ -13,7 +13,7 @@
  */
 
 /* Include headers */
-#include <libkrw.h>
+#include <x8A4/Kernel/kmem.h>
 #include <x8A4/Kernel/kernel.h>
 #include <x8A4/Kernel/offsets.h>
 #include <x8A4/Kernel/nvram.h>
@@ -25,24 +25,41 @@
 struct nvram_key *nvram_keys_cached;
 int nvram_keys_count_cached = -1;
 
+/* Structure Variables */
+const struct kwalk_step kwalk_nvram_dict_steps[] = {
+  KWALK_STEP_KPTR(KWALK_LOAD, KWALK_FIELD(io_dt_nvram)),
+};
+const struct kwalk_path kwalk_nvram_dict_path = {"nvram_dict", NULL, 0, 1, kwalk_nvram_dict_steps};
+
 /* Functions */
 /**
- * @brief           Gets a service's nvram dict from it's kobject
+ * @brief           Gets a service's nvram dict from it's kobject, reusing the cached dict while an uncached read shows the
+ *                  kobject still points at it
  * @param[in]       service
  * @return          Address of the nvram dict
  */
 uint64_t get_service_nvram_dict(io_service_t service) {
-  uint64_t kobject = get_ipc_kobject(service);
-  if (!kobject) {
+  struct service_object_cache_entry *entry = service_object_cache_find(service);
+  if (entry && entry->nvram_dict) {
+    uint64_t nvram_dict = 0;
+    int ret = kmem_backend_read(entry->kobject + koffsets_cached->io_dt_nvram, &nvram_dict, sizeof(uint64_t));
+    if (!ret && nvram_dict == entry->nvram_dict) {
+      return nvram_dict;
+    }
+    x8A4_log_debug("Service 0x%X nvram dict changed, resolving it again\n", service);
+  }
+  entry = service_object_cache_get(service);
+  if (!entry) {
     x8A4_log_error("Kobject is NULL!\n", "");
     return 0;
   }
   uint64_t nvram_dict = 0;
-  int ret = kread(kobject + koffsets_cached->io_dt_nvram, &nvram_dict, 8);
+  int ret = kwalk_resolve(&kwalk_nvram_dict_path, entry->kobject, 0, &nvram_dict);
   if (ret || !nvram_dict) {
     x8A4_log_error("Failed to read kernel nvram dict from kobject! (%d: 0x%016llX)\n", ret, nvram_dict);
     return 0;
   }
+  entry->nvram_dict = nvram_dict;
   return nvram_dict;
 }
 
@@ -152,7 +169,7 @@ uint8_t *get_nvram_entry_bytes(uint64_t nvram_dict, const char *key, enum os_typ
     x8A4_log_debug("out_size: 0x%08X\n", *out_size);
   }
   uint8_t *entry_bytes = (uint8_t *)calloc(1, *out_size + 1);
-  int ret = kread(entry_addr, entry_bytes, *out_size);
+  int ret = kmem_read(entry_addr, entry_bytes, *out_size);
   if (ret) {
     if (entry_bytes)
       free(entry_bytes);
@@ -203,12 +220,12 @@ int set_nvram_entry_bytes(uint64_t nvram_dict, const char *key,
     return -1;
   }
   uint64_t read_test = 0;
-  int ret = kread(entry_addr, &read_test, 8);
+  int ret = kmem_read(entry_addr, &read_test, 8);
   if (ret) {
     x8A4_log_error("!kread (%d)\n", ret);
     return -1;
   }
-  ret = kwrite(entry_bytes, entry_addr, size);
+  ret = kmem_write(entry_bytes, entry_addr, size);
   if (ret) {
     x8A4_log_error("!kwrite (%d)\n", ret);
     return -1;
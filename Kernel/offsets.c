@@ -13,6 +13,7 @@
  */
 
 /* Include headers */
+#include <x8A4/Kernel/kpf_cache.h>
 #include <x8A4/Kernel/offsets.h>
 #include <x8A4/Kernel/osobject.h>
 #include <x8A4/Logger/logger.h>
@@ -27,12 +28,8 @@ struct kernel_offsets *koffsets_cached;
  * @return         Zero on init success
  */
 int offsets_init(void) {
-  if (!gXPF.kernel || !gXPF.kernelSize) {
-    x8A4_log_error("Failed XPF kernel is NULL!\n", "");
-    return -1;
-  }
-  if (!gXPF.darwinVersion) {
-    x8A4_log_error("Failed XPF kernel darwinVersion is NULL!\n", "");
+  if (!gXPF.darwinVersion || !gXPF.xnuBuild) {
+    x8A4_log_error("Failed XPF kernel darwinVersion or xnuBuild is NULL!\n", "");
     return -1;
   }
   if(strcmp(gXPF.darwinVersion, "16.0.0") < 0) {
@@ -68,6 +65,7 @@ int offsets_init(void) {
   koffsets_cached->table_smr = 0x0;
   koffsets_cached->smr = 0x0;
   koffsets_cached->ipc_entry_object = 0x0;
+  koffsets_cached->ipc_entry_bits = 0x8;
   koffsets_cached->ipc_entry_size = 0x18;
   koffsets_cached->ipc_port_kobject = 0x68;
   koffsets_cached->ipc_port_kobject_is_iomachport = 0x0;
@@ -75,6 +73,11 @@ int offsets_init(void) {
   koffsets_cached->io_dt_nvram = 0xC0;
   koffsets_cached->os_dict = 0x20;
   koffsets_cached->os_dict_size = 0x14;
+  koffsets_cached->os_array = 0x20;
+  koffsets_cached->os_array_size = 0x14;
+  koffsets_cached->io_registry_reserved = 0x10;
+  koffsets_cached->io_registry_reserved_id = 0x8;
+  koffsets_cached->io_registry_table = 0x18;
   koffsets_cached->os_string = 0x10;
   koffsets_cached->os_metabase_size = 0xC;
   koffsets_cached->os_data = 0x18;
@@ -138,7 +141,7 @@ int offsets_init(void) {
   koffsets_cached->os_list[OS_DATA] = koffsets_cached->os_data;
   koffsets_cached->os_list[OS_STRING] = koffsets_cached->os_string;
   if (!koffsets_cached->t1sz_boot) {
-    koffsets_cached->t1sz_boot = xpf_item_resolve("kernelConstant.T1SZ_BOOT");
+    koffsets_cached->t1sz_boot = kpf_cache_item_resolve("kernelConstant.T1SZ_BOOT");
     if (!koffsets_cached->t1sz_boot) {
       x8A4_log_error("Failed to find kernel T1SZ_BOOT!\n", "");
       return 0;
@@ -146,7 +149,7 @@ int offsets_init(void) {
   }
   if (!koffsets_cached->itk_space) {
     koffsets_cached->itk_space =
-        xpf_item_resolve("kernelStruct.task.itk_space");
+        kpf_cache_item_resolve("kernelStruct.task.itk_space");
     if (!koffsets_cached->itk_space) {
       x8A4_log_error("Failed to find kernel task itk_space!\n", "");
       return 0;
@@ -154,14 +157,14 @@ int offsets_init(void) {
   }
   if (!koffsets_cached->proc_struct_size) {
     koffsets_cached->proc_struct_size =
-        xpf_item_resolve("kernelStruct.proc.struct_size");
+        kpf_cache_item_resolve("kernelStruct.proc.struct_size");
     if (!koffsets_cached->proc_struct_size) {
       x8A4_log_error("Failed to find kernel proc_struct_size!\n", "");
       return 0;
     }
   }
   if (!koffsets_cached->all_proc) {
-    koffsets_cached->all_proc = xpf_item_resolve("kernelSymbol.allproc");
+    koffsets_cached->all_proc = kpf_cache_item_resolve("kernelSymbol.allproc");
     if (!koffsets_cached->all_proc) {
       x8A4_log_error("Failed to find kernel proc all_proc!\n", "");
       return 0;
@@ -178,6 +181,7 @@ int offsets_init(void) {
     x8A4_log_debug("koffsets_cached->table_smr: 0x%016llX\n", koffsets_cached->table_smr);
     x8A4_log_debug("koffsets_cached->smr: 0x%016llX\n", koffsets_cached->smr);
     x8A4_log_debug("koffsets_cached->ipc_entry_object: 0x%016llX\n", koffsets_cached->ipc_entry_object);
+    x8A4_log_debug("koffsets_cached->ipc_entry_bits: 0x%016llX\n", koffsets_cached->ipc_entry_bits);
     x8A4_log_debug("koffsets_cached->ipc_entry_size: 0x%016llX\n", koffsets_cached->ipc_entry_size);
     x8A4_log_debug("koffsets_cached->ipc_port_kobject: 0x%016llX\n", koffsets_cached->ipc_port_kobject);
     x8A4_log_debug("koffsets_cached->ipc_port_kobject_is_iomachport: 0x%016llX\n", koffsets_cached->ipc_port_kobject_is_iomachport);
@@ -186,6 +190,11 @@ int offsets_init(void) {
     x8A4_log_debug("koffsets_cached->io_dt_nvram: 0x%016llX\n", koffsets_cached->io_dt_nvram);
     x8A4_log_debug("koffsets_cached->os_dict: 0x%016llX\n", koffsets_cached->os_dict);
     x8A4_log_debug("koffsets_cached->os_dict_size: 0x%016llX\n", koffsets_cached->os_dict_size);
+    x8A4_log_debug("koffsets_cached->os_array: 0x%016llX\n", koffsets_cached->os_array);
+    x8A4_log_debug("koffsets_cached->os_array_size: 0x%016llX\n", koffsets_cached->os_array_size);
+    x8A4_log_debug("koffsets_cached->io_registry_reserved: 0x%016llX\n", koffsets_cached->io_registry_reserved);
+    x8A4_log_debug("koffsets_cached->io_registry_reserved_id: 0x%016llX\n", koffsets_cached->io_registry_reserved_id);
+    x8A4_log_debug("koffsets_cached->io_registry_table: 0x%016llX\n", koffsets_cached->io_registry_table);
     x8A4_log_debug("koffsets_cached->os_string: 0x%016llX\n", koffsets_cached->os_string);
     x8A4_log_debug("koffsets_cached->os_metabase_size: 0x%016llX\n", koffsets_cached->os_metabase_size);
     x8A4_log_debug("koffsets_cached->os_data: 0x%016llX\n", koffsets_cached->os_data);
@@ -13,12 +13,37 @@
  */
 
 /* Include headers */
-#include <libkrw.h>
+#include <x8A4/Kernel/kmem.h>
+#include <x8A4/Kernel/kmem_prefetch.h>
+#include <x8A4/Kernel/kmem_string.h>
 #include <x8A4/Kernel/kernel.h>
 #include <x8A4/Kernel/offsets.h>
 #include <x8A4/Kernel/osobject.h>
 #include <x8A4/Logger/logger.h>
 
+/* Cached Variables */
+struct kmem_prefetch_field os_dict_entry_prefetch_fields_cached[2] = {0};
+struct kmem_prefetch_desc os_dict_entry_prefetch_cached = {"os_dict_entry", 2, os_dict_entry_prefetch_fields_cached};
+
+/* Functions */
+/**
+ * @brief           Get the prefetch descriptor for an OS dict entry, covering the fields read from its key and value objects
+ * @return          Pointer to the prefetch descriptor
+ */
+const struct kmem_prefetch_desc *get_os_dict_entry_prefetch(void) {
+  if (!os_dict_entry_prefetch_fields_cached[0].len) {
+    uint32_t len = koffsets_cached->os_metabase_size + sizeof(uint32_t);
+    for (int i = OS_DATA; i <= OS_STRING; i++) {
+      if (koffsets_cached->os_list[i] + sizeof(uint64_t) > len) {
+        len = koffsets_cached->os_list[i] + sizeof(uint64_t);
+      }
+    }
+    os_dict_entry_prefetch_fields_cached[0] = (struct kmem_prefetch_field){offsetof(struct os_dict_entry, key), len, 0};
+    os_dict_entry_prefetch_fields_cached[1] = (struct kmem_prefetch_field){offsetof(struct os_dict_entry, val), len, 0};
+  }
+  return &os_dict_entry_prefetch_cached;
+}
+
 /**
  * @brief           Cast an OSObject to a new type
  * @param[in]       object
@@ -27,7 +52,7 @@
  */
 uint64_t os_object_cast(uint64_t object, enum os_type type) {
   uint64_t out = 0;
-  int ret = kread(object + koffsets_cached->os_list[type], &out, 8);
+  int ret = kmem_read(object + koffsets_cached->os_list[type], &out, 8);
   if (ret || !out) {
     return 0;
   }
@@ -41,7 +66,7 @@ uint64_t os_object_cast(uint64_t object, enum os_type type) {
  */
 uint32_t get_os_metabase_size(uint64_t object) {
   uint32_t object_len = 0;
-  int ret = kread(object + koffsets_cached->os_metabase_size, &object_len, 4);
+  int ret = kmem_read(object + koffsets_cached->os_metabase_size, &object_len, 4);
   if (ret || !object_len) {
     return 0;
   }
@@ -58,7 +83,7 @@ uint64_t get_os_dict_from_os_object(uint64_t os_object) {
     return 0;
   }
   uint64_t dict_entry = 0;
-  int ret = kread(os_object + koffsets_cached->os_dict, &dict_entry, 8);
+  int ret = kmem_read(os_object + koffsets_cached->os_dict, &dict_entry, 8);
   if (ret || !dict_entry) {
     x8A4_log_error("Failed to read kernel os dict from nvram dict! (%d:0x%016llX)\n", ret, dict_entry);
     return 0;
@@ -76,7 +101,7 @@ uint32_t get_os_dict_size(uint64_t dict) {
     return 0;
   }
   uint32_t dict_size = 0;
-  int ret = kread(dict + koffsets_cached->os_dict_size, &dict_size, 8);
+  int ret = kmem_read(dict + koffsets_cached->os_dict_size, &dict_size, 8);
   if (ret || !dict_size) {
     x8A4_log_error("Failed to read kernel os dict size from os dict! (%d:0x%08X)\n", ret, dict_size);
     return 0;
@@ -101,15 +126,12 @@ uint32_t extract_os_size(uint32_t *size) {
 
 
 /**
- * @brief           Get the matching key entry from an OS dict
+ * @brief           Get the value object stored under a key in an OS dict
  * @param[in]       dict
- * @param[in]       entry_type
  * @param[in]       entry_key
- * @param[out]      out_size
- * @return          Address of the entry
+ * @return          Address of the value object
  */
-uint64_t get_entry_from_os_dict(uint64_t dict, enum os_type entry_type,
-                                   const char *entry_key, uint32_t *out_size) {
+uint64_t get_value_from_os_dict(uint64_t dict, const char *entry_key) {
   if (!dict) {
     x8A4_log_error("Failed to get entry from os dict, dict is NULL!\n", "");
     return 0;
@@ -133,45 +155,113 @@ uint64_t get_entry_from_os_dict(uint64_t dict, enum os_type entry_type,
     x8A4_log_error("Failed to get entry from os dict, os dict size is zero!\n", "");
     return 0;
   }
-  int ret;
-  uint64_t data = 0;
-  struct os_dict_entry current_entry = {0};
-  for (int i = 0; i < os_dict_size + 1; i++) {
-    ret = kread(os_dict_entry + (i * sizeof(struct os_dict_entry)),
-                &current_entry, sizeof(struct os_dict_entry));
-    if (ret || !current_entry.key) {
-      x8A4_log_debug_error("Failed to read kernel entry from os dict! (%d)\n", ret);
+  size_t entry_count = os_dict_size + 1;
+  struct os_dict_entry *entries = (struct os_dict_entry *)calloc(entry_count, sizeof(struct os_dict_entry));
+  uint32_t *key_lens = (uint32_t *)calloc(entry_count, sizeof(uint32_t));
+  uint64_t *keys = (uint64_t *)calloc(entry_count, sizeof(uint64_t));
+  struct kmem_read_req *reqs = (struct kmem_read_req *)calloc(entry_count * 2, sizeof(struct kmem_read_req));
+  if (!entries || !key_lens || !keys || !reqs) {
+    x8A4_log_error("Failed to calloc memory for os dict entries!\n", "");
+    free(entries);
+    free(key_lens);
+    free(keys);
+    free(reqs);
+    return 0;
+  }
+  const void *mapped_entries = NULL;
+  int ret = kmem_map(os_dict_entry, entry_count * sizeof(struct os_dict_entry), &mapped_entries);
+  if (!ret) {
+    memcpy(entries, mapped_entries, entry_count * sizeof(struct os_dict_entry));
+  } else {
+    ret = kmem_read(os_dict_entry, entries, entry_count * sizeof(struct os_dict_entry));
+  }
+  if (ret) {
+    x8A4_log_debug_error("Failed to read kernel entries from os dict! (%d)\n", ret);
+    for (size_t i = 0; i < entry_count; i++) {
+      reqs[i] = (struct kmem_read_req){os_dict_entry + (i * sizeof(struct os_dict_entry)), &entries[i], sizeof(struct os_dict_entry), 0};
+    }
+    kmem_read_batch(reqs, entry_count);
+    for (size_t i = 0; i < entry_count; i++) {
+      if (reqs[i].ret) {
+        memset(&entries[i], 0, sizeof(struct os_dict_entry));
+      }
+    }
+  }
+  for (size_t i = 0; i < entry_count; i++) {
+    kmem_prefetch_struct(get_os_dict_entry_prefetch(), &entries[i], sizeof(struct os_dict_entry));
+  }
+  size_t reqs_count = 0;
+  for (size_t i = 0; i < entry_count; i++) {
+    if (!entries[i].key) {
       continue;
     }
-    uint32_t key_len = get_os_metabase_size(current_entry.key);
-    extract_os_size(&key_len);
-    if (!key_len) {
+    reqs[reqs_count++] = (struct kmem_read_req){entries[i].key + koffsets_cached->os_metabase_size, &key_lens[i], sizeof(uint32_t), 0};
+    reqs[reqs_count++] = (struct kmem_read_req){entries[i].key + koffsets_cached->os_list[OS_STRING], &keys[i], sizeof(uint64_t), 0};
+  }
+  kmem_read_batch(reqs, reqs_count);
+  for (size_t i = 0, j = 0; i < entry_count; i++) {
+    if (!entries[i].key) {
       continue;
     }
-    uint64_t key = os_object_cast(current_entry.key, OS_STRING);
-    if (!key) {
+    if (reqs[j++].ret) {
+      key_lens[i] = 0;
+    }
+    if (reqs[j++].ret) {
+      keys[i] = 0;
+    }
+  }
+  uint64_t data = 0;
+  for (size_t i = 0; i < entry_count; i++) {
+    extract_os_size(&key_lens[i]);
+    if (!keys[i] || (key_lens[i] != entry_key_len && key_lens[i] != entry_key_len - 1)) {
       continue;
     }
-    char key_string[PATH_MAX];
-    ret = kread(key, key_string, key_len);
-    if (ret || key_string[0] == '\0') {
+    unsign_ptr(&keys[i]);
+    const char *key_string = kmem_read_string(keys[i], entry_key_len);
+    if (!key_string) {
       continue;
     }
-    if (strcmp(key_string, entry_key) == 0) {
-      data = os_object_cast(current_entry.val, entry_type);
-      if (!data) {
-        continue;
-      }
+    if (strcmp(key_string, entry_key) == 0 && entries[i].val) {
+      data = entries[i].val;
       unsign_ptr(&data);
-      if (out_size) {
-        *out_size = get_os_metabase_size(current_entry.val);
-        if(entry_type == OS_STRING) {
-          extract_os_size(out_size);
-        }
-      }
-      return data;
+      break;
     }
   }
+  free(entries);
+  free(key_lens);
+  free(keys);
+  free(reqs);
+  if (data) {
+    return data;
+  }
   x8A4_log_debug_error("Failed to to find entry %s in os dict!\n", entry_key);
   return 0;
 }
+
+/**
+ * @brief           Get the matching key entry from an OS dict
+ * @param[in]       dict
+ * @param[in]       entry_type
+ * @param[in]       entry_key
+ * @param[out]      out_size
+ * @return          Address of the entry
+ */
+uint64_t get_entry_from_os_dict(uint64_t dict, enum os_type entry_type,
+                                   const char *entry_key, uint32_t *out_size) {
+  uint64_t value = get_value_from_os_dict(dict, entry_key);
+  if (!value) {
+    return 0;
+  }
+  uint64_t data = os_object_cast(value, entry_type);
+  if (!data) {
+    x8A4_log_debug_error("Failed to cast entry %s in os dict!\n", entry_key);
+    return 0;
+  }
+  if (out_size) {
+    *out_size = get_os_metabase_size(value);
+    if(entry_type == OS_STRING) {
+      extract_os_size(out_size);
+    }
+  }
+  return data;
+}
@@ -14,6 +14,7 @@
 
 /* Include headers */
 #include <stdint.h>
+#include <unistd.h>
 #include <x8A4/Kernel/slide.h>
 #include <x8A4/Kernel/kernel.h>
 #include <x8A4/Kernel/kpf.h>
@@ -22,6 +23,7 @@
 
 /* Cached Variables */
 uint64_t slide_cached = 0;
+uint64_t palera1n_slide_cached = 0;
 
 /* Functions */
 /**
@@ -34,7 +36,7 @@ uint64_t get_slide(void) {
     return slide;
   }
   if (!gXPF.kernelIsArm64e) {
-    slide = palera1n_get_slide();
+    slide = palera1n_slide_cached ? palera1n_slide_cached : palera1n_get_slide();
     if (slide) {
       slide_cached = slide;
       return slide;
@@ -50,6 +52,18 @@ uint64_t get_slide(void) {
   return 0;
 }
 
+/**
+ * @brief           Read the palera1n ramdisk slide ahead of the kernel info, only when there is a ramdisk
+ * @return          Zero
+ */
+int palera1n_prefetch_slide(void) {
+  if (access("/dev/rmd0", R_OK)) {
+    return 0;
+  }
+  palera1n_slide_cached = palera1n_get_slide();
+  return 0;
+}
+
 /**
  * @brief           Get kaslr slide from palera1n ramdisk
  * @return          Kaslr slide
@@ -464,5 +464,6 @@ int set_nvram_entry(io_registry_entry_t nvram_entry, const char *key, const char
       fprintf(stderr, "[-]: %s: Failed to set nvram CFProperty %s as a %s!\n", __FUNCTION__, key, value);
     return -1;
   }
+  kmem_cache_flush();
   return 0;
 }
@@ -17,11 +17,26 @@
 #include <x8A4/Kernel/osobject.h>
 #include <x8A4/Kernel/nvram.h>
 #include <x8A4/x8A4.h>
+#include <x8A4/Kernel/kcache.h>
+#include <x8A4/Kernel/kinit.h>
+#include <x8A4/Kernel/kpager.h>
 #include <x8A4/Kernel/kpf.h>
-#include <libkrw.h>
+#include <x8A4/Kernel/kpf_cache.h>
+#include <x8A4/Kernel/kpf_xref.h>
+#include <x8A4/Kernel/kmem.h>
+#include <x8A4/Kernel/kmem_async.h>
+#include <x8A4/Kernel/kmem_phys.h>
+#include <x8A4/Kernel/kmem_static.h>
+#include <x8A4/Kernel/kmem_prefetch.h>
+#include <x8A4/Kernel/kmem_stats.h>
+#include <x8A4/Kernel/kmem_string.h>
+#include <x8A4/Kernel/kregistry.h>
+#include <x8A4/Kernel/kwalk.h>
 
 /* Cached Variables */
 int init_done = 0;
+uint32_t x8A4_caps_cached = 0;
+uint32_t x8A4_init_nodes_cached = 0;
 struct x8A4_nonce_domain *domains_cached = NULL;
 struct x8A4_nonce_slot *slots_cached = NULL;
 int nonce_slot_format_cached = -1;
@@ -34,6 +49,38 @@ uint64_t *gc_cached = NULL;
 int gc_count_cached = 0;
 uint64_t *gc_d_cached = NULL;
 int gc_d_count_cached = 0;
+const struct kmem_prefetch_field x8A4_nonce_slot_prefetch_fields[] = {
+  {offsetof(struct x8A4_nonce_slot, nonce_slot_domain_descriptor), sizeof(struct x8A4_nonce_descriptor), 0},
+};
+const struct kmem_prefetch_desc x8A4_nonce_slot_prefetch = {"x8A4_nonce_slot", 1, x8A4_nonce_slot_prefetch_fields};
+const struct kmem_prefetch_field x8A4_nonce_descriptor_prefetch_fields[] = {
+  {offsetof(struct x8A4_nonce_descriptor, description), KMEM_CACHE_LINE_SIZE, 0},
+  {offsetof(struct x8A4_nonce_descriptor, entitlement), KMEM_CACHE_LINE_SIZE, 0},
+};
+const struct kmem_prefetch_desc x8A4_nonce_descriptor_prefetch = {"x8A4_nonce_descriptor", 2, x8A4_nonce_descriptor_prefetch_fields};
+const struct kmem_prefetch_field x8A4_nonce_domain_prefetch_fields[] = {
+  {offsetof(struct x8A4_nonce_domain, description), KMEM_CACHE_LINE_SIZE, 0},
+  {offsetof(struct x8A4_nonce_domain, entitlement), KMEM_CACHE_LINE_SIZE, 0},
+};
+const struct kmem_prefetch_desc x8A4_nonce_domain_prefetch = {"x8A4_nonce_domain", 2, x8A4_nonce_domain_prefetch_fields};
+const struct kmem_prefetch_field x8A4_accel_keys_prefetch_fields[] = {
+  {0, 0x10 * sizeof(struct x8A4_accel_key), 0},
+};
+const struct kmem_prefetch_desc x8A4_accel_keys_prefetch = {"x8A4_accel_keys", 1, x8A4_accel_keys_prefetch_fields};
+/* Init steps in dependency order, the kmem backend chain stays on one node at a time since libkrw is not thread safe.
+ * Every node past kernel_info that reads gXPF is ordered after the previous one, a kpf cache miss restarts XPF and
+ * releases the cached kernel info under the other readers otherwise */
+const struct kinit_node x8A4_init_nodes[X8A4_INIT_NODES_COUNT] = {
+  [X8A4_INIT_REGISTRY] = {"registry", x8A4_init_registry, 0},
+  [X8A4_INIT_KERNEL_INFO] = {"kernel_info", xpf_init, KINIT_NODE(X8A4_INIT_REGISTRY)},
+  [X8A4_INIT_BACKEND] = {"backend", x8A4_init_backend, 0},
+  [X8A4_INIT_PALEINFO] = {"paleinfo", palera1n_prefetch_slide, 0},
+  [X8A4_INIT_SLIDE] = {"slide", x8A4_init_slide, KINIT_NODE(X8A4_INIT_KERNEL_INFO) | KINIT_NODE(X8A4_INIT_BACKEND) | KINIT_NODE(X8A4_INIT_PALEINFO)},
+  [X8A4_INIT_OFFSETS] = {"offsets", offsets_init, KINIT_NODE(X8A4_INIT_KERNEL_INFO), KINIT_NODE(X8A4_INIT_SLIDE)},
+  [X8A4_INIT_PATCHFINDER] = {"patchfinder", x8A4_init_patchfinder, KINIT_NODE(X8A4_INIT_KERNEL_INFO), KINIT_NODE(X8A4_INIT_SLIDE) | KINIT_NODE(X8A4_INIT_OFFSETS)},
+  [X8A4_INIT_STATIC] = {"static", x8A4_init_static, KINIT_NODE(X8A4_INIT_SLIDE), KINIT_NODE(X8A4_INIT_OFFSETS) | KINIT_NODE(X8A4_INIT_PATCHFINDER)},
+  [X8A4_INIT_PHYSREAD] = {"physread", x8A4_init_physread, KINIT_NODE(X8A4_INIT_SLIDE) | KINIT_NODE(X8A4_INIT_OFFSETS) | KINIT_NODE(X8A4_INIT_STATIC), KINIT_NODE(X8A4_INIT_PATCHFINDER)},
+};
 
 /* Functions */
 /**
@@ -52,34 +99,141 @@ __attribute__((destructor, used)) void x8A4_destructor(void) {
 }
 
 /**
- * @brief           x8A4 init function
+ * @brief           x8A4 init function, brings up every capability
  * @return          Zero on success
  */
 int x8A4_init(void) {
-  if (geteuid() != 0) {
-    x8A4_log_error("x8A4 Requires running with sudo!\n", "");
-    return -1;
-  }
   if(init_done) {
     return 0;
   }
-  x8A4_log_debug("init!\n", "");
-  if (xpf_init()) {
+  if (x8A4_require(X8A4_CAP_ALL)) {
     return -1;
   }
-  uint64_t slide = get_slide();
-  if (slide == 0) {
+  init_done = 1;
+  return 0;
+}
+
+/**
+ * @brief           Prefetch the boot manifest hash the kernel path is built from
+ * @return          Zero
+ */
+int x8A4_init_registry(void) {
+  if (!get_boot_manifest_hash_registry() || !get_hash_len()) {
+    x8A4_log_debug_error("Failed to prefetch boot-manifest-hash!\n", "");
+  }
+  return 0;
+}
+
+/**
+ * @brief           Open the kmem backend and fetch the kernel base it reports
+ * @return          Zero on success
+ */
+int x8A4_init_backend(void) {
+  if (kmem_backend_init()) {
     return -1;
   }
-  if (tfp0_init()) {
+  if (!kmem_backend_offline() && geteuid() != 0) {
+    x8A4_log_error("x8A4 Requires running with sudo!\n", "");
     return -1;
   }
-  if (offsets_init()) {
+  return kbase_prefetch();
+}
+
+/**
+ * @brief           Compute the slide and check that kread works
+ * @return          Zero on success
+ */
+int x8A4_init_slide(void) {
+  if (get_slide() == 0) {
     return -1;
   }
-  gc_cached = calloc(1, 1024);
-  gc_d_cached = calloc(1, 1024);
-  init_done = 1;
+  return tfp0_init();
+}
+
+/**
+ * @brief           Pick the nonce slot format through the patchfinder
+ * @return          Zero
+ */
+int x8A4_init_patchfinder(void) {
+  x8A4_set_nonce_format();
+  return 0;
+}
+
+/**
+ * @brief           Collect the static kernelcache regions, missing ones only cost kreads
+ * @return          Zero
+ */
+int x8A4_init_static(void) {
+  if (kmem_static_init()) {
+    x8A4_log_debug("No static kernelcache regions, reading kernel image data through kread\n", "");
+  }
+  return 0;
+}
+
+/**
+ * @brief           Switch to physread when the backend has it, staying on kread otherwise
+ * @return          Zero
+ */
+int x8A4_init_physread(void) {
+  physread_init();
+  return 0;
+}
+
+/**
+ * @brief           Bring up the subsystems a getter needs on first use, running independent init steps concurrently.
+ *                  Every public getter enters here, so the kmem cache is flushed first and never serves kernel memory
+ *                  read during an earlier call
+ * @param[in]       caps
+ * @return          Zero on success
+ */
+int x8A4_require(uint32_t caps) {
+  kmem_cache_flush();
+  if (!gc_cached) {
+    gc_cached = calloc(1, 1024);
+    gc_d_cached = calloc(1, 1024);
+  }
+  if (caps & (X8A4_CAP_KREAD | X8A4_CAP_OFFSETS | X8A4_CAP_PATCHFINDER)) {
+    caps |= X8A4_CAP_KERNEL_INFO;
+  }
+  uint32_t missing = caps & ~x8A4_caps_cached;
+  if (!missing) {
+    return 0;
+  }
+  x8A4_log_debug("init caps: 0x%X!\n", missing);
+  uint32_t wanted = 0;
+  if (missing & X8A4_CAP_KERNEL_INFO) {
+    wanted |= KINIT_NODE(X8A4_INIT_KERNEL_INFO);
+  }
+  if (missing & X8A4_CAP_KREAD) {
+    wanted |= KINIT_NODE(X8A4_INIT_SLIDE) | KINIT_NODE(X8A4_INIT_STATIC);
+  }
+  if (missing & X8A4_CAP_OFFSETS) {
+    wanted |= KINIT_NODE(X8A4_INIT_OFFSETS);
+  }
+  if (missing & X8A4_CAP_PATCHFINDER) {
+    wanted |= KINIT_NODE(X8A4_INIT_PATCHFINDER);
+  }
+  if ((missing & (X8A4_CAP_KREAD | X8A4_CAP_OFFSETS)) && ((caps | x8A4_caps_cached) & X8A4_CAP_KREAD) && ((caps | x8A4_caps_cached) & X8A4_CAP_OFFSETS)) {
+    wanted |= KINIT_NODE(X8A4_INIT_PHYSREAD);
+  }
+  int ret = kinit_run(x8A4_init_nodes, X8A4_INIT_NODES_COUNT, wanted, &x8A4_init_nodes_cached);
+  if (x8A4_init_nodes_cached & KINIT_NODE(X8A4_INIT_KERNEL_INFO)) {
+    x8A4_caps_cached |= X8A4_CAP_KERNEL_INFO;
+  }
+  if (x8A4_init_nodes_cached & KINIT_NODE(X8A4_INIT_PATCHFINDER)) {
+    x8A4_caps_cached |= X8A4_CAP_PATCHFINDER;
+  }
+  if ((x8A4_init_nodes_cached & KINIT_NODE(X8A4_INIT_SLIDE)) && (x8A4_init_nodes_cached & KINIT_NODE(X8A4_INIT_STATIC))) {
+    x8A4_caps_cached |= X8A4_CAP_KREAD;
+  }
+  if (x8A4_init_nodes_cached & KINIT_NODE(X8A4_INIT_OFFSETS)) {
+    x8A4_caps_cached |= X8A4_CAP_OFFSETS;
+  }
+  if (ret) {
+    return -1;
+  }
+  x8A4_caps_cached |= caps & X8A4_CAP_REGISTRY;
+  kpf_cache_save();
   return 0;
 }
 
@@ -87,23 +241,43 @@ int x8A4_init(void) {
  * @brief           x8A4 free function
  */
 void x8A4_free(void) {
+  kmem_static_free();
+  kpf_cache_free();
+  kpf_xref_index_free();
   xpf_free_fileset_sections();
+  kpager_fileset_close();
+  kcache_free();
+  kmem_async_free();
+  kmem_cache_free();
+  kmem_backend_free();
+  kmem_stats_reset();
+  kmem_string_free();
+  kwalk_cache_flush();
+  proc_index_flush();
+  ipc_table_invalidate();
+  service_object_cache_flush();
+  kregistry_cache_flush();
   if (domains_cached) {
     free(domains_cached);
+    domains_cached = NULL;
   }
   if (apple_mobile_ap_nonce_service2_cached != IO_OBJECT_NULL) {
     x8A4_log_debug("Closing apple_mobile_ap_nonce_service2_cached\n", "");
     IOServiceClose(apple_mobile_ap_nonce_service2_cached);
+    apple_mobile_ap_nonce_service2_cached = IO_OBJECT_NULL;
   }
   if(apple_mobile_ap_nonce_service_cached != IO_OBJECT_NULL) {
     x8A4_log_debug("Releasing apple_mobile_ap_nonce_service_cached\n", "");
     IOObjectRelease(apple_mobile_ap_nonce_service_cached);
+    apple_mobile_ap_nonce_service_cached = IO_OBJECT_NULL;
   }
   if(kernel_path_cached) {
     free(kernel_path_cached);
+    kernel_path_cached = NULL;
   }
   if(koffsets_cached) {
     free(koffsets_cached);
+    koffsets_cached = NULL;
   }
   if(nvram_keys_cached) {
     for(int i = 0; i < nvram_keys_count_cached; i++) {
@@ -121,6 +295,8 @@ void x8A4_free(void) {
       }
     }
     free(nvram_keys_cached);
+    nvram_keys_cached = NULL;
+    nvram_keys_count_cached = -1;
   }
   if(gc_cached) {
     for(int i = 0; i < gc_count_cached; i++) {
@@ -136,10 +312,23 @@ void x8A4_free(void) {
       }
     }
     free(gc_cached);
+    gc_cached = NULL;
+    gc_count_cached = 0;
   }
   if(gc_d_cached) {
     free(gc_d_cached);
-  }
+    gc_d_cached = NULL;
+    gc_d_count_cached = 0;
+  }
+  slots_cached = NULL;
+  domains_count_cached = -1;
+  nonce_slot_format_cached = -1;
+  cryptex_domains_index_cached = -1;
+  cryptex_slots_index_cached = -1;
+  cryptex_index_cached = -1;
+  init_done = 0;
+  x8A4_caps_cached = 0;
+  x8A4_init_nodes_cached = 0;
 }
 
 /**
@@ -171,6 +360,9 @@ const char *x8A4_version(void) {
  * @return          Pointer to nonce-seeds(uint8_t array)
  */
 uint8_t *x8A4_get_nonce_slots_os_dict(uint32_t *seeds_size, int slot_index) {
+  if (x8A4_require(X8A4_CAP_PATCHFINDER | X8A4_CAP_KREAD | X8A4_CAP_OFFSETS)) {
+    return NULL;
+  }
   if(strcmp(gXPF.darwinVersion, "23.0.0") >= 0 && nonce_slot_format_cached == 1) {
   } else {
     return NULL;
@@ -210,6 +402,9 @@ uint8_t *x8A4_get_nonce_slots_os_dict(uint32_t *seeds_size, int slot_index) {
  * @return          Pointer to nonce-seeds(uint8_t array)
  */
 uint8_t *x8A4_get_nonce_seeds_os_dict(uint32_t *seeds_size) {
+  if (x8A4_require(X8A4_CAP_PATCHFINDER | X8A4_CAP_KREAD | X8A4_CAP_OFFSETS)) {
+    return NULL;
+  }
   if (!seeds_size) {
     x8A4_log_error("Failed to get nonce-seeds, out seeds size pointer is NULL!\n", "");
   }
@@ -239,6 +434,9 @@ uint8_t *x8A4_get_nonce_seeds_os_dict(uint32_t *seeds_size) {
  * @return          Pointer to nonce-seeds(uint8_t array)
  */
 uint8_t *x8A4_get_nonce_seeds_registry(uint32_t *seeds_size) {
+  if (x8A4_require(X8A4_CAP_REGISTRY)) {
+    return NULL;
+  }
   if (!seeds_size) {
     x8A4_log_error("Failed to get nonce-seeds, out seeds size pointer is NULL!\n", "");
     return NULL;
@@ -262,7 +460,11 @@ uint8_t *x8A4_get_nonce_seeds_registry(uint32_t *seeds_size) {
  */
 void x8A4_set_nonce_format(void) {
   if(strcmp(gXPF.darwinVersion, "23.0.0") >= 0 && nonce_slot_format_cached == -1) {
-    nonce_slot_format_cached = xpf_find_nonce_domains_array() ? 0 : 1;
+    int format = xpf_find_nonce_slot_format();
+    nonce_slot_format_cached = format < 0 ? 1 : format;
+    if (format >= 0) {
+      kpf_cache_put(KPF_CACHE_NONCE_SLOT_FORMAT, (uint64_t)format);
+    }
   }
 }
 
@@ -275,6 +477,9 @@ void x8A4_set_nonce_format(void) {
  */
 uint8_t *x8A4_get_domain_seed(uint8_t **nonce_seeds, uint32_t *seeds_size,
                               int domain_index) {
+  if (x8A4_require(X8A4_CAP_REGISTRY)) {
+    return NULL;
+  }
   if (!nonce_seeds) {
     x8A4_log_error("Failed to get nonce-seeds, out nonce seeds pointer to pointer is NULL!\n", "");
     return NULL;
@@ -285,6 +490,9 @@ uint8_t *x8A4_get_domain_seed(uint8_t **nonce_seeds, uint32_t *seeds_size,
   }
   *(uint64_t *)nonce_seeds = (uint64_t)x8A4_get_nonce_seeds_registry(seeds_size);
   if (!*nonce_seeds || !*seeds_size) {
+    if (x8A4_require(X8A4_CAP_PATCHFINDER)) {
+      return NULL;
+    }
     if(nonce_slot_format_cached == 1) {
       *(uint64_t *)nonce_seeds = (uint64_t)x8A4_get_nonce_slots_os_dict(seeds_size, domain_index);
     } else {
@@ -308,6 +516,9 @@ uint8_t *x8A4_get_domain_seed(uint8_t **nonce_seeds, uint32_t *seeds_size,
  */
 uint8_t *x8A4_get_slot_seed(uint8_t **nonce_seeds, uint32_t *seeds_size,
                               int slot_index) {
+  if (x8A4_require(X8A4_CAP_REGISTRY)) {
+    return NULL;
+  }
   if (!nonce_seeds) {
     x8A4_log_error("Failed to get nonce-seeds, out nonce seeds pointer to pointer is NULL!\n", "");
     return NULL;
@@ -342,6 +553,9 @@ uint8_t *x8A4_get_slot_seed(uint8_t **nonce_seeds, uint32_t *seeds_size,
  * @return          Pointer to nonce slots(struct array)
  */
 struct x8A4_nonce_slot *x8A4_get_nonce_slots_list(void) {
+  if (x8A4_require(X8A4_CAP_PATCHFINDER | X8A4_CAP_KREAD | X8A4_CAP_OFFSETS)) {
+    return NULL;
+  }
   if (slots_cached) {
     return slots_cached;
   }
@@ -363,65 +577,65 @@ struct x8A4_nonce_slot *x8A4_get_nonce_slots_list(void) {
   uint32_t nonce_descriptor_size = sizeof(struct x8A4_nonce_descriptor);
   struct x8A4_nonce_slot *nonce_slots = (struct x8A4_nonce_slot *)calloc(nonce_domains_array_length, nonce_slot_size);
   struct x8A4_nonce_descriptor *nonce_descriptors = (struct x8A4_nonce_descriptor *)calloc(nonce_domains_array_length, nonce_descriptor_size);
-  char *entitlements = (char *)calloc(nonce_domains_array_length, 256);
-  char *descriptions = (char *)calloc(nonce_domains_array_length, 256);
   gc_cached[gc_count_cached++] = (uint64_t)nonce_slots;
   gc_cached[gc_count_cached++] = (uint64_t)nonce_descriptors;
-  gc_cached[gc_count_cached++] = (uint64_t)entitlements;
-  gc_cached[gc_count_cached++] = (uint64_t)descriptions;
   x8A4_log_debug_error("gc_cached[gc_count_cached++]: %d val: 0x%016llX\n", __LINE__, nonce_slots);
   x8A4_log_debug_error("gc_cached[gc_count_cached++]: %d val: 0x%016llX\n", __LINE__, nonce_descriptors);
-  x8A4_log_debug_error("gc_cached[gc_count_cached++]: %d val: 0x%016llX\n", __LINE__, entitlements);
-  x8A4_log_debug_error("gc_cached[gc_count_cached++]: %d val: 0x%016llX\n", __LINE__, descriptions);
+  uint64_t *vmaddrs = (uint64_t *)calloc(nonce_domains_array_length, sizeof(uint64_t));
+  struct kmem_read_req *reqs = (struct kmem_read_req *)calloc(nonce_domains_array_length, sizeof(struct kmem_read_req));
+  if (!vmaddrs || !reqs) {
+    x8A4_log_error("Failed to calloc memory for nonce slot reads!\n", "");
+    free(vmaddrs);
+    free(reqs);
+    return NULL;
+  }
+  int ret = kmem_static_read_pointers(nonce_domains_array_addr, vmaddrs, nonce_domains_array_length);
   for (int i = 0; i < nonce_domains_array_length; i++) {
-    uint64_t array_index = nonce_domains_array_addr + (sizeof(uint64_t) * i);
-    uint64_t vmaddr = 0;
-    int ret = kread(array_index, &vmaddr, sizeof(uint64_t));
-    if (ret || !vmaddr) {
-      x8A4_log_error("Failed to read domain pointer %d from 0x%016llX (%d)!\n", i, array_index, ret);
-      if (nonce_slots)
-        free(nonce_slots);
-      if (nonce_descriptors)
-        free(nonce_descriptors);
-      if (entitlements)
-        free(entitlements);
-      if (descriptions)
-        free(descriptions);
+    if (ret || !vmaddrs[i]) {
+      x8A4_log_error("Failed to read domain pointer %d from 0x%016llX (%d)!\n", i, nonce_domains_array_addr + (sizeof(uint64_t) * i), ret);
+      free(vmaddrs);
+      free(reqs);
       return NULL;
     }
-    ret = kread(vmaddr, &nonce_slots[i], nonce_slot_size);
-    if (ret) {
-      x8A4_log_error("Failed to read domain %d from 0x%016llX (%d)!\n", i, vmaddr, ret);
-      if (nonce_slots)
-        free(nonce_slots);
-      if (nonce_descriptors)
-        free(nonce_descriptors);
-      if (entitlements)
-        free(entitlements);
-      if (descriptions)
-        free(descriptions);
-      return NULL;
+    reqs[i] = (struct kmem_read_req){vmaddrs[i], &nonce_slots[i], nonce_slot_size, 0, &x8A4_nonce_slot_prefetch};
+  }
+  if (kmem_read_batch(reqs, nonce_domains_array_length)) {
+    for (int i = 0; i < nonce_domains_array_length; i++) {
+      if (reqs[i].ret) {
+        x8A4_log_error("Failed to read domain %d from 0x%016llX (%d)!\n", i, vmaddrs[i], reqs[i].ret);
+        break;
+      }
     }
-    if(!nonce_slots[i].nonce_slot_domain_descriptor) {
-      continue;
+    free(vmaddrs);
+    free(reqs);
+    return NULL;
+  }
+  int reqs_count = 0;
+  for (int i = 0; i < nonce_domains_array_length; i++) {
+    if (nonce_slots[i].nonce_slot_domain_descriptor) {
+      reqs[reqs_count++] = (struct kmem_read_req){(uint64_t)nonce_slots[i].nonce_slot_domain_descriptor, &nonce_descriptors[i], nonce_descriptor_size, 0, &x8A4_nonce_descriptor_prefetch};
     }
-    ret = kread((uint64_t)nonce_slots[i].nonce_slot_domain_descriptor, &nonce_descriptors[i], nonce_descriptor_size);
-    if(ret || !nonce_descriptors[i].description || !nonce_descriptors[i].entitlement) {
-      continue;
+  }
+  kmem_read_batch(reqs, reqs_count);
+  for (int i = 0, j = 0; i < nonce_domains_array_length; i++) {
+    if (nonce_slots[i].nonce_slot_domain_descriptor && reqs[j++].ret) {
+      memset(&nonce_descriptors[i], 0, nonce_descriptor_size);
     }
-    nonce_slots[i].nonce_slot_domain_descriptor = &nonce_descriptors[i];
-    ret = kread((uint64_t)nonce_descriptors[i].entitlement, &entitlements[i * 256], 256);
-    if(ret) {
+  }
+  for (int i = 0; i < nonce_domains_array_length; i++) {
+    if (!nonce_slots[i].nonce_slot_domain_descriptor || !nonce_descriptors[i].description || !nonce_descriptors[i].entitlement) {
       continue;
     }
-    ret = kread((uint64_t)nonce_descriptors[i].description, &descriptions[i * 256], 256);
-    if(ret) {
+    nonce_slots[i].nonce_slot_domain_descriptor = &nonce_descriptors[i];
+    const char *entitlement = kmem_read_string((uint64_t)nonce_descriptors[i].entitlement, 0);
+    const char *description = kmem_read_string((uint64_t)nonce_descriptors[i].description, 0);
+    nonce_descriptors[i].entitlement = (char *)entitlement;
+    nonce_descriptors[i].description = (char *)description;
+    if (!entitlement || !description) {
       continue;
     }
-    nonce_descriptors[i].entitlement = &entitlements[i * 256];
-    nonce_descriptors[i].description = &descriptions[i * 256];
     x8A4_log_debug("===========================================================\n", "");
-    x8A4_log_debug("Got vmaddr: 0x%016llX\n", vmaddr);
+    x8A4_log_debug("Got vmaddr: 0x%016llX\n", vmaddrs[i]);
     x8A4_log_debug("Got nonce_slots[i].nonce_slot_domain_descriptor: 0x%016llX\n", nonce_slots[i].nonce_slot_domain_descriptor);
     x8A4_log_debug("Got nonce_descriptors[i].description: (0x%016llX:%s)\n", nonce_descriptors[i].description, nonce_descriptors[i].description);
     x8A4_log_debug("Got nonce_descriptors[i].entitlement: (0x%016llX:%s)\n", nonce_descriptors[i].entitlement, nonce_descriptors[i].entitlement);
@@ -435,6 +649,8 @@ struct x8A4_nonce_slot *x8A4_get_nonce_slots_list(void) {
     x8A4_log_debug("Got nonce_slots[i].nonce_slot_unlock_function: 0x%016llX\n", nonce_slots[i].nonce_slot_unlock_function);
     x8A4_log_debug("Got nonce_slots[i].nonce_slot_data: 0x%016llX\n", nonce_slots[i].nonce_slot_data);
   }
+  free(vmaddrs);
+  free(reqs);
   slots_cached = nonce_slots;
   return nonce_slots;
 }
@@ -444,6 +660,9 @@ struct x8A4_nonce_slot *x8A4_get_nonce_slots_list(void) {
  * @return          Pointer to nonce domains(struct array)
  */
 struct x8A4_nonce_domain *x8A4_get_nonce_seeds_domain_list(void) {
+  if (x8A4_require(X8A4_CAP_PATCHFINDER | X8A4_CAP_KREAD | X8A4_CAP_OFFSETS)) {
+    return NULL;
+  }
   if (domains_cached) {
     return domains_cached;
   }
@@ -462,47 +681,63 @@ struct x8A4_nonce_domain *x8A4_get_nonce_seeds_domain_list(void) {
   nonce_domains_array_addr += get_slide();
   uint32_t domain_size = sizeof(struct x8A4_nonce_domain);
   struct x8A4_nonce_domain *domains = calloc(nonce_domains_array_length, domain_size + 1);
+  uint64_t *vmaddrs = (uint64_t *)calloc(nonce_domains_array_length, sizeof(uint64_t));
+  struct kmem_read_req *reqs = (struct kmem_read_req *)calloc(nonce_domains_array_length, sizeof(struct kmem_read_req));
+  if (!domains || !vmaddrs || !reqs) {
+    x8A4_log_error("Failed to calloc memory for nonce domain reads!\n", "");
+    free(domains);
+    free(vmaddrs);
+    free(reqs);
+    return NULL;
+  }
+  int ret = kmem_static_read_pointers(nonce_domains_array_addr, vmaddrs, nonce_domains_array_length);
   for (int i = 0; i < nonce_domains_array_length; i++) {
-    uint64_t array_index = nonce_domains_array_addr + (sizeof(uint64_t) * i);
-    uint64_t vmaddr = 0;
-    int ret = kread(array_index, &vmaddr, sizeof(uint64_t));
-    if (ret || !vmaddr) {
-      x8A4_log_error("Failed to read domain pointer %d from 0x%016llX (%d)!\n", i, array_index, ret);
+    if (ret || !vmaddrs[i]) {
+      x8A4_log_error("Failed to read domain pointer %d from 0x%016llX (%d)!\n", i, nonce_domains_array_addr + (sizeof(uint64_t) * i), ret);
+      free(vmaddrs);
+      free(reqs);
       return NULL;
     }
-    ret = kread(vmaddr, &domains[i], domain_size);
-    if (ret) {
-      x8A4_log_error("Failed to read domain %d from 0x%016llX (%d)!\n", i, vmaddr, ret);
+    reqs[i] = (struct kmem_read_req){vmaddrs[i], &domains[i], domain_size, 0, &x8A4_nonce_domain_prefetch};
+  }
+  kmem_read_batch(reqs, nonce_domains_array_length);
+  for (int i = 0; i < nonce_domains_array_length; i++) {
+    if (reqs[i].ret) {
+      x8A4_log_error("Failed to read domain %d from 0x%016llX (%d)!\n", i, vmaddrs[i], reqs[i].ret);
+      free(vmaddrs);
+      free(reqs);
       return NULL;
     }
-    x8A4_log_debug("Got vmaddr: 0x%016llX\n", vmaddr);
+    x8A4_log_debug("Got vmaddr: 0x%016llX\n", vmaddrs[i]);
     x8A4_log_debug("Got domains[i].description: 0x%016llX\n", domains[i].description);
     x8A4_log_debug("Got domains[i].entitlement: 0x%016llX\n", domains[i].entitlement);
     if (!domains[i].description || !domains[i].entitlement) {
-      x8A4_log_error("Failed to read domain %d from 0x%016llX!\n", i, vmaddr);
+      x8A4_log_error("Failed to read domain %d from 0x%016llX!\n", i, vmaddrs[i]);
+      free(vmaddrs);
+      free(reqs);
       return NULL;
     }
-    char tmp[100];
-    ret = kread((uint64_t)domains[i].description, tmp, 100);
-    if (ret) {
-      x8A4_log_error("Failed to read domain %d description from 0x%016llX (%d)!\n", i, vmaddr, ret);
+  }
+  for (int i = 0; i < nonce_domains_array_length; i++) {
+    const char *description = kmem_read_string((uint64_t)domains[i].description, 0);
+    if (!description) {
+      x8A4_log_error("Failed to read domain %d description from 0x%016llX!\n", i, vmaddrs[i]);
+      free(vmaddrs);
+      free(reqs);
       return NULL;
     }
-    domains[i].description = calloc(1, strlen(tmp) + 1);
-    gc_cached[gc_count_cached++] = (uint64_t)domains[i].description;
-    x8A4_log_debug_error("gc_cached[gc_count_cached++]: %d val: 0x%016llX\n", __LINE__, domains[i].description);
-    strcpy(domains[i].description, tmp);
-    memset(tmp, 0, 100);
-    ret = kread((uint64_t)domains[i].entitlement, tmp, 100);
-    if (ret) {
-      x8A4_log_error("Failed to read domain %d entitlement from 0x%016llX (%d)!\n", i, vmaddr, ret);
+    domains[i].description = (char *)description;
+    const char *entitlement = kmem_read_string((uint64_t)domains[i].entitlement, 0);
+    if (!entitlement) {
+      x8A4_log_error("Failed to read domain %d entitlement from 0x%016llX!\n", i, vmaddrs[i]);
+      free(vmaddrs);
+      free(reqs);
       return NULL;
     }
-    domains[i].entitlement = calloc(1, strlen(tmp) + 1);
-    gc_cached[gc_count_cached++] = (uint64_t)domains[i].entitlement;
-    x8A4_log_debug_error("gc_cached[gc_count_cached++]: %d val: 0x%016llX\n", __LINE__, domains[i].entitlement);
-    strcpy(domains[i].entitlement, tmp);
+    domains[i].entitlement = (char *)entitlement;
   }
+  free(vmaddrs);
+  free(reqs);
   domains_cached = domains;
   return domains;
 }
@@ -512,6 +747,9 @@ struct x8A4_nonce_domain *x8A4_get_nonce_seeds_domain_list(void) {
  * @return          Domain count(int)
  */
 int x8A4_get_domain_count(void) {
+  if (x8A4_require(X8A4_CAP_PATCHFINDER)) {
+    return 0;
+  }
   if (domains_count_cached >= 0) {
     return domains_count_cached;
   }
@@ -601,6 +839,9 @@ int x8A4_get_domain_domains_index(const char *entitlement) {
  * @return          Cryptex boot domain slots index(int)
  */
 int x8A4_get_cryptex_boot_slot_slots_index(void) {
+  if (x8A4_require(X8A4_CAP_PATCHFINDER)) {
+    return -1;
+  }
   if (strcmp(gXPF.darwinVersion, "23.0.0") >= 0 && nonce_slot_format_cached == 1) {
   } else {
     return -1;
@@ -622,6 +863,9 @@ int x8A4_get_cryptex_boot_slot_slots_index(void) {
  * @return          Cryptex boot domain domains index(int)
  */
 int x8A4_get_cryptex_boot_domain_domains_index(void) {
+  if (x8A4_require(X8A4_CAP_PATCHFINDER)) {
+    return -1;
+  }
   if (strcmp(gXPF.darwinVersion, "22.0.0") >= 0) {
   } else {
     return -1;
@@ -643,6 +887,9 @@ int x8A4_get_cryptex_boot_domain_domains_index(void) {
  * @return          Cryptex boot slot index(int)
  */
 int x8A4_get_cryptex_boot_slot_index(void) {
+  if (x8A4_require(X8A4_CAP_PATCHFINDER)) {
+    return -1;
+  }
   if (strcmp(gXPF.darwinVersion, "23.0.0") >= 0 && nonce_slot_format_cached == 1) {
   } else {
     return -1;
@@ -669,6 +916,9 @@ int x8A4_get_cryptex_boot_slot_index(void) {
  * @return          Cryptex boot domain index(int)
  */
 int x8A4_get_cryptex_boot_domain_index(void) {
+  if (x8A4_require(X8A4_CAP_PATCHFINDER)) {
+    return -1;
+  }
   if (strcmp(gXPF.darwinVersion, "22.0.0") >= 0) {
   } else {
     return -1;
@@ -696,6 +946,9 @@ int x8A4_get_cryptex_boot_domain_index(void) {
    * @return          Pointer to nonce seeds(uint8_t array)
  */
 uint8_t *x8A4_get_nonce_seeds(uint32_t *seeds_size) {
+  if (x8A4_require(X8A4_CAP_PATCHFINDER)) {
+    return NULL;
+  }
   uint32_t count = x8A4_get_domain_count();
   struct x8A4_nonce_seeds_slot *nonce_seeds = NULL;
   x8A4_log_debug_error("gc_cached[gc_count_cached++]: %d val: 0x%016llX\n", __LINE__, nonce_seeds);
@@ -732,6 +985,9 @@ uint8_t *x8A4_get_nonce_seeds(uint32_t *seeds_size) {
  * @return          Pointer to cryptex seed(uint8_t array)
  */
 uint8_t *x8A4_get_cryptex_seed(uint8_t **nonce_seeds, uint32_t *seeds_size) {
+  if (x8A4_require(X8A4_CAP_PATCHFINDER)) {
+    return NULL;
+  }
   if (strcmp(gXPF.darwinVersion, "22.0.0") >= 0) {
   } else {
     return NULL;
@@ -761,6 +1017,9 @@ uint8_t *x8A4_get_cryptex_seed(uint8_t **nonce_seeds, uint32_t *seeds_size) {
  * @return          Pointer to cryptex nonce(uint8_t array)
  */
 uint8_t *x8A4_get_cryptex_nonce(uint32_t *nonce_size) {
+  if (x8A4_require(X8A4_CAP_PATCHFINDER)) {
+    return NULL;
+  }
   if (strcmp(gXPF.darwinVersion, "22.0.0") >= 0) {
   } else {
     return NULL;
@@ -785,9 +1044,8 @@ uint8_t *x8A4_get_cryptex_nonce(uint32_t *nonce_size) {
     return NULL;
   }
   uint32_t chosen_key = 0x8A4;
-  uint32_t struct_size = sizeof(struct x8A4_accel_key);
   for (int i = 0; i < keys_count; i++) {
-    struct x8A4_accel_key *cur_key = keys + (struct_size * i);
+    struct x8A4_accel_key *cur_key = &keys[i];
     if (cur_key->key_id == chosen_key) {
       keys = cur_key;
       break;
@@ -824,6 +1082,9 @@ uint8_t *x8A4_get_cryptex_nonce(uint32_t *nonce_size) {
  * @return          Zero on success
  */
 int x8A4_sync_nvram(void) {
+  if (x8A4_require(X8A4_CAP_REGISTRY)) {
+    return -1;
+  }
   const char *delete_me_key = "delete_me_key";
   const char *delete_me_val = "delete_me_val";
   int ret = 0;
@@ -863,6 +1124,9 @@ int x8A4_sync_nvram(void) {
  * @return          Pointer to boot-nonce(uint8_t array)
  */
 uint8_t *x8A4_get_boot_nonce_os_dict(uint32_t *generator_size) {
+  if (x8A4_require(X8A4_CAP_KREAD | X8A4_CAP_OFFSETS)) {
+    return NULL;
+  }
   if (!generator_size) {
     x8A4_log_error("Failed to get boot-nonce, out generator size pointer is NULL!\n", "");
   }
@@ -885,6 +1149,9 @@ uint8_t *x8A4_get_boot_nonce_os_dict(uint32_t *generator_size) {
  * @return
  */
 int x8A4_set_boot_nonce_os_dict(uint8_t *generator, uint32_t generator_size) {
+  if (x8A4_require(X8A4_CAP_KREAD | X8A4_CAP_OFFSETS)) {
+    return -1;
+  }
   if (!generator) {
     x8A4_log_error("Failed to set boot-nonce, out generator pointer is NULL!\n", "");
     return -1;
@@ -913,6 +1180,9 @@ int x8A4_set_boot_nonce_os_dict(uint8_t *generator, uint32_t generator_size) {
  * @return
  */
 int x8A4_set_nonce_seeds_os_dict(uint8_t *seed, int domain_index) {
+  if (x8A4_require(X8A4_CAP_PATCHFINDER | X8A4_CAP_KREAD | X8A4_CAP_OFFSETS)) {
+    return -1;
+  }
   if (!seed) {
     x8A4_log_error("Failed to set nonce seed, seed is NULL!\n", "");
     return -1;
@@ -962,6 +1232,9 @@ int x8A4_set_nonce_seeds_os_dict(uint8_t *seed, int domain_index) {
  * @return          Pointer to boot-nonce(uint8_t array)
  */
 uint8_t *x8A4_get_boot_nonce_registry(uint32_t *generator_size) {
+  if (x8A4_require(X8A4_CAP_REGISTRY)) {
+    return NULL;
+  }
   if (!generator_size) {
     x8A4_log_error("Failed to get boot-nonce, out generator size pointer is NULL!\n", "");
     return NULL;
@@ -987,6 +1260,9 @@ uint8_t *x8A4_get_boot_nonce_registry(uint32_t *generator_size) {
  * @return          Zero on success
  */
 int x8A4_set_boot_nonce_registry(uint8_t *generator) {
+  if (x8A4_require(X8A4_CAP_REGISTRY)) {
+    return -1;
+  }
   int ret = set_nvram_entry(get_dtre_options(), kBootNoncePropertyKey,
                             (const char *)generator);
   if(ret) {
@@ -1017,6 +1293,9 @@ int x8A4_set_boot_nonce_registry(uint8_t *generator) {
  * @return          Pointer to apnonce generator(uint8_t array)
  */
 uint8_t *x8A4_get_apnonce_generator(uint32_t *generator_size) {
+  if (x8A4_require(X8A4_CAP_REGISTRY)) {
+    return NULL;
+  }
   if (!generator_size) {
     x8A4_log_error("Failed to get apnonce generator, out generator size pointer is NULL!\n", "");
     return NULL;
@@ -1039,6 +1318,9 @@ uint8_t *x8A4_get_apnonce_generator(uint32_t *generator_size) {
  * @return          Pointer to apnonce(uint8_t array)
  */
 uint8_t *x8A4_get_apnonce(uint32_t *apnonce_size) {
+  if (x8A4_require(X8A4_CAP_REGISTRY)) {
+    return NULL;
+  }
   if (!apnonce_size) {
     x8A4_log_error(
         "Failed to get get apnonce generator, apnonce size pointer is NULL!\n",
@@ -1071,6 +1353,9 @@ uint8_t *x8A4_get_apnonce(uint32_t *apnonce_size) {
   gc_cached[gc_count_cached++] = (uint64_t)apnonce;
   x8A4_log_debug_error("gc_cached[gc_count_cached++]: %d val: 0x%016llX\n", __LINE__, apnonce);
   generator_data = tmp;
+  if (x8A4_require(X8A4_CAP_KERNEL_INFO)) {
+    return NULL;
+  }
   if (!gXPF.kernelIsArm64e) {
     if(digest_len == CC_SHA384_DIGEST_LENGTH) {
       *apnonce_size = CC_SHA256_DIGEST_LENGTH;
@@ -1090,9 +1375,8 @@ uint8_t *x8A4_get_apnonce(uint32_t *apnonce_size) {
     return NULL;
   }
   uint32_t chosen_key = 0x8A3;
-  uint32_t struct_size = sizeof(struct x8A4_accel_key);
   for (int i = 0; i < keys_count; i++) {
-    struct x8A4_accel_key *cur_key = keys + (struct_size * i);
+    struct x8A4_accel_key *cur_key = &keys[i];
     if (cur_key->key_id == chosen_key) {
       keys = cur_key;
       break;
@@ -1124,6 +1408,9 @@ uint8_t *x8A4_get_apnonce(uint32_t *apnonce_size) {
  * @return          Pointer to apnonce generator(uint8_t array)
  */
 uint8_t *x8A4_set_apnonce_generator(uint8_t *generator, uint32_t *generator_size) {
+  if (x8A4_require(X8A4_CAP_REGISTRY)) {
+    return NULL;
+  }
   if (!generator || (strlen((char *)generator) < 16 || strlen((char *)generator) > 18)) {
     x8A4_log_error("Failed to set apnonce generator, generator is invalid! (0x%016llX:%s)\n", generator, generator ? (char *)generator : "NULL");
     return NULL;
@@ -1188,6 +1475,9 @@ x8A4_log_error("Failed to set sync nvram!\n", "");
  * @return          Zero on success
  */
 int x8A4_clear_apnonce_generator(void) {
+  if (x8A4_require(X8A4_CAP_REGISTRY)) {
+    return -1;
+  }
   if (io_clear_apnonce()) {
     x8A4_log_error("Failed to clear current apnonce generator!\n", "");
     return -1;
@@ -1205,6 +1495,9 @@ int x8A4_clear_apnonce_generator(void) {
  * @return          Pointer to keys(x8A4_accel_key array)
  */
 struct x8A4_accel_key *x8A4_get_ioaesaccelkeys(uint32_t *keys_count) {
+  if (x8A4_require(X8A4_CAP_KREAD | X8A4_CAP_OFFSETS)) {
+    return NULL;
+  }
   if(!keys_count) {
     x8A4_log_error("Failed to get IOAESAccelerator keys, no keys count output pointer set!\n",
                    "");
@@ -1219,15 +1512,17 @@ struct x8A4_accel_key *x8A4_get_ioaesaccelkeys(uint32_t *keys_count) {
   uint64_t keys = 0;
   x8A4_log_debug("kobject: 0x%016llX\n", kobject);
   x8A4_log_debug("kobject + koffsets_cached->io_aes_accel_special_keys: 0x%016llX\n", kobject + koffsets_cached->io_aes_accel_special_keys);
-  if (kread(kobject + koffsets_cached->io_aes_accel_special_keys, &keys, 8) ||
-      keys == 0) {
+  x8A4_log_debug("kobject + koffsets_cached->io_aes_accel_special_keys_size: 0x%016llX\n", kobject + koffsets_cached->io_aes_accel_special_keys_size);
+  struct kmem_read_req kobject_reqs[2] = {
+    {kobject + koffsets_cached->io_aes_accel_special_keys, &keys, 8, 0, &x8A4_accel_keys_prefetch},
+    {kobject + koffsets_cached->io_aes_accel_special_keys_size, keys_count, 4, 0, NULL},
+  };
+  kmem_read_batch(kobject_reqs, 2);
+  if (kobject_reqs[0].ret || keys == 0) {
     x8A4_log_error("Failed to read io_aes_accel_special_keys from kobject: 0x%llX!\n", kobject);
     return NULL;
   }
-  x8A4_log_debug("kobject + koffsets_cached->io_aes_accel_special_keys_size: 0x%016llX\n", kobject + koffsets_cached->io_aes_accel_special_keys_size);
-  if (kread(kobject + koffsets_cached->io_aes_accel_special_keys_size,
-            keys_count, 4) ||
-      *keys_count == 0) {
+  if (kobject_reqs[1].ret || *keys_count == 0) {
     x8A4_log_error("Failed to read io_aes_accel_special_keys_size from kobject: 0x%llX!\n", kobject);
     return NULL;
   }
@@ -1236,16 +1531,38 @@ struct x8A4_accel_key *x8A4_get_ioaesaccelkeys(uint32_t *keys_count) {
   gc_cached[gc_count_cached++] = (uint64_t)out_keys;
   x8A4_log_debug_error("gc_cached[gc_count_cached++]: %d val: 0x%016llX\n", __LINE__, out_keys);
   x8A4_log_debug("keys: 0x%016llX keys count: %zu\n", keys, *keys_count);
+  const void *mapped_keys = NULL;
+  if (!kmem_map(keys, *keys_count * struct_size, &mapped_keys)) {
+    memcpy(out_keys, mapped_keys, *keys_count * struct_size);
+    return out_keys;
+  }
+  struct kmem_read_req *reqs = (struct kmem_read_req *)calloc(*keys_count, sizeof(struct kmem_read_req));
+  if (!reqs) {
+    x8A4_log_error("Failed to calloc memory for special key reads!\n", "");
+    return NULL;
+  }
   for (int i = 0; i < *keys_count; i++) {
-    struct x8A4_accel_key *cur_key = (struct x8A4_accel_key *)(out_keys + (struct_size * i));
-    if(kread((keys + (struct_size * i)), cur_key, struct_size)) {
-      x8A4_log_debug_error("Failed to read special key: %d from keys: 0x%016llX!\n", i, (keys + (struct_size * i)));
-      continue;
+    reqs[i] = (struct kmem_read_req){keys + (struct_size * i), &out_keys[i], struct_size, 0};
+  }
+  kmem_read_batch(reqs, *keys_count);
+  for (int i = 0; i < *keys_count; i++) {
+    if (reqs[i].ret) {
+      x8A4_log_debug_error("Failed to read special key: %d from keys: 0x%016llX!\n", i, reqs[i].addr);
     }
   }
+  free(reqs);
   return out_keys;
 }
 
+/**
+ * @brief           Get the per call site kernel memory access counters
+ * @param[out]      count
+ * @return          Pointer to the call site counters(kmem_site_stats array)
+ */
+const struct kmem_site_stats *x8A4_get_kmem_stats(size_t *count) {
+  return kmem_stats_get(count);
+}
+
 /**
  * @brief           x8A4 main library function
  */
@@ -1283,14 +1600,14 @@ void x8A4(void) {
   uint64_t keys = 0;
   x8A4_log_debug("kobject: 0x%016llX\n", kobject);
   x8A4_log_debug("kobject + koffsets_cached->io_aes_accel_special_keys: 0x%016llX\n", kobject + koffsets_cached->io_aes_accel_special_keys);
-  if (kread(kobject + koffsets_cached->io_aes_accel_special_keys, &keys, 8) ||
+  if (kmem_read(kobject + koffsets_cached->io_aes_accel_special_keys, &keys, 8) ||
       keys == 0) {
     x8A4_log_error("Failed to read io_aes_accel_special_keys from kobject: 0x%llX!\n", kobject);
     return;
   }
   size_t keys_count = 0;
   x8A4_log_debug("kobject + koffsets_cached->io_aes_accel_special_keys_size: 0x%016llX\n", kobject + koffsets_cached->io_aes_accel_special_keys_size);
-  if (kread(kobject + koffsets_cached->io_aes_accel_special_keys_size,
+  if (kmem_read(kobject + koffsets_cached->io_aes_accel_special_keys_size,
             &keys_count, 8) ||
       keys_count == 0) {
     x8A4_log_error("Failed to read io_aes_accel_special_keys_size from kobject: 0x%llX!\n", kobject);
@@ -1301,7 +1618,7 @@ void x8A4(void) {
   x8A4_log_debug("keys: 0x%llX keys count: %zu\n", keys, keys_count);
   for (int i = 0; i < keys_count; i++) {
     struct x8A4_accel_key *cur_key = out_keys + (struct_size * i);
-    if (kread(keys + (struct_size * i), cur_key, struct_size)) {
+    if (kmem_read(keys + (struct_size * i), cur_key, struct_size)) {
       x8A4_log_error("Failed to read special key: %d from keys: 0x%llX!\n", i, keys);
     }
     //        if(cur_key->key_id == 0x8A4) {
@@ -1388,6 +1705,91 @@ void x8A4_cli_set_verbose(void) {
   setenv("LIBKRW_LOG", "1", 0);
 }
 
+/**
+ * @brief           CLI disable the kmem read cache
+ */
+void x8A4_cli_disable_kmem_cache(void) {
+  kmem_cache_set_enabled(0);
+}
+
+/**
+ * @brief           CLI enable per call site kernel memory access stats
+ */
+void x8A4_cli_enable_kmem_stats(void) {
+  kmem_stats_set_enabled(1);
+}
+
+/**
+ * @brief           CLI print per call site kernel memory access stats
+ */
+void x8A4_cli_print_kmem_stats(void) {
+  kmem_stats_print();
+  if (kmem_backend_get() == &kmem_phys_backend) {
+    struct kmem_phys_stats stats = {0};
+    kmem_phys_get_stats(&stats);
+    x8A4_log("physread: tlb hits: %llu misses: %llu failed walks: %llu reads: %llu bytes: %llu fallbacks: %llu\n",
+             stats.tlb_hits, stats.tlb_misses, stats.walks_failed, stats.phys_reads, stats.phys_bytes, stats.fallbacks);
+  }
+  struct kmem_static_stats static_stats = {0};
+  kmem_static_get_stats(&static_stats);
+  x8A4_log("kernelcache: reads: %llu bytes: %llu pointers: %llu fallbacks: %llu\n",
+           static_stats.reads, static_stats.bytes, static_stats.pointers, static_stats.fallbacks);
+}
+
+/**
+ * @brief           CLI drive libkrw from worker threads, the krw plugin must be thread safe
+ * @param[in]       threads
+ */
+void x8A4_cli_set_kmem_threads(uint32_t threads) {
+  kmem_async_set_workers(threads, 1);
+}
+
+/**
+ * @brief           CLI serve kernel memory from a sparse memory image
+ * @param[in]       path
+ */
+void x8A4_cli_set_kmem_image(const char *path) {
+  kmem_backend_set_image_path(path);
+}
+
+/**
+ * @brief           CLI record kernel memory traffic to a trace file
+ * @param[in]       path
+ */
+void x8A4_cli_set_kmem_record(const char *path) {
+  kmem_backend_set_record_path(path);
+}
+
+/**
+ * @brief           CLI replay kernel memory traffic from a trace file
+ * @param[in]       path
+ */
+void x8A4_cli_set_kmem_replay(const char *path) {
+  kmem_backend_set_replay_path(path);
+}
+
+/**
+ * @brief           CLI serve bulk kernel reads through physread
+ */
+void x8A4_cli_enable_kmem_physread(void) {
+  kmem_phys_set_enabled(1);
+}
+
+/**
+ * @brief           CLI bind a krw plugin directly instead of going through libkrw
+ * @param[in]       path
+ */
+void x8A4_cli_set_kmem_plugin(const char *path) {
+  kmem_backend_set_plugin_path(path);
+}
+
+/**
+ * @brief           CLI find service kobjects through the kernel IORegistry instead of our ipc space
+ */
+void x8A4_cli_enable_kobject_registry(void) {
+  kregistry_set_preferred(true);
+}
+
 /**
  * @brief           CLI get cryptex seed
  */
@@ -1526,7 +1928,6 @@ void x8A4_cli_clear_apnonce_generator(void) {
 void x8A4_cli_get_accel_keys(uint32_t chosen_key) {
   x8A4_log("Getting IOAESAccelerator keys...\n", "");
   uint32_t keys_count = 0;
-  size_t struct_size = sizeof(struct x8A4_accel_key);
   struct x8A4_accel_key *keys = x8A4_get_ioaesaccelkeys(&keys_count);
   if(!keys) {
     x8A4_log_error("Failed to get IOAESAccelerator Keys!\n", "");
@@ -1534,7 +1935,7 @@ void x8A4_cli_get_accel_keys(uint32_t chosen_key) {
   }
   x8A4_log("Done!\n", "");
   for (int i = 0; i < keys_count; i++) {
-    struct x8A4_accel_key *cur_key = keys + (struct_size * i);
+    struct x8A4_accel_key *cur_key = &keys[i];
     if(chosen_key && cur_key->key_id != chosen_key) {
       continue;
     }
@@ -1620,6 +2021,9 @@ void x8A4_cli_set_cryptex_seed(const char *new_seed) {
   }
   seed[0] = __builtin_bswap64(seed[0]);
   seed[1] = __builtin_bswap64(seed[1]);
+  if (x8A4_require(X8A4_CAP_PATCHFINDER)) {
+    return;
+  }
   int cryptex_boot_index = 0;
   if(strcmp(gXPF.darwinVersion, "23.0.0") >= 0 && nonce_slot_format_cached == 1) {
     cryptex_boot_index = x8A4_get_cryptex_boot_slot_slots_index();
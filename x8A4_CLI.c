@@ -11,6 +11,15 @@
 static struct option x8A4_options[] = {
     {"help", 0, NULL, 'h'},
     {"verbose", 0, NULL, 'v'},
+    {"no-kmem-cache", 0, NULL, 'u'},
+    {"stats", 0, NULL, 'i'},
+    {"kmem-threads", required_argument, NULL, 'j'},
+    {"kmem-image", required_argument, NULL, 'm'},
+    {"kmem-record", required_argument, NULL, 'r'},
+    {"kmem-replay", required_argument, NULL, 'p'},
+    {"kmem-physread", 0, NULL, 'q'},
+    {"kmem-plugin", required_argument, NULL, 'w'},
+    {"kobject-registry", 0, NULL, 'e'},
     {"print-all", 0, NULL, 'a'},
     {"get-cryptex-seed", 0, NULL, 'x'},
     {"get-cryptex-nonce", 0, NULL, 't'},
@@ -39,6 +48,15 @@ void x8A4_help(const char *cmd) {
   x8A4_log("\n%sOptions:\n", "");
   x8A4_log("  %s, %s\t\t\t\t\t\t%s\n", "-h", "--help", "Shows this help message");
   x8A4_log("  %s, %s\t\t\t\t\t\t%s\n", "-v", "--verbose", "Enables this tool's verbose mode");
+  x8A4_log("  %s, %s\t\t\t\t\t%s\n", "-u", "--no-kmem-cache", "Disables the kernel memory read cache");
+  x8A4_log("  %s, %s\t\t\t\t\t\t%s\n", "-i", "--stats", "Prints per function kernel memory access stats on exit");
+  x8A4_log("  %s, %s\t\t\t\t\t%s\n", "-j", "--kmem-threads", "Reads kernel memory with N worker threads (krw plugin must be thread-safe)");
+  x8A4_log("  %s, %s\t\t\t\t\t%s\n", "-m", "--kmem-image", "Serves kernel memory from a sparse memory image instead of libkrw");
+  x8A4_log("  %s, %s\t\t\t\t\t%s\n", "-r", "--kmem-record", "Records kernel memory traffic to a compressed trace file");
+  x8A4_log("  %s, %s\t\t\t\t\t%s\n", "-p", "--kmem-replay", "Replays kernel memory traffic from a trace file instead of libkrw");
+  x8A4_log("  %s, %s\t\t\t\t\t%s\n", "-q", "--kmem-physread", "Serves bulk kernel reads through physread (krw plugin must implement physread)");
+  x8A4_log("  %s, %s\t\t\t\t\t%s\n", "-w", "--kmem-plugin", "Binds a krw plugin (file, directory or auto) directly instead of going through libkrw");
+  x8A4_log("  %s, %s\t\t\t\t\t%s\n", "-e", "--kobject-registry", "Finds service kobjects through the kernel IORegistry instead of our ipc space");
   x8A4_log("  %s, %s\t\t\t\t\t%s\n", "-a", "--print-all", "Dumps and prints everything :)");
   x8A4_log("\n%sOptions:\n", "Cryptex ");
   x8A4_log("  %s, %s\t\t\t\t%s\n", "-x", "--get-cryptex-seed", "Gets the current Cryptex1 boot seed from nvram");
@@ -64,13 +82,73 @@ void set_verbose() {
   x8A4_cli_set_verbose();
 }
 
+/**
+ * @brief           CLI disable kernel memory read cache
+ */
+void disable_kmem_cache() {
+  x8A4_cli_disable_kmem_cache();
+}
+
+/**
+ * @brief           CLI enable per function kernel memory access stats
+ */
+void enable_kmem_stats() {
+  x8A4_cli_enable_kmem_stats();
+}
+
+/**
+ * @brief           CLI read kernel memory with worker threads
+ */
+void set_kmem_threads(uint32_t threads) {
+  x8A4_cli_set_kmem_threads(threads);
+}
+
+/**
+ * @brief           CLI serve kernel memory from a sparse memory image
+ */
+void set_kmem_image(const char *path) {
+  x8A4_cli_set_kmem_image(path);
+}
+
+/**
+ * @brief           CLI record kernel memory traffic to a trace file
+ */
+void set_kmem_record(const char *path) {
+  x8A4_cli_set_kmem_record(path);
+}
+
+/**
+ * @brief           CLI replay kernel memory traffic from a trace file
+ */
+void set_kmem_replay(const char *path) {
+  x8A4_cli_set_kmem_replay(path);
+}
+
+/**
+ * @brief           CLI serve bulk kernel reads through physread
+ */
+void enable_kmem_physread() {
+  x8A4_cli_enable_kmem_physread();
+}
+
+/**
+ * @brief           CLI bind a krw plugin directly
+ */
+void set_kmem_plugin(const char *path) {
+  x8A4_cli_set_kmem_plugin(path);
+}
+
+/**
+ * @brief           CLI find service kobjects through the kernel IORegistry
+ */
+void enable_kobject_registry() {
+  x8A4_cli_enable_kobject_registry();
+}
+
 /**
  * @brief           CLI call all program getters
  */
 void print_all() {
-  if(x8A4_init()) {
-    return;
-  }
   x8A4_cli_get_cryptex_seed();
   x8A4_cli_get_cryptex_nonce();
   x8A4_cli_get_apnonce_generator();
@@ -83,9 +161,6 @@ void print_all() {
  * @brief           CLI get cryptex seed
  */
 void get_cryptex_seed(void) {
-  if(x8A4_init()) {
-    return;
-  }
   x8A4_cli_get_cryptex_seed();
 }
 
@@ -93,9 +168,6 @@ void get_cryptex_seed(void) {
  * @brief           CLI get cryptex nonce
  */
 void get_cryptex_nonce(void) {
-  if(x8A4_init()) {
-    return;
-  }
   x8A4_cli_get_cryptex_nonce();
 }
 
@@ -103,9 +175,6 @@ void get_cryptex_nonce(void) {
  * @brief           CLI get apnonce generator
  */
 void get_apnonce_generator(void) {
-  if(x8A4_init()) {
-    return;
-  }
   x8A4_cli_get_apnonce_generator();
 }
 
@@ -113,9 +182,6 @@ void get_apnonce_generator(void) {
  * @brief           CLI get apnonce
  */
 void get_apnonce(void) {
-  if(x8A4_init()) {
-    return;
-  }
   x8A4_cli_get_apnonce();
 }
 
@@ -124,9 +190,6 @@ void get_apnonce(void) {
  * @param[in]       new_generator
  */
 void set_apnonce_generator(const char *new_generator) {
-  if(x8A4_init()) {
-    return;
-  }
   x8A4_cli_set_apnonce_generator(new_generator);
 }
 
@@ -134,9 +197,6 @@ void set_apnonce_generator(const char *new_generator) {
  * @brief           CLI clear apnonce generator
  */
 void clear_apnonce_generator() {
-  if(x8A4_init()) {
-    return;
-  }
   x8A4_cli_clear_apnonce_generator();
 }
 
@@ -145,16 +205,10 @@ void clear_apnonce_generator() {
  * @param[in]       chosen_key
  */
 void get_accel_keys(uint32_t chosen_key) {
-  if(x8A4_init()) {
-    return;
-  }
   x8A4_cli_get_accel_keys(chosen_key);
 }
 
 void get_nonce_seeds(void) {
-  if(x8A4_init()) {
-    return;
-  }
   x8A4_cli_get_nonce_seeds();
 }
 
@@ -163,9 +217,6 @@ void get_nonce_seeds(void) {
  * @param[in]       new_seed
  */
 void set_cryptex_seed(const char *new_seed) {
-  if(x8A4_init()) {
-    return;
-  }
   x8A4_cli_set_cryptex_seed(new_seed);
 }
 
@@ -177,7 +228,8 @@ void set_cryptex_seed(const char *new_seed) {
 int main(int argc, char **argv) {
   int x8A4_opt = 0;
   int x8A4_opt_index = 0;
-  while((x8A4_opt = getopt_long(argc, (char* const *)argv, "hvaxtgns:ck:ldz:", x8A4_options, &x8A4_opt_index)) > 0) {
+  int stats = 0;
+  while((x8A4_opt = getopt_long(argc, (char* const *)argv, "hvuij:m:r:p:qw:eaxtgns:ck:ldz:", x8A4_options, &x8A4_opt_index)) > 0) {
     switch(x8A4_opt) {
       case 'h':
         x8A4_help(argv[0]);
@@ -185,6 +237,44 @@ int main(int argc, char **argv) {
       case 'v':
         set_verbose();
         break;
+      case 'u':
+        disable_kmem_cache();
+        break;
+      case 'i':
+        enable_kmem_stats();
+        stats = 1;
+        break;
+      case 'j':
+        if(optarg) {
+          set_kmem_threads(strtoul(optarg, NULL, 0));
+        }
+        break;
+      case 'm':
+        if(optarg) {
+          set_kmem_image(optarg);
+        }
+        break;
+      case 'r':
+        if(optarg) {
+          set_kmem_record(optarg);
+        }
+        break;
+      case 'p':
+        if(optarg) {
+          set_kmem_replay(optarg);
+        }
+        break;
+      case 'q':
+        enable_kmem_physread();
+        break;
+      case 'w':
+        if(optarg) {
+          set_kmem_plugin(optarg);
+        }
+        break;
+      case 'e':
+        enable_kobject_registry();
+        break;
       case 'a':
         print_all();
         break;
@@ -232,5 +322,8 @@ int main(int argc, char **argv) {
   if(argc == 1) {
     x8A4_help(argv[0]);
   }
+  if(stats) {
+    x8A4_cli_print_kmem_stats();
+  }
   return 0;
 }